@@ -211,6 +211,7 @@ LOCAL_SRC_FILES += \
 	soundlib/plugins/dmo/ParamEq.cpp \
 	soundlib/plugins/dmo/WavesReverb.cpp \
 	soundlib/plugins/LFOPlugin.cpp \
+	soundlib/plugins/PluginGraph.cpp \
 	soundlib/plugins/PluginManager.cpp \
 	soundlib/plugins/PlugInterface.cpp \
 	sounddsp/AGC.cpp \
@@ -218,6 +219,7 @@ LOCAL_SRC_FILES += \
 	sounddsp/EQ.cpp \
 	sounddsp/Reverb.cpp \
 	test/TestToolsLib.cpp \
+	test/benchmark.cpp \
 	test/test.cpp
 
 include $(BUILD_SHARED_LIBRARY)
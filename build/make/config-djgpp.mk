@@ -45,6 +45,9 @@ MPT_COMPILER_NOVISIBILITY=1
 # causes crashes on process shutdown
 MPT_COMPILER_NOGCSECTIONS=1
 
+# no thread support
+MPT_COMPILER_NOPTHREAD=1
+
 NO_ZLIB=1
 NO_LTDL=1
 NO_DL=1
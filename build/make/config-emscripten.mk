@@ -111,6 +111,9 @@ OPTIMIZE_SIZE=0
 
 IS_CROSS=1
 
+# threads would require SharedArrayBuffer support
+MPT_COMPILER_NOPTHREAD=1
+
 NO_ZLIB=1
 NO_LTDL=1
 NO_DL=1
@@ -29,6 +29,9 @@ SHARED_SONAME=0
 
 IS_CROSS=1
 
+# threads are provided by the Windows API, not by pthreads
+MPT_COMPILER_NOPTHREAD=1
+
 NO_ZLIB=1
 NO_LTDL=1
 NO_DL=1
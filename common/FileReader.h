@@ -801,7 +801,8 @@ public:
 			streamPos = position;
 			return true;
 		}
-		if(position <= DataContainer().GetLength())
+		// CanRead() instead of GetLength() avoids caching all of an unseekable stream
+		if(DataContainer().CanRead(0, position))
 		{
 			streamPos = position;
 			return true;
@@ -906,7 +907,7 @@ protected:
 		{
 			return FileReader();
 		}
-		return FileReader(CreateChunkImpl(SharedDataContainer(), position, std::min(length, DataContainer().GetLength() - position)));
+		return FileReader(CreateChunkImpl(SharedDataContainer(), position, readableLength));
 	}
 
 public:
@@ -1342,6 +1343,7 @@ public:
 
 using FileReader = detail::FileReader<FileReaderTraitsDefault>;
 
+// Reads from memory without going through IFileDataContainer. Loaders use it for data that is parsed byte by byte, such as pattern data.
 using MemoryFileReader = detail::FileReader<FileReaderTraitsMemory>;
 
 
@@ -430,7 +430,9 @@ bool FileDataContainerUnseekable::HasFastGetLength() const
 
 bool FileDataContainerUnseekable::HasPinnedView() const
 {
-	return true; // we have the cache which is required for seeking anyway
+	// The cache is only stable once the whole stream has been read.
+	// Before that, pinning a view would require reading the whole stream, which we want to avoid for progressive loading.
+	return streamFullyCached;
 }
 
 const mpt::byte *FileDataContainerUnseekable::GetRawData() const
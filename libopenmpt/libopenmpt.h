@@ -654,6 +654,30 @@ LIBOPENMPT_API int openmpt_probe_file_header_without_filesize( uint64_t flags, c
  */
 LIBOPENMPT_API int openmpt_probe_file_header_from_stream( uint64_t flags, openmpt_stream_callbacks stream_callbacks, void * stream, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message );
 
+/*! \brief Probe the provided bytes from the beginning of many files for supported file format headers at once
+ *
+ * \param flags Ored mask of OPENMPT_PROBE_FILE_HEADER_FLAGS_MODULES and OPENMPT_PROBE_FILE_HEADER_FLAGS_CONTAINERS, or OPENMPT_PROBE_FILE_HEADER_FLAGS_DEFAULT.
+ * \param count Number of files to probe.
+ * \param data Array of count pointers to the beginning of each file's data.
+ * \param sizes Array of count sizes of the beginning of each file's data.
+ * \param filesizes Array of count full sizes of each file's data on disk. May be NULL if the file sizes are unknown.
+ * \param results Array of count integers where the probing result for each file is stored, see openmpt_probe_file_header() for possible values.
+ * \param logfunc Logging function where warning and errors are written. May be NULL.
+ * \param loguser Logging function user context. Used to pass any user-defined data associated with this module to the logging function.
+ * \param errfunc Error function to define error behaviour. May be NULL.
+ * \param erruser Error function user context. Used to pass any user-defined data associated with this module to the logging function.
+ * \param error Pointer to an integer where an error may get stored. May be NULL.
+ * \param error_message Pointer to a string pointer where an error message may get stored. May be NULL.
+ * \return 1 on success, 0 on failure. On failure, the contents of results are unspecified.
+ * \remarks The result for each file is identical to calling openmpt_probe_file_header() (or openmpt_probe_file_header_without_filesize() if filesizes is NULL) on it, but avoids the per-call overhead when probing a large number of files.
+ * \remarks It is recommended to provide openmpt_probe_file_header_get_recommended_size() bytes of data for each file. This allows libopenmpt to rule out most formats by their magic bytes alone without invoking the format-specific probing code.
+ * \sa openmpt_probe_file_header_get_recommended_size()
+ * \sa openmpt_probe_file_header()
+ * \sa openmpt_probe_file_header_without_filesize()
+ * \since 0.5.0
+ */
+LIBOPENMPT_API int openmpt_probe_file_headers_batch( uint64_t flags, size_t count, const void * const * data, const size_t * sizes, const uint64_t * filesizes, int * results, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message );
+
 
 /*! \brief Opaque type representing a libopenmpt module
  */
@@ -1108,6 +1132,54 @@ LIBOPENMPT_API size_t openmpt_module_read_interleaved_float_stereo( openmpt_modu
  * \sa \ref libopenmpt_c_outputformat
 */
 LIBOPENMPT_API size_t openmpt_module_read_interleaved_float_quad(   openmpt_module * mod, int32_t samplerate, size_t count, float * interleaved_quad   );
+/*! \brief Render audio data and add it to a buffer
+ *
+ * \param mod The module handle to work on.
+ * \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+ * \param count Number of audio frames to render per channel.
+ * \param interleaved_stereo Pointer to a buffer of at least count*2 elements. The interleaved stereo output in the order (L,R) is added to the existing contents of the buffer.
+ * \param gain Linear factor that is applied to the rendered audio before it is added, in addition to the render.mastergain setting.
+ * \return The number of frames actually rendered.
+ * \retval 0 The end of song has been reached.
+ * \remarks The output buffers are only modified up to the returned number of elements.
+ * \remarks This is intended for mixing multiple modules (or other sources) into a single buffer. Compared to rendering into a temporary buffer with openmpt_module_read_interleaved_float_stereo() and summing afterwards, it avoids the temporary buffer and the additional pass over the audio data.
+ * \remarks Floating point samples are in the [-1.0..1.0] nominal range. Neither the rendered audio nor the sum are clipped to that range.
+ * \sa openmpt_module_read_interleaved_float_stereo()
+ * \since 0.5.0
+ */
+LIBOPENMPT_API size_t openmpt_module_read_interleaved_float_stereo_add( openmpt_module * mod, int32_t samplerate, size_t count, float * interleaved_stereo, float gain );
+/*! \brief Render audio data and add it to a buffer
+ *
+ * \param mod The module handle to work on.
+ * \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+ * \param count Number of audio frames to render per channel.
+ * \param interleaved_quad Pointer to a buffer of at least count*4 elements. The interleaved quad surround output in the order (L,R,RL,RR) is added to the existing contents of the buffer.
+ * \param gain Linear factor that is applied to the rendered audio before it is added, in addition to the render.mastergain setting.
+ * \return The number of frames actually rendered.
+ * \retval 0 The end of song has been reached.
+ * \remarks The output buffers are only modified up to the returned number of elements.
+ * \remarks This is intended for mixing multiple modules (or other sources) into a single buffer. Compared to rendering into a temporary buffer with openmpt_module_read_interleaved_float_quad() and summing afterwards, it avoids the temporary buffer and the additional pass over the audio data.
+ * \remarks Floating point samples are in the [-1.0..1.0] nominal range. Neither the rendered audio nor the sum are clipped to that range.
+ * \sa openmpt_module_read_interleaved_float_quad()
+ * \since 0.5.0
+ */
+LIBOPENMPT_API size_t openmpt_module_read_interleaved_float_quad_add( openmpt_module * mod, int32_t samplerate, size_t count, float * interleaved_quad, float gain );
+/*! \brief Render each pattern channel into a separate buffer
+ *
+ * \param mod The module handle to work on.
+ * \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+ * \param count Number of audio frames to render per channel.
+ * \param interleaved_stereo_stems Pointer to an array of openmpt_module_get_num_channels() pointers, one for each pattern channel. Each non-null pointer points to a buffer of at least count*2 elements that receives the interleaved stereo output of that channel in the order (L,R). Channels with a null pointer are skipped.
+ * \return The number of frames actually rendered.
+ * \retval 0 The end of song has been reached.
+ * \remarks The output buffers are only written to up to the returned number of elements.
+ * \remarks Each stem contains all voices that were triggered on its pattern channel, including voices continuing in the background due to New Note Actions. All channels are rendered in a single playback pass.
+ * \remarks Global volume, stereo separation and render.mastergain are applied to each stem. Reverb, surround, plugins, OPL instruments and other master DSP effects are not: Voices that would be sent to the reverb or to a plugin are mixed dry into the stem of their channel. The output of plugins and OPL instruments, the reverb tail and voices that are not associated with any pattern channel only go to the master mix, which is discarded. Thus, the sum of all stems only equals the regular output for modules that use none of these features.
+ * \remarks Floating point samples are in the [-1.0..1.0] nominal range. They are not clipped to that range though and thus might overshoot.
+ * \sa openmpt_module_read_interleaved_float_stereo()
+ * \since 0.5.0
+ */
+LIBOPENMPT_API size_t openmpt_module_read_stems_interleaved_float_stereo( openmpt_module * mod, int32_t samplerate, size_t count, float * const * interleaved_stereo_stems );
 /*@}*/
 
 /*! \brief Get the list of supported metadata item keys
@@ -1331,6 +1403,19 @@ LIBOPENMPT_API int32_t openmpt_module_get_pattern_num_rows( openmpt_module * mod
  * \return The internal, raw pattern data at the given pattern position.
  */
 LIBOPENMPT_API uint8_t openmpt_module_get_pattern_row_channel_command( openmpt_module * mod, int32_t pattern, int32_t row, int32_t channel, int command );
+/*! \brief Get raw pattern content of a whole pattern
+ *
+ * \param mod The module handle to work on.
+ * \param pattern The pattern whose data should be retrieved.
+ * \param data Pointer to a buffer that receives the raw pattern data. Each cell occupies 6 bytes, stored in \ref openmpt_module_command_index order. Cells are stored row by row, so the value for a given row, channel and command is found at data[ ( row * openmpt_module_get_num_channels() + channel ) * 6 + command ].
+ * \param size Size of the buffer in bytes. Only complete rows are written.
+ * \return The number of rows actually written. If the pattern does not exist, 0 is returned.
+ * \remarks The values are identical to the ones returned by openmpt_module_get_pattern_row_channel_command(). A buffer of openmpt_module_get_pattern_num_rows() * openmpt_module_get_num_channels() * 6 bytes receives the complete pattern.
+ * \remarks This is considerably faster than retrieving each value with openmpt_module_get_pattern_row_channel_command() when scanning large amounts of pattern data.
+ * \sa openmpt_module_get_pattern_row_channel_command
+ * \since 0.5.0
+ */
+LIBOPENMPT_API int32_t openmpt_module_get_pattern_data( openmpt_module * mod, int32_t pattern, uint8_t * data, size_t size );
 
 /*! \brief Get formatted (human-readable) pattern content
  *
@@ -1390,6 +1475,25 @@ LIBOPENMPT_API const char * openmpt_module_format_pattern_row_channel( openmpt_m
  * \sa openmpt_module_format_pattern_row_channel
  */
 LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmpt_module * mod, int32_t pattern, int32_t row, int32_t channel, size_t width, int pad );
+/*! \brief Get formatted (human-readable) pattern content and highlighting information for a rectangular range of cells
+ *
+ * \param mod The module handle to work on.
+ * \param pattern The pattern whose data should be retrieved.
+ * \param first_row The first row of the range.
+ * \param rows The number of rows in the range.
+ * \param first_channel The first channel of the range.
+ * \param channels The number of channels in the range.
+ * \param width The number of characters per cell. 0 means the full width of 13 characters.
+ * \param text Pointer to a buffer of at least rows*channels*width characters that receives the formatted pattern data. Cells are stored row by row, each cell padded to exactly width characters, without separators or null termination.
+ * \param highlight Pointer to a buffer with the same layout as text that receives the highlighting information, or NULL if it is not needed.
+ * \return 1 on success, 0 on failure.
+ * \remarks Each cell is identical to the result of openmpt_module_format_pattern_row_channel and openmpt_module_highlight_pattern_row_channel with the given width and pad = 1. Cells outside of the pattern are filled with spaces.
+ * \remarks This function does not allocate memory in the common case and is intended for pattern visualizers that redraw many cells per frame. Unlike openmpt_module_format_pattern_row_channel, the buffers are owned by the caller.
+ * \sa openmpt_module_format_pattern_row_channel
+ * \sa openmpt_module_highlight_pattern_row_channel
+ * \since 0.5.0
+ */
+LIBOPENMPT_API int openmpt_module_format_pattern_window( openmpt_module * mod, int32_t pattern, int32_t first_row, int32_t rows, int32_t first_channel, int32_t channels, size_t width, char * text, char * highlight );
 
 /*! \brief Retrieve supported ctl keys
  *
@@ -1400,6 +1504,8 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *          - load.skip_patterns: Set to "1" to avoid loading patterns into memory
  *          - load.skip_plugins: Set to "1" to avoid loading plugins
  *          - load.skip_subsongs_init: Set to "1" to avoid pre-initializing sub-songs. Skipping results in faster module loading but slower seeking.
+ *          - load.progressive: Set to "1" to start playback of a module loaded from an unseekable stream before its sample data has arrived. Supported for MOD and S3M files. Sample data is read in the following render calls and voices using samples that have not been read yet stay silent. The stream must stay valid until all sample data has been read.
+ *          - load.metadata_only: Set to "1" to only load what is needed to query metadata, sample and instrument names and the order list. Sample data and plugins are not loaded, pattern contents are not decoded for IT, MPTM, XM, S3M and MOD files and sub-songs are not pre-initialized, which makes loading a lot faster. The number of patterns, their row counts and the number of channels are available, but the patterns appear empty and the module renders silence. Durations, sub-songs and seeking by time are not available: openmpt_module_get_duration_seconds, openmpt_module_get_num_subsongs, openmpt_module_get_subsong_name, openmpt_module_select_subsong and openmpt_module_set_position_seconds fail.
  *          - seek.sync_samples: Set to "1" to sync sample playback when using openmpt_module_set_position_seconds or openmpt_module_set_position_order_row.
  *          - subsong: The current subsong. Setting it has identical semantics as openmpt_module_select_subsong(), getting it returns the currently selected subsong.
  *          - play.at_end: Chooses the behaviour when the end of song is reached:
@@ -1409,7 +1515,15 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
  *          - play.tempo_factor: Set a floating point tempo factor. "1.0" is the default tempo.
  *          - play.pitch_factor: Set a floating point pitch factor. "1.0" is the default pitch.
  *          - render.resampler.emulate_amiga: Set to "1" to enable the Amiga resampler for Amiga modules. This emulates the sound characteristics of the Paula chip and overrides the selected interpolation filter. Non-Amiga module formats are not affected by this setting.
+ *          - render.resampler.sample_pyramids: Set to "1" to render voices that are played back at more than twice the sample's native rate from band-limited, decimated copies of the sample data, which reduces aliasing of high-pitched notes with the 8-tap interpolation filters. The copies are computed when this is enabled and need about as much memory as the sample data itself. Default "0".
  *          - render.opl.volume_factor: Set volume factor applied to synthesized OPL sounds, relative to the default OPL volume.
+ *          - render.reverb.half_rate: Set to "1" to process the reflections and late reverb of the built-in reverb at half the mixing rate. This is cheaper at high sample rates. Default "0".
+ *          - render.reverb.float: Set to "1" to process the reflections and late reverb of the built-in reverb in floating point (using SSE where available) instead of saturating 16-bit fixed point. Default "0".
+ *          - render.mix_samplerate: Set the internal sample rate in Hz at which the module is mixed. The mix is converted to the sample rate passed to the openmpt_module_read functions with a high quality polyphase resampler after all other processing. Mixing at a lower rate than the output rate is faster; setting it to "0" (the default) mixes at the output sample rate directly. Valid rates are 8000 to 192000 Hz, other values are rejected. Not applied to stems rendering.
+ *          - render.plugin_threads: Set the number of worker threads (0 to 16) that process independent chains of the built-in DMO and DigiBooster effect plugins concurrently. Plugins that feed into each other, master effects and other plugins are always processed on the rendering thread. The output does not depend on this setting. Default "0" processes all plugins on the rendering thread.
+ *          - render.statistics.ramp_frames: Number of voice frames that were rendered with volume ramping since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
+ *          - render.statistics.noramp_frames: Number of voice frames that were rendered one voice at a time without volume ramping since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
+ *          - render.statistics.multivoice_frames: Number of voice frames that were rendered together with other voices using the same mix function since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
  *          - dither: Set the dither algorithm that is used for the 16 bit versions of openmpt_module_read. Supported values are:
  *                    - 0: No dithering.
  *                    - 1: Default mode. Chosen by OpenMPT code, might change.
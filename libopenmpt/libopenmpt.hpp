@@ -330,6 +330,23 @@ LIBOPENMPT_CXX_API int probe_file_header( std::uint64_t flags, const std::uint8_
 */
 LIBOPENMPT_CXX_API int probe_file_header( std::uint64_t flags, std::istream & stream );
 
+//! Probe the provided bytes from the beginning of many files for supported file format headers at once
+/*!
+  \param flags Ored mask of openmpt::probe_file_header_flags_modules and openmpt::probe_file_header_flags_containers, or openmpt::probe_file_header_flags_default.
+  \param count Number of files to probe.
+  \param data Array of count pointers to the beginning of each file's data.
+  \param sizes Array of count sizes of the beginning of each file's data.
+  \param filesizes Array of count full sizes of each file's data on disk. May be nullptr if the file sizes are unknown.
+  \param results Array of count integers where the probing result for each file is stored, see openmpt::probe_file_header() for possible values.
+  \remarks The result for each file is identical to calling openmpt::probe_file_header() on it, but avoids the per-call overhead when probing a large number of files.
+  \remarks It is recommended to provide openmpt::probe_file_header_get_recommended_size() bytes of data for each file. This allows libopenmpt to rule out most formats by their magic bytes alone without invoking the format-specific probing code.
+  \throws openmpt::exception Throws an exception derived from openmpt::exception in case the provided arguments are invalid.
+  \sa openmpt::probe_file_header_get_recommended_size()
+  \sa openmpt::probe_file_header()
+  \since 0.5.0
+*/
+LIBOPENMPT_CXX_API void probe_file_headers_batch( std::uint64_t flags, std::size_t count, const std::uint8_t * const * data, const std::size_t * sizes, const std::uint64_t * filesizes, int * results );
+
 class module_impl;
 
 class module_ext;
@@ -711,6 +728,51 @@ public:
 	  \sa \ref libopenmpt_cpp_outputformat
 	*/
 	std::size_t read_interleaved_quad( std::int32_t samplerate, std::size_t count, float * interleaved_quad );
+	//! Render audio data and add it to a buffer
+	/*!
+	  \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+	  \param count Number of audio frames to render per channel.
+	  \param interleaved_stereo Pointer to a buffer of at least count*2 elements. The interleaved stereo output in the order (L,R) is added to the existing contents of the buffer.
+	  \param gain Linear factor that is applied to the rendered audio before it is added, in addition to the render.mastergain setting.
+	  \return The number of frames actually rendered.
+	  \retval 0 The end of song has been reached.
+	  \remarks The output buffers are only modified up to the returned number of elements.
+	  \remarks This is intended for mixing multiple modules (or other sources) into a single buffer. Compared to rendering into a temporary buffer with openmpt::module::read_interleaved_stereo() and summing afterwards, it avoids the temporary buffer and the additional pass over the audio data.
+	  \remarks Floating point samples are in the [-1.0..1.0] nominal range. Neither the rendered audio nor the sum are clipped to that range.
+	  \sa openmpt::module::read_interleaved_stereo()
+	  \since 0.5.0
+	*/
+	std::size_t read_interleaved_stereo_add( std::int32_t samplerate, std::size_t count, float * interleaved_stereo, float gain );
+	//! Render audio data and add it to a buffer
+	/*!
+	  \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+	  \param count Number of audio frames to render per channel.
+	  \param interleaved_quad Pointer to a buffer of at least count*4 elements. The interleaved quad surround output in the order (L,R,RL,RR) is added to the existing contents of the buffer.
+	  \param gain Linear factor that is applied to the rendered audio before it is added, in addition to the render.mastergain setting.
+	  \return The number of frames actually rendered.
+	  \retval 0 The end of song has been reached.
+	  \remarks The output buffers are only modified up to the returned number of elements.
+	  \remarks This is intended for mixing multiple modules (or other sources) into a single buffer. Compared to rendering into a temporary buffer with openmpt::module::read_interleaved_quad() and summing afterwards, it avoids the temporary buffer and the additional pass over the audio data.
+	  \remarks Floating point samples are in the [-1.0..1.0] nominal range. Neither the rendered audio nor the sum are clipped to that range.
+	  \sa openmpt::module::read_interleaved_quad()
+	  \since 0.5.0
+	*/
+	std::size_t read_interleaved_quad_add( std::int32_t samplerate, std::size_t count, float * interleaved_quad, float gain );
+	//! Render each pattern channel into a separate buffer
+	/*!
+	  \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+	  \param count Number of audio frames to render per channel.
+	  \param interleaved_stereo_stems Pointer to an array of openmpt::module::get_num_channels() pointers, one for each pattern channel. Each non-null pointer points to a buffer of at least count*2 elements that receives the interleaved stereo output of that channel in the order (L,R). Channels with a null pointer are skipped.
+	  \return The number of frames actually rendered.
+	  \retval 0 The end of song has been reached.
+	  \remarks The output buffers are only written to up to the returned number of elements.
+	  \remarks Each stem contains all voices that were triggered on its pattern channel, including voices continuing in the background due to New Note Actions. All channels are rendered in a single playback pass.
+	  \remarks Global volume, stereo separation and render.mastergain are applied to each stem. Reverb, surround, plugins, OPL instruments and other master DSP effects are not: Voices that would be sent to the reverb or to a plugin are mixed dry into the stem of their channel. The output of plugins and OPL instruments, the reverb tail and voices that are not associated with any pattern channel only go to the master mix, which is discarded. Thus, the sum of all stems only equals the regular output for modules that use none of these features.
+	  \remarks Floating point samples are in the [-1.0..1.0] nominal range. They are not clipped to that range though and thus might overshoot.
+	  \sa openmpt::module::read_interleaved_stereo()
+	  \since 0.5.0
+	*/
+	std::size_t read_stems_interleaved_stereo( std::int32_t samplerate, std::size_t count, float * const * interleaved_stereo_stems );
 	/*@}*/
 
 	//! Get the list of supported metadata item keys
@@ -901,6 +963,19 @@ public:
 	  \return The internal, raw pattern data at the given pattern position.
 	*/
 	std::uint8_t get_pattern_row_channel_command( std::int32_t pattern, std::int32_t row, std::int32_t channel, int command ) const;
+	//! Get raw pattern content of a whole pattern
+	/*!
+	  \param pattern The pattern whose data should be retrieved.
+	  \param data Pointer to a buffer that receives the raw pattern data. Each cell occupies 6 bytes, stored in openmpt::module::command_index order. Cells are stored row by row, so the value for a given row, channel and command is found at data[ ( row * openmpt::module::get_num_channels() + channel ) * 6 + command ].
+	  \param size Size of the buffer in bytes. Only complete rows are written.
+	  \return The number of rows actually written. If the pattern does not exist, 0 is returned.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if data is nullptr.
+	  \remarks The values are identical to the ones returned by openmpt::module::get_pattern_row_channel_command. A buffer of openmpt::module::get_pattern_num_rows() * openmpt::module::get_num_channels() * 6 bytes receives the complete pattern.
+	  \remarks This is considerably faster than retrieving each value with openmpt::module::get_pattern_row_channel_command when scanning large amounts of pattern data.
+	  \sa openmpt::module::get_pattern_row_channel_command
+	  \since 0.5.0
+	*/
+	std::int32_t get_pattern_data( std::int32_t pattern, std::uint8_t * data, std::size_t size ) const;
 
 	//! Get formatted (human-readable) pattern content
 	/*!
@@ -957,6 +1032,24 @@ public:
 	  \sa openmpt::module::format_pattern_row_channel
 	*/
 	std::string highlight_pattern_row_channel( std::int32_t pattern, std::int32_t row, std::int32_t channel, std::size_t width = 0, bool pad = true ) const;
+	//! Get formatted (human-readable) pattern content and highlighting information for a rectangular range of cells
+	/*!
+	  \param pattern The pattern whose data should be retrieved.
+	  \param first_row The first row of the range.
+	  \param rows The number of rows in the range.
+	  \param first_channel The first channel of the range.
+	  \param channels The number of channels in the range.
+	  \param width The number of characters per cell. 0 means the full width of 13 characters.
+	  \param text Pointer to a buffer of at least rows*channels*width characters that receives the formatted pattern data. Cells are stored row by row, each cell padded to exactly width characters, without separators or null termination.
+	  \param highlight Pointer to a buffer with the same layout as text that receives the highlighting information, or nullptr if it is not needed.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if text is nullptr or rows or channels is negative.
+	  \remarks Each cell is identical to the result of openmpt::module::format_pattern_row_channel and openmpt::module::highlight_pattern_row_channel with the given width and pad = true. Cells outside of the pattern are filled with spaces.
+	  \remarks This function does not allocate memory in the common case and is intended for pattern visualizers that redraw many cells per frame.
+	  \sa openmpt::module::format_pattern_row_channel
+	  \sa openmpt::module::highlight_pattern_row_channel
+	  \since 0.5.0
+	*/
+	void format_pattern_window( std::int32_t pattern, std::int32_t first_row, std::int32_t rows, std::int32_t first_channel, std::int32_t channels, std::size_t width, char * text, char * highlight ) const;
 
 	//! Retrieve supported ctl keys
 	/*!
@@ -966,6 +1059,8 @@ public:
 	           - load.skip_patterns: Set to "1" to avoid loading patterns into memory
 	           - load.skip_plugins: Set to "1" to avoid loading plugins
 	           - load.skip_subsongs_init: Set to "1" to avoid pre-initializing sub-songs. Skipping results in faster module loading but slower seeking.
+	           - load.progressive: Set to "1" to start playback of a module loaded from an unseekable stream before its sample data has arrived. Supported for MOD and S3M files. Sample data is read in the following render calls and voices using samples that have not been read yet stay silent. The stream must stay valid until all sample data has been read.
+	           - load.metadata_only: Set to "1" to only load what is needed to query metadata, sample and instrument names and the order list. Sample data and plugins are not loaded, pattern contents are not decoded for IT, MPTM, XM, S3M and MOD files and sub-songs are not pre-initialized, which makes loading a lot faster. The number of patterns, their row counts and the number of channels are available, but the patterns appear empty and the module renders silence. Durations, sub-songs and seeking by time are not available: openmpt::module::get_duration_seconds, openmpt::module::get_num_subsongs, openmpt::module::get_subsong_names, openmpt::module::select_subsong and openmpt::module::set_position_seconds throw openmpt::exception.
 	           - seek.sync_samples: Set to "1" to sync sample playback when using openmpt::module::set_position_seconds or openmpt::module::set_position_order_row.
 	           - subsong: The current subsong. Setting it has identical semantics as openmpt::module::select_subsong(), getting it returns the currently selected subsong.
 	           - play.at_end: Chooses the behaviour when the end of song is reached:
@@ -975,7 +1070,15 @@ public:
 	           - play.tempo_factor: Set a floating point tempo factor. "1.0" is the default tempo.
 	           - play.pitch_factor: Set a floating point pitch factor. "1.0" is the default pitch.
 	           - render.resampler.emulate_amiga: Set to "1" to enable the Amiga resampler for Amiga modules. This emulates the sound characteristics of the Paula chip and overrides the selected interpolation filter. Non-Amiga module formats are not affected by this setting. 
+	           - render.resampler.sample_pyramids: Set to "1" to render voices that are played back at more than twice the sample's native rate from band-limited, decimated copies of the sample data, which reduces aliasing of high-pitched notes with the 8-tap interpolation filters. The copies are computed when this is enabled and need about as much memory as the sample data itself. Default "0".
 	           - render.opl.volume_factor: Set volume factor applied to synthesized OPL sounds, relative to the default OPL volume.
+	           - render.reverb.half_rate: Set to "1" to process the reflections and late reverb of the built-in reverb at half the mixing rate. This is cheaper at high sample rates. Default "0".
+	           - render.reverb.float: Set to "1" to process the reflections and late reverb of the built-in reverb in floating point (using SSE where available) instead of saturating 16-bit fixed point. Default "0".
+	           - render.mix_samplerate: Set the internal sample rate in Hz at which the module is mixed. The mix is converted to the sample rate passed to openmpt::module::read with a high quality polyphase resampler after all other processing. Mixing at a lower rate than the output rate is faster; setting it to "0" (the default) mixes at the output sample rate directly. Valid rates are 8000 to 192000 Hz, other values are rejected. Not applied to stems rendering.
+	           - render.plugin_threads: Set the number of worker threads (0 to 16) that process independent chains of the built-in DMO and DigiBooster effect plugins concurrently. Plugins that feed into each other, master effects and other plugins are always processed on the rendering thread. The output does not depend on this setting. Default "0" processes all plugins on the rendering thread.
+	           - render.statistics.ramp_frames: Number of voice frames that were rendered with volume ramping since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
+	           - render.statistics.noramp_frames: Number of voice frames that were rendered one voice at a time without volume ramping since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
+	           - render.statistics.multivoice_frames: Number of voice frames that were rendered together with other voices using the same mix function since the module was loaded. Setting it to "0" restarts counting, other values are rejected.
 	           - dither: Set the dither algorithm that is used for the 16 bit versions of openmpt::module::read. Supported values are:
 	                     - 0: No dithering.
 	                     - 1: Default mode. Chosen by OpenMPT code, might change.
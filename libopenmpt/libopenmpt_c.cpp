@@ -510,6 +510,16 @@ int openmpt_probe_file_header_from_stream( uint64_t flags, openmpt_stream_callba
 	return OPENMPT_PROBE_FILE_HEADER_RESULT_ERROR;
 }
 
+int openmpt_probe_file_headers_batch( uint64_t flags, size_t count, const void * const * data, const size_t * sizes, const uint64_t * filesizes, int * results, openmpt_log_func logfunc, void * loguser, openmpt_error_func errfunc, void * erruser, int * error, const char * * error_message ) {
+	try {
+		openmpt::module_impl::probe_file_headers_batch( flags, count, data, sizes, filesizes, results );
+		return 1;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, logfunc, loguser, errfunc, erruser, error, error_message );
+	}
+	return 0;
+}
+
 openmpt_module * openmpt_module_create( openmpt_stream_callbacks stream_callbacks, void * stream, openmpt_log_func logfunc, void * user, const openmpt_module_initial_ctl * ctls ) {
 	return openmpt_module_create2( stream_callbacks, stream, logfunc, user, NULL, NULL, NULL, NULL, ctls );
 }
@@ -892,6 +902,33 @@ size_t openmpt_module_read_interleaved_float_quad( openmpt_module * mod, int32_t
 	}
 	return 0;
 }
+size_t openmpt_module_read_interleaved_float_stereo_add( openmpt_module * mod, int32_t samplerate, size_t count, float * interleaved_stereo, float gain ) {
+	try {
+		openmpt::interface::check_soundfile( mod );
+		return mod->impl->read_interleaved_stereo_add( samplerate, count, interleaved_stereo, gain );
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod );
+	}
+	return 0;
+}
+size_t openmpt_module_read_interleaved_float_quad_add( openmpt_module * mod, int32_t samplerate, size_t count, float * interleaved_quad, float gain ) {
+	try {
+		openmpt::interface::check_soundfile( mod );
+		return mod->impl->read_interleaved_quad_add( samplerate, count, interleaved_quad, gain );
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod );
+	}
+	return 0;
+}
+size_t openmpt_module_read_stems_interleaved_float_stereo( openmpt_module * mod, int32_t samplerate, size_t count, float * const * interleaved_stereo_stems ) {
+	try {
+		openmpt::interface::check_soundfile( mod );
+		return mod->impl->read_stems_interleaved_stereo( samplerate, count, interleaved_stereo_stems );
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod );
+	}
+	return 0;
+}
 
 const char * openmpt_module_get_metadata_keys( openmpt_module * mod ) {
 	try {
@@ -1207,6 +1244,16 @@ LIBOPENMPT_API uint8_t openmpt_module_get_pattern_row_channel_command( openmpt_m
 	return 0;
 }
 
+LIBOPENMPT_API int32_t openmpt_module_get_pattern_data( openmpt_module * mod, int32_t pattern, uint8_t * data, size_t size ) {
+	try {
+		openmpt::interface::check_soundfile( mod );
+		return mod->impl->get_pattern_data( pattern, data, size );
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod );
+	}
+	return 0;
+}
+
 LIBOPENMPT_API const char * openmpt_module_format_pattern_row_channel_command( openmpt_module * mod, int32_t pattern, int32_t row, int32_t channel, int command ) {
 	try {
 		openmpt::interface::check_soundfile( mod );
@@ -1247,6 +1294,17 @@ LIBOPENMPT_API const char * openmpt_module_highlight_pattern_row_channel( openmp
 	return 0;
 }
 
+LIBOPENMPT_API int openmpt_module_format_pattern_window( openmpt_module * mod, int32_t pattern, int32_t first_row, int32_t rows, int32_t first_channel, int32_t channels, size_t width, char * text, char * highlight ) {
+	try {
+		openmpt::interface::check_soundfile( mod );
+		mod->impl->format_pattern_window( pattern, first_row, rows, first_channel, channels, width, text, highlight );
+		return 1;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod );
+	}
+	return 0;
+}
+
 const char * openmpt_module_get_ctls( openmpt_module * mod ) {
 	try {
 		openmpt::interface::check_soundfile( mod );
@@ -1600,6 +1658,36 @@ int stop_note( openmpt_module_ext * mod_ext, int32_t channel ) {
 	return 0;
 }
 
+int32_t save_playback_state( openmpt_module_ext * mod_ext ) {
+	try {
+		openmpt::interface::check_soundfile( mod_ext );
+		return mod_ext->impl->save_playback_state();
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod_ext ? &mod_ext->mod : NULL );
+	}
+	return -1;
+}
+int restore_playback_state( openmpt_module_ext * mod_ext, int32_t state ) {
+	try {
+		openmpt::interface::check_soundfile( mod_ext );
+		mod_ext->impl->restore_playback_state( state );
+		return 1;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod_ext ? &mod_ext->mod : NULL );
+	}
+	return 0;
+}
+int free_playback_state( openmpt_module_ext * mod_ext, int32_t state ) {
+	try {
+		openmpt::interface::check_soundfile( mod_ext );
+		mod_ext->impl->free_playback_state( state );
+		return 1;
+	} catch ( ... ) {
+		openmpt::report_exception( __FUNCTION__, mod_ext ? &mod_ext->mod : NULL );
+	}
+	return 0;
+}
+
 
 
 /* add stuff here */
@@ -1648,6 +1736,15 @@ int openmpt_module_ext_get_interface( openmpt_module_ext * mod_ext, const char *
 
 
 
+		} else if ( !strcmp( interface_id, LIBOPENMPT_EXT_C_INTERFACE_PLAYBACK_STATE ) && ( interface_size == sizeof( openmpt_module_ext_interface_playback_state ) ) ) {
+			openmpt_module_ext_interface_playback_state * i = static_cast< openmpt_module_ext_interface_playback_state * >( interface );
+			i->save_playback_state = &save_playback_state;
+			i->restore_playback_state = &restore_playback_state;
+			i->free_playback_state = &free_playback_state;
+			result = 1;
+
+
+
 /* add stuff here */
 
 
@@ -146,6 +146,9 @@ int probe_file_header( std::uint64_t flags, const std::uint8_t * data, std::size
 int probe_file_header( std::uint64_t flags, std::istream & stream ) {
 	return openmpt::module_impl::probe_file_header( flags, stream );
 }
+void probe_file_headers_batch( std::uint64_t flags, std::size_t count, const std::uint8_t * const * data, const std::size_t * sizes, const std::uint64_t * filesizes, int * results ) {
+	openmpt::module_impl::probe_file_headers_batch( flags, count, reinterpret_cast<const void * const *>( data ), sizes, filesizes, results );
+}
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -276,6 +279,15 @@ std::size_t module::read_interleaved_stereo( std::int32_t samplerate, std::size_
 std::size_t module::read_interleaved_quad( std::int32_t samplerate, std::size_t count, float * interleaved_quad ) {
 	return impl->read_interleaved_quad( samplerate, count, interleaved_quad );
 }
+std::size_t module::read_interleaved_stereo_add( std::int32_t samplerate, std::size_t count, float * interleaved_stereo, float gain ) {
+	return impl->read_interleaved_stereo_add( samplerate, count, interleaved_stereo, gain );
+}
+std::size_t module::read_interleaved_quad_add( std::int32_t samplerate, std::size_t count, float * interleaved_quad, float gain ) {
+	return impl->read_interleaved_quad_add( samplerate, count, interleaved_quad, gain );
+}
+std::size_t module::read_stems_interleaved_stereo( std::int32_t samplerate, std::size_t count, float * const * interleaved_stereo_stems ) {
+	return impl->read_stems_interleaved_stereo( samplerate, count, interleaved_stereo_stems );
+}
 
 std::vector<std::string> module::get_metadata_keys() const {
 	return impl->get_metadata_keys();
@@ -367,6 +379,9 @@ std::int32_t module::get_pattern_num_rows( std::int32_t pattern ) const {
 std::uint8_t module::get_pattern_row_channel_command( std::int32_t pattern, std::int32_t row, std::int32_t channel, int command ) const {
 	return impl->get_pattern_row_channel_command( pattern, row, channel, command );
 }
+std::int32_t module::get_pattern_data( std::int32_t pattern, std::uint8_t * data, std::size_t size ) const {
+	return impl->get_pattern_data( pattern, data, size );
+}
 
 std::string module::format_pattern_row_channel_command( std::int32_t pattern, std::int32_t row, std::int32_t channel, int command ) const {
 	return impl->format_pattern_row_channel_command( pattern, row, channel, command );
@@ -381,6 +396,9 @@ std::string module::format_pattern_row_channel( std::int32_t pattern, std::int32
 std::string module::highlight_pattern_row_channel( std::int32_t pattern, std::int32_t row, std::int32_t channel, std::size_t width, bool pad ) const {
 	return impl->highlight_pattern_row_channel( pattern, row, channel, width, pad );
 }
+void module::format_pattern_window( std::int32_t pattern, std::int32_t first_row, std::int32_t rows, std::int32_t first_channel, std::int32_t channels, std::size_t width, char * text, char * highlight ) const {
+	impl->format_pattern_window( pattern, first_row, rows, first_channel, channels, width, text, highlight );
+}
 
 std::vector<std::string> module::get_ctls() const {
 	return impl->get_ctls();
@@ -433,6 +451,45 @@ void * module_ext::get_interface( const std::string & interface_id ) {
 	return ext_impl->get_interface( interface_id );
 }
 
+render_pool::render_pool( std::int32_t num_threads ) : impl(0) {
+	impl = new render_pool_impl( num_threads );
+}
+render_pool::~render_pool() {
+	delete impl;
+	impl = 0;
+}
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4702) // unreachable code
+#endif // _MSC_VER
+render_pool::render_pool( const render_pool & ) : impl(nullptr) {
+	throw std::runtime_error("openmpt::render_pool is non-copyable");
+}
+// cppcheck-suppress operatorEqVarError
+void render_pool::operator = ( const render_pool & ) {
+	throw std::runtime_error("openmpt::render_pool is non-copyable");
+}
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif // _MSC_VER
+
+std::int32_t render_pool::get_num_threads() const {
+	return impl->get_num_threads();
+}
+std::int32_t render_pool::add_module( module & mod, std::int32_t samplerate, std::size_t buffer_frames, std::size_t block_frames ) {
+	return impl->add_module( mod, samplerate, buffer_frames, block_frames );
+}
+void render_pool::remove_module( std::int32_t stream ) {
+	impl->remove_module( stream );
+}
+std::size_t render_pool::read_interleaved_stereo( std::int32_t stream, std::size_t count, float * interleaved_stereo ) {
+	return impl->read_interleaved_stereo( stream, count, interleaved_stereo );
+}
+render_pool::stream_statistics render_pool::get_statistics( std::int32_t stream ) const {
+	return impl->get_statistics( stream );
+}
+
 } // namespace openmpt
 
 #endif // NO_LIBOPENMPT_CXX
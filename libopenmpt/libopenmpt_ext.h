@@ -302,6 +302,49 @@ typedef struct openmpt_module_ext_interface_interactive {
 
 
 
+#ifndef LIBOPENMPT_EXT_C_INTERFACE_PLAYBACK_STATE
+#define LIBOPENMPT_EXT_C_INTERFACE_PLAYBACK_STATE "playback_state"
+#endif
+
+typedef struct openmpt_module_ext_interface_playback_state {
+	/*! Save the current playback state
+	 *
+	 * Captures the complete playback state (playback position, global and channel state including voices that are currently playing, loop and pattern delay state and plugin parameters) in memory.
+	 * Restoring a saved state is considerably cheaper than seeking with openmpt_module_set_position_seconds or openmpt_module_set_position_order_row, because no pattern data has to be replayed.
+	 * \param mod_ext The module handle to work on.
+	 * \return An identifier for the saved state which can be passed to openmpt_module_ext_interface_playback_state::restore_playback_state and openmpt_module_ext_interface_playback_state::free_playback_state, or -1 on failure.
+	 * \remarks Only channels that are in use are stored, so the size of a saved state depends on the number of active voices.
+	 * \remarks Saved states are bound to the module handle they were created from. They stay valid until they are freed or the module is destroyed.
+	 * \remarks Reverb tails, the state of the other master DSP effects and internal buffers of plugins are not part of the saved state. Restoring a state clears the reverb and DSP effects, audio that has been mixed for render.mix_samplerate but not yet returned, and stops OPL voices, similar to seeking.
+	 * \sa openmpt_module_ext_interface_playback_state::restore_playback_state
+	 * \sa openmpt_module_ext_interface_playback_state::free_playback_state
+	 * \since 0.5.0
+	 */
+	int32_t ( * save_playback_state ) ( openmpt_module_ext * mod_ext );
+
+	/*! Restore a saved playback state
+	 *
+	 * \param mod_ext The module handle to work on.
+	 * \param state The identifier of the state to restore, as returned by openmpt_module_ext_interface_playback_state::save_playback_state. The state stays valid and can be restored again.
+	 * \return 1 on success, 0 on failure (invalid identifier).
+	 * \sa openmpt_module_ext_interface_playback_state::save_playback_state
+	 * \since 0.5.0
+	 */
+	int ( * restore_playback_state ) ( openmpt_module_ext * mod_ext, int32_t state );
+
+	/*! Free a saved playback state
+	 *
+	 * \param mod_ext The module handle to work on.
+	 * \param state The identifier of the state to free, as returned by openmpt_module_ext_interface_playback_state::save_playback_state.
+	 * \return 1 on success, 0 on failure (invalid identifier).
+	 * \sa openmpt_module_ext_interface_playback_state::save_playback_state
+	 * \since 0.5.0
+	 */
+	int ( * free_playback_state ) ( openmpt_module_ext * mod_ext, int32_t state );
+} openmpt_module_ext_interface_playback_state;
+
+
+
 /* add stuff here */
 
 
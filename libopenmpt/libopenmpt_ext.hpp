@@ -33,6 +33,7 @@
 namespace openmpt {
 
 class module_ext_impl;
+class render_pool_impl;
 
 class LIBOPENMPT_CXX_API module_ext : public module {
 	
@@ -73,6 +74,94 @@ public:
 
 }; // class module_ext
 
+//! Renders several modules ahead of time on a shared set of worker threads
+/*!
+  Instead of calling openmpt::module::read_interleaved_stereo from one thread per module, modules can be registered with a render pool.
+  A fixed number of worker threads renders blocks of audio for all registered modules into per-module ring buffers.
+  Idle workers take over pending work from busy workers, so the load is spread evenly across all workers.
+  The rendered audio is retrieved with openmpt::render_pool::read_interleaved_stereo, which never renders by itself and never blocks on rendering.
+  \remarks A module must not be accessed in any other way while it is registered with a render pool. It must stay alive until it has been removed with openmpt::render_pool::remove_module or the render pool has been destroyed.
+  \remarks On platforms without thread support, no worker threads are created and openmpt::render_pool::read_interleaved_stereo renders the requested audio on the calling thread instead.
+  \since 0.5.0
+*/
+class LIBOPENMPT_CXX_API render_pool {
+
+private:
+	render_pool_impl * impl;
+private:
+	// non-copyable
+	render_pool( const render_pool & );
+	void operator = ( const render_pool & );
+
+public:
+
+	//! Statistics of a module registered with a render pool
+	struct stream_statistics {
+		//! Number of frames that have been rendered so far
+		std::uint64_t frames_rendered;
+		//! Number of frames that have been rendered but not read yet
+		std::uint64_t frames_buffered;
+		//! Number of calls to openmpt::render_pool::read_interleaved_stereo which could not be satisfied completely because rendering did not keep up
+		std::uint64_t deadline_misses;
+		//! true if the end of the module has been reached and all rendered frames have been read
+		bool ended;
+	};
+
+	//! Construct a render pool
+	/*!
+	  \param num_threads The number of worker threads. 0 uses one worker thread per hardware thread.
+	*/
+	render_pool( std::int32_t num_threads = 0 );
+	~render_pool();
+
+	//! Get the number of worker threads
+	/*!
+	  \return The number of worker threads used by this render pool. 0 if the platform does not support threads.
+	*/
+	std::int32_t get_num_threads() const;
+
+	//! Register a module with the render pool
+	/*!
+	  \param mod The module to render. Rendering starts immediately from the current playback position.
+	  \param samplerate Sample rate to render output. Should be in [8000,192000], but this is not enforced.
+	  \param buffer_frames Size of the ring buffer in frames. This is the maximum amount of audio that is rendered ahead, i.e. the latency of the stream.
+	  \param block_frames Number of frames that are rendered at once. Smaller blocks reduce the scheduling granularity, larger blocks reduce the scheduling overhead.
+	  \return An identifier for the registered module which can be passed to the other functions of the render pool.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if buffer_frames or block_frames is 0.
+	  \sa openmpt::render_pool::remove_module
+	*/
+	std::int32_t add_module( module & mod, std::int32_t samplerate, std::size_t buffer_frames, std::size_t block_frames = 1024 );
+
+	//! Unregister a module from the render pool
+	/*!
+	  Waits until the module is not being rendered anymore. After this function returns, the module can be used or destroyed again.
+	  \param stream The identifier returned by openmpt::render_pool::add_module.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if the identifier is invalid.
+	*/
+	void remove_module( std::int32_t stream );
+
+	//! Read rendered audio as interleaved 32bit floating point stereo
+	/*!
+	  Copies up to count frames from the ring buffer of a registered module and schedules rendering of the space that becomes available.
+	  \param stream The identifier returned by openmpt::render_pool::add_module.
+	  \param count Number of audio frames to read.
+	  \param interleaved_stereo Pointer to a buffer of at least count*2 floats that receives the audio data.
+	  \return The number of frames actually read. Less than count is a deadline miss unless the end of the module has been reached.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if the identifier is invalid.
+	  \sa openmpt::render_pool::get_statistics
+	*/
+	std::size_t read_interleaved_stereo( std::int32_t stream, std::size_t count, float * interleaved_stereo );
+
+	//! Get rendering statistics of a registered module
+	/*!
+	  \param stream The identifier returned by openmpt::render_pool::add_module.
+	  \return The current statistics of the module.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if the identifier is invalid.
+	*/
+	stream_statistics get_statistics( std::int32_t stream ) const;
+
+}; // class render_pool
+
 namespace ext {
 
 #define LIBOPENMPT_DECLARE_EXT_CXX_INTERFACE(name) \
@@ -288,6 +377,52 @@ class interactive {
 }; // class interactive
 
 
+#ifndef LIBOPENMPT_EXT_INTERFACE_PLAYBACK_STATE
+#define LIBOPENMPT_EXT_INTERFACE_PLAYBACK_STATE
+#endif
+
+LIBOPENMPT_DECLARE_EXT_CXX_INTERFACE(playback_state)
+
+class playback_state {
+
+	LIBOPENMPT_EXT_CXX_INTERFACE(playback_state)
+
+	//! Save the current playback state
+	/*!
+	  Captures the complete playback state (playback position, global and channel state including voices that are currently playing, loop and pattern delay state and plugin parameters) in memory.
+	  Restoring a saved state is considerably cheaper than seeking with openmpt::module::set_position_seconds or openmpt::module::set_position_order_row, because no pattern data has to be replayed.
+	  \return An identifier for the saved state which can be passed to openmpt::ext::playback_state::restore_playback_state and openmpt::ext::playback_state::free_playback_state.
+	  \remarks Only channels that are in use are stored, so the size of a saved state depends on the number of active voices.
+	  \remarks Saved states are bound to the module object they were created from. They stay valid until they are freed or the module is destroyed.
+	  \remarks Reverb tails, the state of the other master DSP effects and internal buffers of plugins are not part of the saved state. Restoring a state clears the reverb and DSP effects, audio that has been mixed for render.mix_samplerate but not yet returned, and stops OPL voices, similar to seeking.
+	  \sa openmpt::ext::playback_state::restore_playback_state
+	  \sa openmpt::ext::playback_state::free_playback_state
+	  \since 0.5.0
+	*/
+	virtual std::int32_t save_playback_state() = 0;
+
+	//! Restore a saved playback state
+	/*!
+	  \param state The identifier of the state to restore, as returned by openmpt::ext::playback_state::save_playback_state. The state stays valid and can be restored again.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if the identifier does not refer to a saved state.
+	  \remarks Subsequent openmpt::module::read calls continue rendering exactly as they would have continued after the state was saved, except for the parts of the state listed in openmpt::ext::playback_state::save_playback_state.
+	  \sa openmpt::ext::playback_state::save_playback_state
+	  \since 0.5.0
+	*/
+	virtual void restore_playback_state( std::int32_t state ) = 0;
+
+	//! Free a saved playback state
+	/*!
+	  \param state The identifier of the state to free, as returned by openmpt::ext::playback_state::save_playback_state.
+	  \throws openmpt::exception Throws an exception derived from openmpt::exception if the identifier does not refer to a saved state.
+	  \sa openmpt::ext::playback_state::save_playback_state
+	  \since 0.5.0
+	*/
+	virtual void free_playback_state( std::int32_t state ) = 0;
+
+}; // class playback_state
+
+
 /* add stuff here */
 
 
@@ -14,6 +14,8 @@
 
 #include "libopenmpt_ext_impl.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 #include "soundlib/Sndfile.h"
@@ -46,9 +48,22 @@ namespace openmpt {
 
 
 
-	void module_ext_impl::ctor() {
+	struct module_ext_impl::saved_playback_state {
+		CSoundFile::PlayStateSnapshot snapshot;
+		double position_seconds;
+		std::int32_t subsong;
+		saved_playback_state( const CSoundFile & sndFile, double position_seconds_, std::int32_t subsong_ )
+			: snapshot( sndFile )
+			, position_seconds( position_seconds_ )
+			, subsong( subsong_ )
+		{
+			return;
+		}
+	};
 
+	void module_ext_impl::ctor() {
 
+		m_next_playback_state_id = 0;
 
 		/* add stuff here */
 
@@ -77,6 +92,8 @@ namespace openmpt {
 			return dynamic_cast< ext::pattern_vis * >( this );
 		} else if ( interface_id == ext::interactive_id ) {
 			return dynamic_cast< ext::interactive * >( this );
+		} else if ( interface_id == ext::playback_state_id ) {
+			return dynamic_cast< ext::playback_state * >( this );
 
 
 
@@ -297,10 +314,283 @@ namespace openmpt {
 		chn.pCurrentSample = nullptr;
 	}
 
+	// playback_state
+
+	std::int32_t module_ext_impl::save_playback_state() {
+		std::unique_ptr<saved_playback_state> state = std::make_unique<saved_playback_state>( *m_sndFile, m_currentPositionSeconds, m_current_subsong );
+		while ( m_saved_playback_states.count( m_next_playback_state_id ) ) {
+			m_next_playback_state_id = ( m_next_playback_state_id == std::numeric_limits<std::int32_t>::max() ) ? 0 : m_next_playback_state_id + 1;
+		}
+		const std::int32_t id = m_next_playback_state_id;
+		m_saved_playback_states[id] = std::move( state );
+		m_next_playback_state_id = ( id == std::numeric_limits<std::int32_t>::max() ) ? 0 : id + 1;
+		return id;
+	}
+
+	void module_ext_impl::restore_playback_state( std::int32_t state ) {
+		auto it = m_saved_playback_states.find( state );
+		if ( it == m_saved_playback_states.end() ) {
+			throw openmpt::exception("invalid playback state");
+		}
+		m_sndFile->RestorePlayState( it->second->snapshot );
+		reset_output_resampler();
+		m_currentPositionSeconds = it->second->position_seconds;
+		m_current_subsong = it->second->subsong;
+	}
+
+	void module_ext_impl::free_playback_state( std::int32_t state ) {
+		if ( m_saved_playback_states.erase( state ) == 0 ) {
+			throw openmpt::exception("invalid playback state");
+		}
+	}
+
 
 	/* add stuff here */
 
 
 
-} // namespace openmpt
+	render_pool_impl::stream::stream( module & mod_, std::int32_t samplerate_, std::size_t buffer_frames, std::size_t block_frames_, std::size_t home_worker_ )
+		: mod( mod_ )
+		, samplerate( samplerate_ )
+		, block_frames( block_frames_ )
+		, home_worker( home_worker_ )
+		, buffer( std::max( buffer_frames, block_frames_ ) * 2 )
+		, render_buffer( block_frames_ * 2 )
+		, write_frames( 0 )
+		, read_frames( 0 )
+		, deadline_misses( 0 )
+		, queued( false )
+		, finished( false )
+		, removed( false )
+	{
+		return;
+	}
+
+	std::size_t render_pool_impl::stream::get_free_frames() const {
+		return buffer.size() / 2 - static_cast<std::size_t>( write_frames.load() - read_frames.load() );
+	}
+
+	render_pool_impl::render_pool_impl( std::int32_t num_threads )
+		: m_next_stream_id( 0 )
+		, m_next_home_worker( 0 )
+#if MPT_MUTEX_STD
+		, m_pending( 0 )
+		, m_shutdown( false )
+#endif // MPT_MUTEX_STD
+	{
+#if MPT_MUTEX_STD
+		if ( num_threads <= 0 ) {
+			num_threads = std::max( static_cast<std::int32_t>( std::thread::hardware_concurrency() ), 1 );
+		}
+		for ( std::int32_t i = 0; i < num_threads; ++i ) {
+			m_workers.push_back( std::make_unique<worker>() );
+		}
+		for ( std::size_t i = 0; i < m_workers.size(); ++i ) {
+			m_workers[i]->thread = std::thread( &render_pool_impl::worker_thread, this, i );
+		}
+#else // !MPT_MUTEX_STD
+		static_cast<void>( num_threads );
+#endif // MPT_MUTEX_STD
+	}
+
+	render_pool_impl::~render_pool_impl() {
+#if MPT_MUTEX_STD
+		{
+			std::lock_guard<std::mutex> lock( m_wakeup_mutex );
+			m_shutdown = true;
+		}
+		m_wakeup.notify_all();
+		for ( auto & w : m_workers ) {
+			w->thread.join();
+		}
+#endif // MPT_MUTEX_STD
+	}
+
+	std::int32_t render_pool_impl::get_num_threads() const {
+		return static_cast<std::int32_t>( m_workers.size() );
+	}
+
+	std::int32_t render_pool_impl::add_module( module & mod, std::int32_t samplerate, std::size_t buffer_frames, std::size_t block_frames ) {
+		if ( buffer_frames == 0 || block_frames == 0 ) {
+			throw openmpt::exception("invalid buffer size");
+		}
+		std::shared_ptr<stream> s;
+		std::int32_t stream_id = 0;
+		{
+			MPT_LOCK_GUARD<mpt::mutex> lock( m_streams_mutex );
+			while ( m_streams.count( m_next_stream_id ) ) {
+				m_next_stream_id = ( m_next_stream_id == std::numeric_limits<std::int32_t>::max() ) ? 0 : m_next_stream_id + 1;
+			}
+			stream_id = m_next_stream_id;
+			m_next_stream_id = ( stream_id == std::numeric_limits<std::int32_t>::max() ) ? 0 : stream_id + 1;
+			// Distribute streams evenly, each stream is preferably rendered by the same worker to keep its data in that worker's cache.
+			const std::size_t home_worker = m_workers.empty() ? 0 : m_next_home_worker++ % m_workers.size();
+			s = std::make_shared<stream>( mod, samplerate, buffer_frames, block_frames, home_worker );
+			m_streams[stream_id] = s;
+		}
+		schedule( s, s->home_worker );
+		return stream_id;
+	}
+
+	void render_pool_impl::remove_module( std::int32_t stream_id ) {
+		std::shared_ptr<stream> s;
+		{
+			MPT_LOCK_GUARD<mpt::mutex> lock( m_streams_mutex );
+			auto it = m_streams.find( stream_id );
+			if ( it == m_streams.end() ) {
+				throw openmpt::exception("invalid stream");
+			}
+			s = std::move( it->second );
+			m_streams.erase( it );
+		}
+		// Wait for a worker that is currently rendering this stream. Queued references are dropped by the workers later.
+		MPT_LOCK_GUARD<mpt::mutex> lock( s->render_mutex );
+		s->removed = true;
+	}
 
+	std::size_t render_pool_impl::read_interleaved_stereo( std::int32_t stream_id, std::size_t count, float * interleaved_stereo ) {
+		std::shared_ptr<stream> s = get_stream( stream_id );
+		if ( m_workers.empty() ) {
+			while ( s->write_frames.load() - s->read_frames.load() < count ) {
+				if ( !render_block( *s ) ) {
+					break;
+				}
+			}
+		}
+		const std::size_t capacity = s->buffer.size() / 2;
+		const std::uint64_t read_pos = s->read_frames.load( std::memory_order_relaxed );
+		const std::size_t available = static_cast<std::size_t>( s->write_frames.load( std::memory_order_acquire ) - read_pos );
+		const std::size_t frames = std::min( count, available );
+		const std::size_t offset = static_cast<std::size_t>( read_pos % capacity );
+		const std::size_t first = std::min( frames, capacity - offset );
+		std::copy( s->buffer.begin() + offset * 2, s->buffer.begin() + ( offset + first ) * 2, interleaved_stereo );
+		std::copy( s->buffer.begin(), s->buffer.begin() + ( frames - first ) * 2, interleaved_stereo + first * 2 );
+		s->read_frames.store( read_pos + frames, std::memory_order_release );
+		if ( frames < count && !s->finished.load() ) {
+			s->deadline_misses++;
+		}
+		schedule( s, s->home_worker );
+		return frames;
+	}
+
+	render_pool::stream_statistics render_pool_impl::get_statistics( std::int32_t stream_id ) const {
+		std::shared_ptr<stream> s = get_stream( stream_id );
+		render_pool::stream_statistics result;
+		result.frames_rendered = s->write_frames.load();
+		result.frames_buffered = result.frames_rendered - s->read_frames.load();
+		result.deadline_misses = s->deadline_misses.load();
+		result.ended = s->finished.load() && result.frames_buffered == 0;
+		return result;
+	}
+
+	std::shared_ptr<render_pool_impl::stream> render_pool_impl::get_stream( std::int32_t stream_id ) const {
+		MPT_LOCK_GUARD<mpt::mutex> lock( m_streams_mutex );
+		auto it = m_streams.find( stream_id );
+		if ( it == m_streams.end() ) {
+			throw openmpt::exception("invalid stream");
+		}
+		return it->second;
+	}
+
+	bool render_pool_impl::render_block( stream & s ) {
+		MPT_LOCK_GUARD<mpt::mutex> lock( s.render_mutex );
+		if ( s.removed || s.finished.load() ) {
+			return false;
+		}
+		const std::size_t count = std::min( s.get_free_frames(), s.block_frames );
+		if ( count == 0 ) {
+			return false;
+		}
+		std::size_t rendered = 0;
+		try {
+			rendered = s.mod.read_interleaved_stereo( s.samplerate, count, s.render_buffer.data() );
+		} catch ( ... ) {
+			rendered = 0;
+		}
+		const std::size_t capacity = s.buffer.size() / 2;
+		const std::uint64_t write_pos = s.write_frames.load( std::memory_order_relaxed );
+		const std::size_t offset = static_cast<std::size_t>( write_pos % capacity );
+		const std::size_t first = std::min( rendered, capacity - offset );
+		std::copy( s.render_buffer.begin(), s.render_buffer.begin() + first * 2, s.buffer.begin() + offset * 2 );
+		std::copy( s.render_buffer.begin() + first * 2, s.render_buffer.begin() + rendered * 2, s.buffer.begin() );
+		s.write_frames.store( write_pos + rendered, std::memory_order_release );
+		if ( rendered < count ) {
+			s.finished.store( true );
+		}
+		return rendered > 0;
+	}
+
+	void render_pool_impl::schedule( const std::shared_ptr<stream> & s, std::size_t worker_index ) {
+#if MPT_MUTEX_STD
+		if ( m_workers.empty() || s->finished.load() || s->get_free_frames() < s->block_frames ) {
+			return;
+		}
+		if ( s->queued.exchange( true ) ) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock( m_wakeup_mutex );
+			m_pending++;
+		}
+		{
+			MPT_LOCK_GUARD<mpt::mutex> lock( m_workers[worker_index]->queue_mutex );
+			m_workers[worker_index]->queue.push_back( s );
+		}
+		m_wakeup.notify_one();
+#else // !MPT_MUTEX_STD
+		static_cast<void>( s );
+		static_cast<void>( worker_index );
+#endif // MPT_MUTEX_STD
+	}
+
+#if MPT_MUTEX_STD
+
+	std::shared_ptr<render_pool_impl::stream> render_pool_impl::take_work( std::size_t worker_index ) {
+		std::shared_ptr<stream> s;
+		{
+			worker & self = *m_workers[worker_index];
+			MPT_LOCK_GUARD<mpt::mutex> lock( self.queue_mutex );
+			if ( !self.queue.empty() ) {
+				s = std::move( self.queue.front() );
+				self.queue.pop_front();
+			}
+		}
+		// Steal from the back of the other queues, the front is what the owning worker is going to render next.
+		for ( std::size_t i = 1; !s && i < m_workers.size(); ++i ) {
+			worker & victim = *m_workers[( worker_index + i ) % m_workers.size()];
+			MPT_LOCK_GUARD<mpt::mutex> lock( victim.queue_mutex );
+			if ( !victim.queue.empty() ) {
+				s = std::move( victim.queue.back() );
+				victim.queue.pop_back();
+			}
+		}
+		if ( s ) {
+			std::lock_guard<std::mutex> lock( m_wakeup_mutex );
+			m_pending--;
+		}
+		return s;
+	}
+
+	void render_pool_impl::worker_thread( std::size_t worker_index ) {
+		while ( true ) {
+			std::shared_ptr<stream> s = take_work( worker_index );
+			if ( !s ) {
+				std::unique_lock<std::mutex> lock( m_wakeup_mutex );
+				m_wakeup.wait( lock, [this]() { return m_shutdown || m_pending > 0; } );
+				if ( m_shutdown ) {
+					return;
+				}
+				continue;
+			}
+			const bool rendered = render_block( *s );
+			s->queued.store( false );
+			if ( rendered ) {
+				// Keep rendering on this worker if there is still space left, the stream data is already in its cache.
+				schedule( s, worker_index );
+			}
+		}
+	}
+
+#endif // MPT_MUTEX_STD
+
+} // namespace openmpt
@@ -14,6 +14,20 @@
 #include "libopenmpt_impl.hpp"
 #include "libopenmpt_ext.hpp"
 
+#include "common/mptMutex.h"
+
+#include <atomic>
+#if MPT_MUTEX_STD
+#if (defined(__MINGW32__) || defined(__MINGW64__)) && !defined(_GLIBCXX_HAS_GTHREADS) && defined(MPT_WITH_MINGWSTDTHREADS)
+#include <mingw.condition_variable.h>
+#include <mingw.thread.h>
+#else
+#include <condition_variable>
+#include <thread>
+#endif
+#endif // MPT_MUTEX_STD
+#include <deque>
+
 using namespace OpenMPT;
 
 namespace openmpt {
@@ -22,6 +36,7 @@ class module_ext_impl
 	: public module_impl
 	, public ext::pattern_vis
 	, public ext::interactive
+	, public ext::playback_state
 
 
 
@@ -41,7 +56,9 @@ public:
 
 private:
 
-
+	struct saved_playback_state;
+	std::map< std::int32_t, std::unique_ptr<saved_playback_state> > m_saved_playback_states;
+	std::int32_t m_next_playback_state_id;
 
 	/* add stuff here */
 
@@ -99,6 +116,14 @@ public:
 
 	void stop_note( std::int32_t channel ) override;
 
+	// playback_state
+
+	std::int32_t save_playback_state() override;
+
+	void restore_playback_state( std::int32_t state ) override;
+
+	void free_playback_state( std::int32_t state ) override;
+
 
 	/* add stuff here */
 
@@ -106,6 +131,75 @@ public:
 
 }; // class module_ext_impl
 
+class render_pool_impl {
+
+private:
+
+	struct stream {
+		module & mod;
+		const std::int32_t samplerate;
+		const std::size_t block_frames;
+		const std::size_t home_worker;
+		std::vector<float> buffer; // interleaved stereo ring buffer
+		std::vector<float> render_buffer;
+		// write_frames is only modified by the thread that is rendering the stream, read_frames only by the reading thread.
+		std::atomic<std::uint64_t> write_frames;
+		std::atomic<std::uint64_t> read_frames;
+		std::atomic<std::uint64_t> deadline_misses;
+		std::atomic<bool> queued;
+		std::atomic<bool> finished;
+		mpt::mutex render_mutex;
+		bool removed; // protected by render_mutex
+		stream( module & mod, std::int32_t samplerate, std::size_t buffer_frames, std::size_t block_frames, std::size_t home_worker );
+		std::size_t get_free_frames() const;
+	};
+
+	struct worker {
+		mpt::mutex queue_mutex;
+		std::deque< std::shared_ptr<stream> > queue;
+#if MPT_MUTEX_STD
+		std::thread thread;
+#endif // MPT_MUTEX_STD
+	};
+
+	std::vector< std::unique_ptr<worker> > m_workers;
+
+	mutable mpt::mutex m_streams_mutex;
+	std::map< std::int32_t, std::shared_ptr<stream> > m_streams;
+	std::int32_t m_next_stream_id;
+	std::size_t m_next_home_worker;
+
+#if MPT_MUTEX_STD
+	std::mutex m_wakeup_mutex;
+	std::condition_variable m_wakeup;
+	std::size_t m_pending;
+	bool m_shutdown;
+#endif // MPT_MUTEX_STD
+
+public:
+
+	render_pool_impl( std::int32_t num_threads );
+	~render_pool_impl();
+
+	std::int32_t get_num_threads() const;
+
+	std::int32_t add_module( module & mod, std::int32_t samplerate, std::size_t buffer_frames, std::size_t block_frames );
+	void remove_module( std::int32_t stream_id );
+	std::size_t read_interleaved_stereo( std::int32_t stream_id, std::size_t count, float * interleaved_stereo );
+	render_pool::stream_statistics get_statistics( std::int32_t stream_id ) const;
+
+private:
+
+	std::shared_ptr<stream> get_stream( std::int32_t stream_id ) const;
+	static bool render_block( stream & s );
+	void schedule( const std::shared_ptr<stream> & s, std::size_t worker_index );
+#if MPT_MUTEX_STD
+	std::shared_ptr<stream> take_work( std::size_t worker_index );
+	void worker_thread( std::size_t worker_index );
+#endif // MPT_MUTEX_STD
+
+}; // class render_pool_impl
+
 } // namespace openmpt
 
 #endif // LIBOPENMPT_EXT_IMPL_HPP
@@ -32,6 +32,7 @@
 #include "common/mptMutex.h"
 #include "soundlib/Sndfile.h"
 #include "soundlib/mod_specifications.h"
+#include "soundlib/Tables.h"
 #include "soundlib/AudioReadTarget.h"
 
 OPENMPT_NAMESPACE_BEGIN
@@ -392,20 +393,187 @@ static void mixersettings_to_ramping( int & ramping, const MixerSettings & setti
 	}
 }
 
+// Polyphase FIR sample rate converter for the master mix.
+// Used if the module is mixed at a different sample rate than the requested output sample rate.
+class output_resampler : public IAudioReadTarget {
+private:
+	static const std::size_t phase_bits = 8;
+	static const std::size_t phases = 1 << phase_bits;
+	std::int32_t m_input_samplerate;
+	std::int32_t m_output_samplerate;
+	std::size_t m_channels;
+	std::size_t m_taps;
+	std::vector<float> m_coefs; // ( phases + 1 ) rows of m_taps coefficients
+	std::uint64_t m_increment; // input frames per output frame, 32.32 fixed point
+	std::uint64_t m_position; // position of the next output frame in m_input, 32.32 fixed point
+	std::vector<float> m_input; // interleaved input history
+	bool m_flushing; // m_input has been padded with silence after the last input frame
+	std::vector<float> m_kernel;
+	std::vector<float> m_output;
+	static double izero( double y ) {
+		double s = 1.0, ds = 1.0, d = 0.0;
+		do {
+			d = d + 2.0;
+			ds = ds * ( y * y ) / ( d * d );
+			s = s + ds;
+		} while ( ds > 1e-7 * s );
+		return s;
+	}
+public:
+	output_resampler( std::int32_t input_samplerate, std::int32_t output_samplerate, std::size_t channels )
+		: m_input_samplerate( input_samplerate )
+		, m_output_samplerate( output_samplerate )
+		, m_channels( channels )
+	{
+		// 64 taps with a Kaiser window (beta 8.6, about 86dB stopband attenuation) at a cutoff of 0.46 * the lower of both sample rates.
+		// For downsampling, the filter gets longer in proportion to the ratio in order to keep the same transition band width.
+		const double ratio = static_cast<double>( output_samplerate ) / static_cast<double>( input_samplerate );
+		const double cutoff = 0.46 * std::min( 1.0, ratio );
+		m_taps = 64 * static_cast<std::size_t>( std::ceil( std::max( 1.0, 1.0 / ratio ) ) );
+		const double beta = 8.6;
+		const double half_width = static_cast<double>( m_taps / 2 );
+		const double izero_beta = izero( beta );
+		const double pi = 3.14159265358979323846;
+		m_coefs.resize( ( phases + 1 ) * m_taps );
+		for ( std::size_t phase = 0; phase <= phases; ++phase ) {
+			float * coefs = &m_coefs[phase * m_taps];
+			double sum = 0.0;
+			for ( std::size_t tap = 0; tap < m_taps; ++tap ) {
+				const double x = static_cast<double>( tap ) - ( half_width - 1.0 ) - static_cast<double>( phase ) / static_cast<double>( phases );
+				const double w = ( x / half_width ) * ( x / half_width );
+				const double window = ( w < 1.0 ) ? izero( beta * std::sqrt( 1.0 - w ) ) / izero_beta : 0.0;
+				const double sinc = ( x == 0.0 ) ? 1.0 : std::sin( 2.0 * pi * cutoff * x ) / ( 2.0 * pi * cutoff * x );
+				coefs[tap] = static_cast<float>( sinc * window );
+				sum += coefs[tap];
+			}
+			for ( std::size_t tap = 0; tap < m_taps; ++tap ) {
+				coefs[tap] = static_cast<float>( coefs[tap] / sum );
+			}
+		}
+		m_increment = ( static_cast<std::uint64_t>( input_samplerate ) << 32 ) / static_cast<std::uint64_t>( output_samplerate );
+		m_kernel.resize( m_taps );
+		m_output.resize( MIXBUFFERSIZE * m_channels );
+		reset();
+	}
+	bool matches( std::int32_t input_samplerate, std::int32_t output_samplerate, std::size_t channels ) const {
+		return m_input_samplerate == input_samplerate && m_output_samplerate == output_samplerate && m_channels == channels;
+	}
+	std::int32_t get_input_samplerate() const {
+		return m_input_samplerate;
+	}
+	bool matches_output( std::int32_t output_samplerate, std::size_t channels ) const {
+		return m_output_samplerate == output_samplerate && m_channels == channels;
+	}
+	// Discards all buffered input, e.g. after seeking.
+	void reset() {
+		// Prime the history so that the first output frame is aligned with the first input frame.
+		m_input.assign( ( m_taps / 2 - 1 ) * m_channels, 0.0f );
+		m_position = static_cast<std::uint64_t>( m_taps / 2 - 1 ) << 32;
+		m_flushing = false;
+	}
+	// Pads the buffered input with silence so that process() can produce the output frames for the last input frames, which are otherwise held back as filter look-ahead.
+	// Returns false if there is no buffered input left that has not been turned into output yet.
+	// Once all output has been produced, the resampler is reset and accepts new input as if it had just been created.
+	bool flush() {
+		if ( m_flushing ) {
+			return true;
+		}
+		if ( ( m_position >> 32 ) >= m_input.size() / m_channels ) {
+			return false;
+		}
+		m_input.resize( m_input.size() + ( m_taps / 2 ) * m_channels, 0.0f );
+		m_flushing = true;
+		return true;
+	}
+	// Number of input frames that have to be mixed before at least one and at most count output frames can be produced.
+	std::size_t get_required_input_frames( std::size_t count ) const {
+		count = std::min( count, static_cast<std::size_t>( MIXBUFFERSIZE ) );
+		const std::size_t available = m_input.size() / m_channels;
+		const std::size_t required = static_cast<std::size_t>( ( m_position + ( count - 1 ) * m_increment ) >> 32 ) + m_taps / 2 + 1;
+		return ( required > available ) ? ( required - available ) : 1;
+	}
+	void DataCallback( MixSampleInt * MixSoundBuffer, std::size_t channels, std::size_t countChunk ) override {
+		MPT_ASSERT( channels == m_channels );
+		MPT_ASSERT( !m_flushing );
+		const float factor = 1.0f / static_cast<float>( 1 << MixSampleIntTraits::mix_fractional_bits() );
+		const std::size_t offset = m_input.size();
+		m_input.resize( offset + countChunk * channels );
+		for ( std::size_t i = 0; i < countChunk * channels; ++i ) {
+			m_input[offset + i] = static_cast<float>( MixSoundBuffer[i] ) * factor;
+		}
+	}
+	void DataCallback( MixSampleFloat * MixSoundBuffer, std::size_t channels, std::size_t countChunk ) override {
+		MPT_ASSERT( channels == m_channels );
+		MPT_ASSERT( !m_flushing );
+		m_input.insert( m_input.end(), MixSoundBuffer, MixSoundBuffer + countChunk * channels );
+	}
+	// Produces up to count output frames from the buffered input and passes them on to target.
+	std::size_t process( std::size_t count, IAudioReadTarget & target ) {
+		count = std::min( count, static_cast<std::size_t>( MIXBUFFERSIZE ) );
+		const std::size_t available = m_input.size() / m_channels;
+		const float phase_scale = 1.0f / static_cast<float>( std::uint64_t( 1 ) << ( 32 - phase_bits ) );
+		std::size_t frames = 0;
+		while ( frames < count ) {
+			const std::size_t pos = static_cast<std::size_t>( m_position >> 32 );
+			if ( pos + m_taps / 2 >= available ) {
+				break;
+			}
+			const std::uint32_t frac = static_cast<std::uint32_t>( m_position );
+			const float * coefs0 = &m_coefs[( frac >> ( 32 - phase_bits ) ) * m_taps];
+			const float * coefs1 = coefs0 + m_taps;
+			const float t = static_cast<float>( frac & ( ( 1u << ( 32 - phase_bits ) ) - 1 ) ) * phase_scale;
+			for ( std::size_t tap = 0; tap < m_taps; ++tap ) {
+				m_kernel[tap] = coefs0[tap] + ( coefs1[tap] - coefs0[tap] ) * t;
+			}
+			const float * in = &m_input[( pos + 1 - m_taps / 2 ) * m_channels];
+			float * out = &m_output[frames * m_channels];
+			for ( std::size_t channel = 0; channel < m_channels; ++channel ) {
+				float sum = 0.0f;
+				for ( std::size_t tap = 0; tap < m_taps; ++tap ) {
+					sum += in[tap * m_channels + channel] * m_kernel[tap];
+				}
+				out[channel] = sum;
+			}
+			m_position += m_increment;
+			frames++;
+		}
+		// Drop input history that is not needed anymore
+		const std::size_t pos = static_cast<std::size_t>( m_position >> 32 );
+		if ( pos + 1 > m_taps / 2 ) {
+			const std::size_t discard = pos + 1 - m_taps / 2;
+			m_input.erase( m_input.begin(), m_input.begin() + discard * m_channels );
+			m_position -= static_cast<std::uint64_t>( discard ) << 32;
+		}
+		if ( frames > 0 ) {
+			target.DataCallback( m_output.data(), m_channels, frames );
+		} else if ( m_flushing ) {
+			reset();
+		}
+		return frames;
+	}
+}; // class output_resampler
+
 std::string module_impl::mod_string_to_utf8( const std::string & encoded ) const {
 	return mpt::ToCharset( mpt::CharsetUTF8, m_sndFile->GetCharsetInternal(), encoded );
 }
-void module_impl::apply_mixer_settings( std::int32_t samplerate, int channels ) {
-	bool samplerate_changed = static_cast<std::int32_t>( m_sndFile->m_MixerSettings.gdwMixingFreq ) != samplerate;
+void module_impl::apply_mixer_settings( std::int32_t samplerate, int channels, bool stems ) {
+	// Stems are always rendered at the output sample rate
+	const std::int32_t mix_samplerate = ( !stems && m_ctl_render_mix_samplerate > 0 ) ? m_ctl_render_mix_samplerate : samplerate;
+	bool samplerate_changed = static_cast<std::int32_t>( m_sndFile->m_MixerSettings.gdwMixingFreq ) != mix_samplerate;
 	bool channels_changed = static_cast<int>( m_sndFile->m_MixerSettings.gnChannels ) != channels;
 	if ( samplerate_changed || channels_changed ) {
 		MixerSettings mixersettings = m_sndFile->m_MixerSettings;
 		std::int32_t volrampin_us = mixersettings.GetVolumeRampUpMicroseconds();
 		std::int32_t volrampout_us = mixersettings.GetVolumeRampDownMicroseconds();
-		mixersettings.gdwMixingFreq = samplerate;
+		mixersettings.gdwMixingFreq = mix_samplerate;
 		mixersettings.gnChannels = channels;
 		mixersettings.SetVolumeRampUpMicroseconds( volrampin_us );
 		mixersettings.SetVolumeRampDownMicroseconds( volrampout_us );
+		if ( samplerate_changed && m_sndFile->m_MixerSettings.gdwMixingFreq > 0 ) {
+			// The rate can change in the middle of a tick, e.g. when render.mix_samplerate is changed between read calls.
+			// Keep the remaining part of the current tick at the same duration, so that the song timing does not shift.
+			m_sndFile->m_PlayState.SetBufferCount( Util::muldivr_unsigned( m_sndFile->m_PlayState.GetBufferCount(), mix_samplerate, m_sndFile->m_MixerSettings.gdwMixingFreq ) );
+		}
 		m_sndFile->SetMixerSettings( mixersettings );
 	} else if ( !m_mixer_initialized ) {
 		m_sndFile->InitPlayer( true );
@@ -414,13 +582,31 @@ void module_impl::apply_mixer_settings( std::int32_t samplerate, int channels )
 		m_sndFile->SuspendPlugins();
 		m_sndFile->ResumePlugins();
 	}
+	if ( mix_samplerate == samplerate ) {
+		// Frames that have already been mixed at the previous rate are still played back before the resampler is removed.
+		if ( m_output_resampler && ( stems || !m_output_resampler->matches_output( samplerate, channels ) || !m_output_resampler->flush() ) ) {
+			m_output_resampler = nullptr;
+		}
+	} else if ( !m_output_resampler || !m_output_resampler->matches( mix_samplerate, samplerate, channels ) ) {
+		m_output_resampler = std::make_unique<output_resampler>( mix_samplerate, samplerate, channels );
+	}
+	m_sndFile->SetStemRendering( stems );
 	m_mixer_initialized = true;
 }
+void module_impl::reset_output_resampler() {
+	// Mixed frames that are still buffered belong to the previous playback position.
+	if ( m_output_resampler ) {
+		m_output_resampler->reset();
+	}
+}
 void module_impl::apply_libopenmpt_defaults() {
 	set_render_param( module::RENDER_STEREOSEPARATION_PERCENT, 100 );
 	m_sndFile->Order.SetSequence( 0 );
 }
 module_impl::subsongs_type module_impl::get_subsongs() const {
+	if ( m_loaded_metadata_only ) {
+		throw openmpt::exception("durations and subsongs are not available for modules loaded with load.metadata_only");
+	}
 	std::vector<subsong_data> subsongs;
 	if ( m_sndFile->Order.GetNumSequences() == 0 ) {
 		throw openmpt::exception("module contains no songs");
@@ -442,6 +628,7 @@ bool module_impl::has_subsongs_inited() const {
 void module_impl::ctor( const std::map< std::string, std::string > & ctls ) {
 	m_sndFile = std::make_unique<CSoundFile>();
 	m_loaded = false;
+	m_loaded_metadata_only = false;
 	m_mixer_initialized = false;
 	m_Dither = std::make_unique<Dither>( mpt::global_prng() );
 	m_LogForwarder = std::make_unique<log_forwarder>( *m_Log );
@@ -454,7 +641,10 @@ void module_impl::ctor( const std::map< std::string, std::string > & ctls ) {
 	m_ctl_load_skip_patterns = false;
 	m_ctl_load_skip_plugins = false;
 	m_ctl_load_skip_subsongs_init = false;
+	m_ctl_load_progressive = false;
+	m_ctl_load_metadata_only = false;
 	m_ctl_seek_sync_samples = false;
+	m_ctl_render_mix_samplerate = 0;
 	// init member variables that correspond to ctls
 	for ( const auto & ctl : ctls ) {
 		ctl_set( ctl.first, ctl.second, false );
@@ -474,10 +664,19 @@ void module_impl::load( const FileReader & file, const std::map< std::string, st
 		if ( m_ctl_load_skip_plugins ) {
 			load_flags &= ~(CSoundFile::loadPluginData | CSoundFile::loadPluginInstance);
 		}
+		if ( m_ctl_load_progressive && !file.HasFastGetLength() ) {
+			// only makes a difference for unseekable streams, where reading the sample data would require waiting for the whole file
+			load_flags |= CSoundFile::deferSampleData;
+		}
+		if ( m_ctl_load_metadata_only ) {
+			// Patterns are still created (without decoding their contents where the format allows) to keep pattern and channel counts
+			load_flags = CSoundFile::loadPatternData | CSoundFile::loadMetadataOnly;
+		}
 		if ( !m_sndFile->Create( file, static_cast<CSoundFile::ModLoadingFlags>( load_flags ) ) ) {
 			throw openmpt::exception("error loading file");
 		}
-		if ( !m_ctl_load_skip_subsongs_init ) {
+		m_loaded_metadata_only = m_ctl_load_metadata_only;
+		if ( !m_ctl_load_skip_subsongs_init && !m_loaded_metadata_only ) {
 			init_subsongs( m_subsongs );
 		}
 		m_loaded = true;
@@ -496,17 +695,43 @@ void module_impl::load( const FileReader & file, const std::map< std::string, st
 bool module_impl::is_loaded() const {
 	return m_loaded;
 }
-std::size_t module_impl::read_wrapper( std::size_t count, std::int16_t * left, std::int16_t * right, std::int16_t * rear_left, std::int16_t * rear_right ) {
+void module_impl::read_pending_sample_data() {
+	if ( m_sndFile->HasPendingSampleData() ) {
+		// Blocking stream I/O of at least 64 KiB per render call. Samples are always read completely, so a single large sample may exceed this amount.
+		// Voices using samples which have not arrived yet stay silent.
+		m_sndFile->ReadPendingSampleData( 64 * 1024 );
+	}
+}
+std::size_t module_impl::read_target( std::size_t count, IAudioReadTarget & target ) {
+	read_pending_sample_data();
 	m_sndFile->ResetMixStat();
 	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
 	std::size_t count_read = 0;
-	std::int16_t * const buffers[4] = { left, right, rear_left, rear_right };
-	AudioReadTargetGainBuffer<audio_buffer_planar<std::int16_t>> target( audio_buffer_planar<std::int16_t>( buffers, planar_audio_buffer_valid_channels( buffers, mpt::size( buffers) ), count ), *m_Dither, m_Gain );
 	while ( count > 0 ) {
-		std::size_t count_chunk = m_sndFile->Read(
-			static_cast<CSoundFile::samplecount_t>( std::min( static_cast<std::uint64_t>( count ), static_cast<std::uint64_t>( std::numeric_limits<CSoundFile::samplecount_t>::max() / 2 / 4 / 4 ) ) ), // safety margin / samplesize / channels
-			target
-			);
+		std::size_t count_chunk = 0;
+		if ( m_output_resampler ) {
+			count_chunk = m_output_resampler->process( count, target );
+			if ( count_chunk == 0 ) {
+				if ( m_output_resampler->get_input_samplerate() != static_cast<std::int32_t>( m_sndFile->m_MixerSettings.gdwMixingFreq ) ) {
+					// All frames mixed at the previous rate have been played, continue without resampling.
+					m_output_resampler = nullptr;
+					continue;
+				}
+				if ( m_sndFile->Read( static_cast<CSoundFile::samplecount_t>( m_output_resampler->get_required_input_frames( count ) ), *m_output_resampler ) == 0 ) {
+					// End of song, play the frames that are still held back as filter look-ahead.
+					if ( m_output_resampler->flush() ) {
+						continue;
+					}
+					break;
+				}
+				continue;
+			}
+		} else {
+			count_chunk = m_sndFile->Read(
+				static_cast<CSoundFile::samplecount_t>( std::min( static_cast<std::uint64_t>( count ), static_cast<std::uint64_t>( std::numeric_limits<CSoundFile::samplecount_t>::max() / 2 / 4 / 4 ) ) ), // safety margin / samplesize / channels
+				target
+				);
+		}
 		if ( count_chunk == 0 ) {
 			break;
 		}
@@ -519,72 +744,31 @@ std::size_t module_impl::read_wrapper( std::size_t count, std::int16_t * left, s
 	}
 	return count_read;
 }
+std::size_t module_impl::read_wrapper( std::size_t count, std::int16_t * left, std::int16_t * right, std::int16_t * rear_left, std::int16_t * rear_right ) {
+	std::int16_t * const buffers[4] = { left, right, rear_left, rear_right };
+	AudioReadTargetGainBuffer<audio_buffer_planar<std::int16_t>> target( audio_buffer_planar<std::int16_t>( buffers, planar_audio_buffer_valid_channels( buffers, mpt::size( buffers) ), count ), *m_Dither, m_Gain );
+	return read_target( count, target );
+}
 std::size_t module_impl::read_wrapper( std::size_t count, float * left, float * right, float * rear_left, float * rear_right ) {
-	m_sndFile->ResetMixStat();
-	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
-	std::size_t count_read = 0;
 	float * const buffers[4] = { left, right, rear_left, rear_right };
 	AudioReadTargetGainBuffer<audio_buffer_planar<float>> target( audio_buffer_planar<float>( buffers, planar_audio_buffer_valid_channels( buffers, mpt::size( buffers) ), count ), *m_Dither, m_Gain );
-	while ( count > 0 ) {
-		std::size_t count_chunk = m_sndFile->Read(
-			static_cast<CSoundFile::samplecount_t>( std::min( static_cast<std::uint64_t>( count ), static_cast<std::uint64_t>( std::numeric_limits<CSoundFile::samplecount_t>::max() / 2 / 4 / 4 ) ) ), // safety margin / samplesize / channels
-			target
-			);
-		if ( count_chunk == 0 ) {
-			break;
-		}
-		count -= count_chunk;
-		count_read += count_chunk;
-	}
-	if ( count_read == 0 && m_ctl_play_at_end == song_end_action::continue_song ) {
-		// This is the song end, but allow the song or loop to restart on the next call
-		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
-	}
-	return count_read;
+	return read_target( count, target );
 }
 std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_t channels, std::int16_t * interleaved ) {
-	m_sndFile->ResetMixStat();
-	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
-	std::size_t count_read = 0;
 	AudioReadTargetGainBuffer<audio_buffer_interleaved<std::int16_t>> target( audio_buffer_interleaved<std::int16_t>( interleaved, channels, count ), *m_Dither, m_Gain );
-	while ( count > 0 ) {
-		std::size_t count_chunk = m_sndFile->Read(
-			static_cast<CSoundFile::samplecount_t>( std::min( static_cast<std::uint64_t>( count ), static_cast<std::uint64_t>( std::numeric_limits<CSoundFile::samplecount_t>::max() / 2 / 4 / 4 ) ) ), // safety margin / samplesize / channels
-			target
-			);
-		if ( count_chunk == 0 ) {
-			break;
-		}
-		count -= count_chunk;
-		count_read += count_chunk;
-	}
-	if ( count_read == 0 && m_ctl_play_at_end == song_end_action::continue_song ) {
-		// This is the song end, but allow the song or loop to restart on the next call
-		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
-	}
-	return count_read;
+	return read_target( count, target );
 }
 std::size_t module_impl::read_interleaved_wrapper( std::size_t count, std::size_t channels, float * interleaved ) {
-	m_sndFile->ResetMixStat();
-	m_sndFile->m_bIsRendering = ( m_ctl_play_at_end != song_end_action::fadeout_song );
-	std::size_t count_read = 0;
 	AudioReadTargetGainBuffer<audio_buffer_interleaved<float>> target( audio_buffer_interleaved<float>( interleaved, channels, count ), *m_Dither, m_Gain );
-	while ( count > 0 ) {
-		std::size_t count_chunk = m_sndFile->Read(
-			static_cast<CSoundFile::samplecount_t>( std::min( static_cast<std::uint64_t>( count ), static_cast<std::uint64_t>( std::numeric_limits<CSoundFile::samplecount_t>::max() / 2 / 4 / 4 ) ) ), // safety margin / samplesize / channels
-			target
-			);
-		if ( count_chunk == 0 ) {
-			break;
-		}
-		count -= count_chunk;
-		count_read += count_chunk;
-	}
-	if ( count_read == 0 && m_ctl_play_at_end == song_end_action::continue_song ) {
-		// This is the song end, but allow the song or loop to restart on the next call
-		m_sndFile->m_SongFlags.reset(SONG_ENDREACHED);
-	}
-	return count_read;
+	return read_target( count, target );
+}
+std::size_t module_impl::read_interleaved_add_wrapper( std::size_t count, std::size_t channels, float * interleaved, float gain ) {
+	AudioReadTargetAccumulateBuffer<audio_buffer_interleaved<float>> target( audio_buffer_interleaved<float>( interleaved, channels, count ), m_Gain * gain );
+	return read_target( count, target );
+}
+std::size_t module_impl::read_stems_wrapper( std::size_t count, float * const * interleaved_stereo_stems ) {
+	AudioReadTargetStemBuffers target( interleaved_stereo_stems, m_sndFile->GetNumChannels(), m_Gain );
+	return read_target( count, target );
 }
 
 std::vector<std::string> module_impl::get_supported_extensions() {
@@ -823,6 +1007,21 @@ int module_impl::probe_file_header( std::uint64_t flags, callback_stream_wrapper
 	}
 	return result;
 }
+void module_impl::probe_file_headers_batch( std::uint64_t flags, std::size_t count, const void * const * data, const std::size_t * sizes, const std::uint64_t * filesizes, int * results ) {
+	if ( count == 0 ) {
+		return;
+	}
+	if ( !data || !sizes || !results ) {
+		throw openmpt::exception("null pointer");
+	}
+	for ( std::size_t i = 0; i < count; ++i ) {
+		if ( filesizes ) {
+			results[i] = probe_file_header( flags, data[i], sizes[i], filesizes[i] );
+		} else {
+			results[i] = probe_file_header( flags, data[i], sizes[i] );
+		}
+	}
+}
 module_impl::module_impl( callback_stream_wrapper stream, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls ) : m_Log(std::move(log)) {
 	ctor( ctls );
 	CallbackStream fstream;
@@ -1009,6 +1208,33 @@ std::size_t module_impl::read_interleaved_quad( std::int32_t samplerate, std::si
 	m_currentPositionSeconds += static_cast<double>( count ) / static_cast<double>( samplerate );
 	return count;
 }
+std::size_t module_impl::read_interleaved_stereo_add( std::int32_t samplerate, std::size_t count, float * interleaved_stereo, float gain ) {
+	if ( !interleaved_stereo ) {
+		throw openmpt::exception("null pointer");
+	}
+	apply_mixer_settings( samplerate, 2 );
+	count = read_interleaved_add_wrapper( count, 2, interleaved_stereo, gain );
+	m_currentPositionSeconds += static_cast<double>( count ) / static_cast<double>( samplerate );
+	return count;
+}
+std::size_t module_impl::read_interleaved_quad_add( std::int32_t samplerate, std::size_t count, float * interleaved_quad, float gain ) {
+	if ( !interleaved_quad ) {
+		throw openmpt::exception("null pointer");
+	}
+	apply_mixer_settings( samplerate, 4 );
+	count = read_interleaved_add_wrapper( count, 4, interleaved_quad, gain );
+	m_currentPositionSeconds += static_cast<double>( count ) / static_cast<double>( samplerate );
+	return count;
+}
+std::size_t module_impl::read_stems_interleaved_stereo( std::int32_t samplerate, std::size_t count, float * const * interleaved_stereo_stems ) {
+	if ( !interleaved_stereo_stems ) {
+		throw openmpt::exception("null pointer");
+	}
+	apply_mixer_settings( samplerate, 2, true );
+	count = read_stems_wrapper( count, interleaved_stereo_stems );
+	m_currentPositionSeconds += static_cast<double>( count ) / static_cast<double>( samplerate );
+	return count;
+}
 
 
 double module_impl::get_duration_seconds() const {
@@ -1037,6 +1263,7 @@ void module_impl::select_subsong( std::int32_t subsong ) {
 	}
 	m_sndFile->Order.SetSequence( static_cast<SEQUENCEINDEX>( subsongs[subsong].sequence ) );
 	set_position_order_row( subsongs[subsong].start_order, subsongs[subsong].start_row );
+	reset_output_resampler();
 	m_currentPositionSeconds = 0.0;
 }
 std::int32_t module_impl::get_selected_subsong() const {
@@ -1075,6 +1302,7 @@ double module_impl::set_position_seconds( double seconds ) {
 	m_sndFile->SetCurrentOrder( t.lastOrder );
 	m_sndFile->m_PlayState.m_nNextRow = t.lastRow;
 	m_currentPositionSeconds = base_seconds + m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( t.lastOrder, t.lastRow ).StartPos( static_cast<SEQUENCEINDEX>( subsong->sequence ), static_cast<ORDERINDEX>( subsong->start_order ), static_cast<ROWINDEX>( subsong->start_row ) ) ).back().duration;
+	reset_output_resampler();
 	return m_currentPositionSeconds;
 }
 double module_impl::set_position_order_row( std::int32_t order, std::int32_t row ) {
@@ -1093,6 +1321,7 @@ double module_impl::set_position_order_row( std::int32_t order, std::int32_t row
 	m_sndFile->SetCurrentOrder( static_cast<ORDERINDEX>( order ) );
 	m_sndFile->m_PlayState.m_nNextRow = static_cast<ROWINDEX>( row );
 	m_currentPositionSeconds = m_sndFile->GetLength( m_ctl_seek_sync_samples ? eAdjustSamplePositions : eAdjust, GetLengthTarget( static_cast<ORDERINDEX>( order ), static_cast<ROWINDEX>( row ) ) ).back().duration;
+	reset_output_resampler();
 	return m_currentPositionSeconds;
 }
 std::vector<std::string> module_impl::get_metadata_keys() const {
@@ -1369,6 +1598,32 @@ std::uint8_t module_impl::get_pattern_row_channel_command( std::int32_t p, std::
 	}
 	return 0;
 }
+std::int32_t module_impl::get_pattern_data( std::int32_t p, std::uint8_t * data, std::size_t size ) const {
+	if ( !data ) {
+		throw openmpt::exception("null pointer");
+	}
+	if ( !IsInRange( p, std::numeric_limits<PATTERNINDEX>::min(), std::numeric_limits<PATTERNINDEX>::max() ) || !m_sndFile->Patterns.IsValidPat( static_cast<PATTERNINDEX>( p ) ) ) {
+		return 0;
+	}
+	const CPattern &pattern = m_sndFile->Patterns[p];
+	const std::size_t row_size = static_cast<std::size_t>( pattern.GetNumChannels() ) * 6;
+	if ( row_size == 0 ) {
+		return 0;
+	}
+	const std::size_t rows = std::min( static_cast<std::size_t>( pattern.GetNumRows() ), size / row_size );
+	const ModCommand * cell = pattern.GetpModCommand( 0, 0 );
+	for ( std::size_t i = 0; i < rows * pattern.GetNumChannels(); ++i ) {
+		data[module::command_note] = cell->note;
+		data[module::command_instrument] = cell->instr;
+		data[module::command_volumeffect] = cell->volcmd;
+		data[module::command_effect] = cell->command;
+		data[module::command_volume] = cell->vol;
+		data[module::command_parameter] = cell->param;
+		data += 6;
+		cell++;
+	}
+	return static_cast<std::int32_t>( rows );
+}
 
 /*
 
@@ -1510,6 +1765,147 @@ std::string module_impl::highlight_pattern_row_channel( std::int32_t p, std::int
 	return format_and_highlight_pattern_row_channel( p, r, c, width, pad ).second;
 }
 
+namespace {
+// Formatted text and highlighting of the note column, indexed by the raw note value
+struct pattern_note_tables {
+	char text[256][3];
+	char high[256][3];
+	pattern_note_tables() {
+		for ( std::size_t note = 0; note < 256; ++note ) {
+			const ModCommand::NOTE n = static_cast<ModCommand::NOTE>( note );
+			const std::string name = ( ModCommand::IsNote( n ) || ModCommand::IsSpecialNote( n ) ) ? mpt::ToCharset( mpt::CharsetUTF8, CSoundFile::GetNoteName( n, NoteNamesSharp ) ) : std::string("...");
+			const char * highlight = ModCommand::IsNote( n ) ? "nnn" : ModCommand::IsSpecialNote( n ) ? "mmm" : "...";
+			for ( std::size_t i = 0; i < 3; ++i ) {
+				text[note][i] = ( i < name.length() ) ? name[i] : ' ';
+				high[note][i] = highlight[i];
+			}
+		}
+	}
+};
+} // namespace
+
+static const pattern_note_tables & get_pattern_note_tables() {
+	static const pattern_note_tables tables;
+	return tables;
+}
+
+static inline void format_pattern_hex( char * dst, unsigned int value, std::size_t digits ) {
+	static const char hex[] = "0123456789ABCDEF";
+	for ( std::size_t i = digits; i > 0; --i ) {
+		dst[i - 1] = hex[value & 0x0f];
+		value >>= 4;
+	}
+}
+
+static const std::size_t pattern_cell_width = 13;
+
+// Writes exactly width characters, equivalent to format_and_highlight_pattern_row_channel( p, r, c, width, true ).
+void module_impl::format_pattern_cell( std::int32_t p, std::int32_t r, std::int32_t c, const ModCommand & cell, std::size_t width, char * text, char * high ) const {
+	if ( cell.IsNote() && m_sndFile->GetType() == MOD_TYPE_MPT && cell.instr >= 1 && cell.instr <= m_sndFile->GetNumInstruments() && m_sndFile->Instruments[cell.instr] && m_sndFile->Instruments[cell.instr]->pTuning ) {
+		// Note names of custom tunings have arbitrary length, use the generic code path.
+		const std::pair< std::string, std::string > formatted = format_and_highlight_pattern_row_channel( p, r, c, width, true );
+		std::memcpy( text, formatted.first.data(), width );
+		if ( high ) {
+			std::memcpy( high, formatted.second.data(), width );
+		}
+		return;
+	}
+	//  0000000001111
+	//  1234567890123
+	// "NNN IIvVV EFF"
+	char t[pattern_cell_width];
+	char h[pattern_cell_width];
+	const pattern_note_tables & notes = get_pattern_note_tables();
+	std::memcpy( t, notes.text[cell.note], 3 );
+	std::memcpy( h, notes.high[cell.note], 3 );
+	std::size_t length = 3;
+	if ( width >= 6 ) {
+		t[3] = ' ';
+		h[3] = ' ';
+		if ( cell.instr ) {
+			format_pattern_hex( t + 4, cell.instr, 2 );
+			std::memcpy( h + 4, "ii", 2 );
+		} else {
+			std::memcpy( t + 4, "..", 2 );
+			std::memcpy( h + 4, "..", 2 );
+		}
+		length = 6;
+	}
+	if ( width >= 9 ) {
+		if ( cell.IsPcNote() ) {
+			t[6] = ' ';
+			format_pattern_hex( t + 7, cell.GetValueVolCol() & 0xff, 2 );
+			std::memcpy( h + 6, " vv", 3 );
+		} else if ( cell.volcmd != VOLCMD_NONE ) {
+			t[6] = m_sndFile->GetModSpecifications().GetVolEffectLetter( cell.volcmd );
+			format_pattern_hex( t + 7, cell.vol, 2 );
+			std::memcpy( h + 6, "uvv", 3 );
+		} else {
+			std::memcpy( t + 6, " ..", 3 );
+			std::memcpy( h + 6, " ..", 3 );
+		}
+		length = 9;
+	}
+	if ( width >= 13 ) {
+		t[9] = ' ';
+		h[9] = ' ';
+		if ( cell.IsPcNote() ) {
+			format_pattern_hex( t + 10, cell.GetValueEffectCol() & 0x0fff, 3 );
+			std::memcpy( h + 10, "eff", 3 );
+		} else if ( cell.command != CMD_NONE ) {
+			t[10] = m_sndFile->GetModSpecifications().GetEffectLetter( cell.command );
+			format_pattern_hex( t + 11, cell.param, 2 );
+			std::memcpy( h + 10, "eff", 3 );
+		} else {
+			std::memcpy( t + 10, "...", 3 );
+			std::memcpy( h + 10, "...", 3 );
+		}
+		length = 13;
+	}
+	length = std::min( length, width );
+	std::memcpy( text, t, length );
+	std::memset( text + length, ' ', width - length );
+	if ( high ) {
+		std::memcpy( high, h, length );
+		std::memset( high + length, ' ', width - length );
+	}
+}
+
+void module_impl::format_pattern_window( std::int32_t p, std::int32_t first_row, std::int32_t rows, std::int32_t first_channel, std::int32_t channels, std::size_t width, char * text, char * high ) const {
+	if ( !text ) {
+		throw openmpt::exception("null pointer");
+	}
+	if ( rows < 0 || channels < 0 ) {
+		throw openmpt::exception("invalid pattern window");
+	}
+	if ( width == 0 ) {
+		width = pattern_cell_width;
+	}
+	const CPattern * pattern = nullptr;
+	if ( IsInRange( p, std::numeric_limits<PATTERNINDEX>::min(), std::numeric_limits<PATTERNINDEX>::max() ) && m_sndFile->Patterns.IsValidPat( static_cast<PATTERNINDEX>( p ) ) ) {
+		pattern = &m_sndFile->Patterns[p];
+	}
+	const std::int64_t num_rows = pattern ? static_cast<std::int64_t>( pattern->GetNumRows() ) : 0;
+	const std::int64_t num_channels = m_sndFile->GetNumChannels();
+	for ( std::int32_t y = 0; y < rows; ++y ) {
+		const std::int64_t r = static_cast<std::int64_t>( first_row ) + y;
+		for ( std::int32_t x = 0; x < channels; ++x ) {
+			const std::int64_t c = static_cast<std::int64_t>( first_channel ) + x;
+			const std::size_t offset = ( static_cast<std::size_t>( y ) * static_cast<std::size_t>( channels ) + static_cast<std::size_t>( x ) ) * width;
+			char * cell_high = high ? high + offset : nullptr;
+			if ( r < 0 || r >= num_rows || c < 0 || c >= num_channels ) {
+				std::memset( text + offset, ' ', width );
+				if ( cell_high ) {
+					std::memset( cell_high, ' ', width );
+				}
+				continue;
+			}
+			const ModCommand & cell = *pattern->GetpModCommand( static_cast<ROWINDEX>( r ), static_cast<CHANNELINDEX>( c ) );
+			format_pattern_cell( p, static_cast<std::int32_t>( r ), static_cast<std::int32_t>( c ), cell, width, text + offset, cell_high );
+		}
+	}
+}
+
 std::vector<std::string> module_impl::get_ctls() const {
 	return
 	{
@@ -1517,13 +1913,23 @@ std::vector<std::string> module_impl::get_ctls() const {
 		"load.skip_patterns",
 		"load.skip_plugins",
 		"load.skip_subsongs_init",
+		"load.progressive",
+		"load.metadata_only",
 		"seek.sync_samples",
 		"subsong",
 		"play.tempo_factor",
 		"play.pitch_factor",
 		"play.at_end",
 		"render.resampler.emulate_amiga",
+		"render.resampler.sample_pyramids",
 		"render.opl.volume_factor",
+		"render.reverb.half_rate",
+		"render.reverb.float",
+		"render.mix_samplerate",
+		"render.plugin_threads",
+		"render.statistics.ramp_frames",
+		"render.statistics.noramp_frames",
+		"render.statistics.multivoice_frames",
 		"dither",
 	};
 }
@@ -1551,6 +1957,10 @@ std::string module_impl::ctl_get( std::string ctl, bool throw_if_unknown ) const
 		return mpt::fmt::val( m_ctl_load_skip_plugins );
 	} else if ( ctl == "load.skip_subsongs_init" ) {
 		return mpt::fmt::val( m_ctl_load_skip_subsongs_init );
+	} else if ( ctl == "load.progressive" ) {
+		return mpt::fmt::val( m_ctl_load_progressive );
+	} else if ( ctl == "load.metadata_only" ) {
+		return mpt::fmt::val( m_ctl_load_metadata_only );
 	} else if ( ctl == "seek.sync_samples" ) {
 		return mpt::fmt::val( m_ctl_seek_sync_samples );
 	} else if ( ctl == "subsong" ) {
@@ -1579,8 +1989,32 @@ std::string module_impl::ctl_get( std::string ctl, bool throw_if_unknown ) const
 		return mpt::fmt::val( m_sndFile->m_nFreqFactor / 65536.0 );
 	} else if ( ctl == "render.resampler.emulate_amiga" ) {
 		return mpt::fmt::val( m_sndFile->m_Resampler.m_Settings.emulateAmiga );
+	} else if ( ctl == "render.resampler.sample_pyramids" ) {
+		return mpt::fmt::val( m_sndFile->m_Resampler.m_Settings.samplePyramids );
 	} else if ( ctl == "render.opl.volume_factor" ) {
 		return mpt::fmt::val( static_cast<double>( m_sndFile->m_OPLVolumeFactor ) / static_cast<double>( m_sndFile->m_OPLVolumeFactorScale ) );
+	} else if ( ctl == "render.reverb.half_rate" ) {
+#ifndef NO_REVERB
+		return mpt::fmt::val( m_sndFile->m_Reverb.m_Settings.m_halfRate );
+#else
+		return mpt::fmt::val( false );
+#endif
+	} else if ( ctl == "render.reverb.float" ) {
+#ifndef NO_REVERB
+		return mpt::fmt::val( m_sndFile->m_Reverb.m_Settings.m_floatProcessing );
+#else
+		return mpt::fmt::val( false );
+#endif
+	} else if ( ctl == "render.mix_samplerate" ) {
+		return mpt::fmt::val( m_ctl_render_mix_samplerate );
+	} else if ( ctl == "render.plugin_threads" ) {
+		return mpt::fmt::val( m_sndFile->GetNumPluginThreads() );
+	} else if ( ctl == "render.statistics.ramp_frames" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerStatistics.rampFrames );
+	} else if ( ctl == "render.statistics.noramp_frames" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerStatistics.noRampFrames );
+	} else if ( ctl == "render.statistics.multivoice_frames" ) {
+		return mpt::fmt::val( m_sndFile->m_MixerStatistics.multiVoiceFrames );
 	} else if ( ctl == "dither" ) {
 		return mpt::fmt::val( static_cast<int>( m_Dither->GetMode() ) );
 	} else {
@@ -1615,6 +2049,10 @@ void module_impl::ctl_set( std::string ctl, const std::string & value, bool thro
 		m_ctl_load_skip_plugins = ConvertStrTo<bool>( value );
 	} else if ( ctl == "load.skip_subsongs_init" ) {
 		m_ctl_load_skip_subsongs_init = ConvertStrTo<bool>( value );
+	} else if ( ctl == "load.progressive" ) {
+		m_ctl_load_progressive = ConvertStrTo<bool>( value );
+	} else if ( ctl == "load.metadata_only" ) {
+		m_ctl_load_metadata_only = ConvertStrTo<bool>( value );
 	} else if ( ctl == "seek.sync_samples" ) {
 		m_ctl_seek_sync_samples = ConvertStrTo<bool>( value );
 	} else if ( ctl == "subsong" ) {
@@ -1655,8 +2093,48 @@ void module_impl::ctl_set( std::string ctl, const std::string & value, bool thro
 		if ( newsettings != m_sndFile->m_Resampler.m_Settings ) {
 			m_sndFile->SetResamplerSettings( newsettings );
 		}
+	} else if ( ctl == "render.resampler.sample_pyramids" ) {
+		CResamplerSettings newsettings = m_sndFile->m_Resampler.m_Settings;
+		newsettings.samplePyramids = ConvertStrTo<bool>( value );
+		if ( newsettings != m_sndFile->m_Resampler.m_Settings ) {
+			m_sndFile->SetResamplerSettings( newsettings );
+		}
 	} else if ( ctl == "render.opl.volume_factor" ) {
 		m_sndFile->m_OPLVolumeFactor = mpt::saturate_round<int32>( ConvertStrTo<double>( value ) * static_cast<double>( m_sndFile->m_OPLVolumeFactorScale ) );
+	} else if ( ctl == "render.reverb.half_rate" ) {
+#ifndef NO_REVERB
+		m_sndFile->m_Reverb.m_Settings.m_halfRate = ConvertStrTo<bool>( value );
+		m_sndFile->m_Reverb.Initialize( false, m_sndFile->m_MixerSettings.gdwMixingFreq );
+#endif
+	} else if ( ctl == "render.reverb.float" ) {
+#ifndef NO_REVERB
+		m_sndFile->m_Reverb.m_Settings.m_floatProcessing = ConvertStrTo<bool>( value );
+		m_sndFile->m_Reverb.Initialize( false, m_sndFile->m_MixerSettings.gdwMixingFreq );
+#endif
+	} else if ( ctl == "render.mix_samplerate" ) {
+		std::int32_t mix_samplerate = ConvertStrTo<std::int32_t>( value );
+		if ( mix_samplerate != 0 && ( mix_samplerate < 8000 || mix_samplerate > 192000 ) ) {
+			throw openmpt::exception("invalid mix sample rate");
+		}
+		// takes effect with the next read call
+		m_ctl_render_mix_samplerate = mix_samplerate;
+	} else if ( ctl == "render.plugin_threads" ) {
+		std::int32_t threads = ConvertStrTo<std::int32_t>( value );
+		if ( threads < 0 || threads > 16 ) {
+			throw openmpt::exception("invalid number of plugin threads");
+		}
+		m_sndFile->SetNumPluginThreads( threads );
+	} else if ( ctl == "render.statistics.ramp_frames" || ctl == "render.statistics.noramp_frames" || ctl == "render.statistics.multivoice_frames" ) {
+		if ( value != "0" ) {
+			throw openmpt::exception("statistics can only be reset to 0");
+		}
+		if ( ctl == "render.statistics.ramp_frames" ) {
+			m_sndFile->m_MixerStatistics.rampFrames = 0;
+		} else if ( ctl == "render.statistics.noramp_frames" ) {
+			m_sndFile->m_MixerStatistics.noRampFrames = 0;
+		} else {
+			m_sndFile->m_MixerStatistics.multiVoiceFrames = 0;
+		}
 	} else if ( ctl == "dither" ) {
 		int dither = ConvertStrTo<int>( value );
 		if ( dither < 0 || dither >= NumDitherModes ) {
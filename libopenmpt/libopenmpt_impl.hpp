@@ -31,6 +31,8 @@ class FileReader;
 } // namespace detail
 typedef detail::FileReader<FileReaderTraitsDefault> FileReader;
 class CSoundFile;
+class ModCommand;
+class IAudioReadTarget;
 template <std::size_t channels> class DitherChannels;
 using Dither = DitherChannels<4>;
 } // namespace OpenMPT
@@ -64,6 +66,8 @@ public:
 
 class log_forwarder;
 
+class output_resampler;
+
 struct callback_stream_wrapper {
 	void * stream;
 	std::size_t (*read)( void * stream, void * dst, std::size_t bytes );
@@ -97,8 +101,10 @@ protected:
 	double m_currentPositionSeconds;
 	std::unique_ptr<OpenMPT::CSoundFile> m_sndFile;
 	bool m_loaded;
+	bool m_loaded_metadata_only;
 	bool m_mixer_initialized;
 	std::unique_ptr<OpenMPT::Dither> m_Dither;
+	std::unique_ptr<output_resampler> m_output_resampler;
 	subsongs_type m_subsongs;
 	float m_Gain;
 	song_end_action m_ctl_play_at_end;
@@ -106,14 +112,18 @@ protected:
 	bool m_ctl_load_skip_patterns;
 	bool m_ctl_load_skip_plugins;
 	bool m_ctl_load_skip_subsongs_init;
+	bool m_ctl_load_progressive;
+	bool m_ctl_load_metadata_only;
 	bool m_ctl_seek_sync_samples;
+	std::int32_t m_ctl_render_mix_samplerate;
 	std::vector<std::string> m_loaderMessages;
 public:
 	void PushToCSoundFileLog( const std::string & text ) const;
 	void PushToCSoundFileLog( int loglevel, const std::string & text ) const;
 protected:
 	std::string mod_string_to_utf8( const std::string & encoded ) const;
-	void apply_mixer_settings( std::int32_t samplerate, int channels );
+	void apply_mixer_settings( std::int32_t samplerate, int channels, bool stems = false );
+	void reset_output_resampler();
 	void apply_libopenmpt_defaults();
 	subsongs_type get_subsongs() const;
 	void init_subsongs( subsongs_type & subsongs ) const;
@@ -121,12 +131,17 @@ protected:
 	void ctor( const std::map< std::string, std::string > & ctls );
 	void load( const OpenMPT::FileReader & file, const std::map< std::string, std::string > & ctls );
 	bool is_loaded() const;
+	void read_pending_sample_data();
+	std::size_t read_target( std::size_t count, OpenMPT::IAudioReadTarget & target );
 	std::size_t read_wrapper( std::size_t count, std::int16_t * left, std::int16_t * right, std::int16_t * rear_left, std::int16_t * rear_right );
 	std::size_t read_wrapper( std::size_t count, float * left, float * right, float * rear_left, float * rear_right );
 	std::size_t read_interleaved_wrapper( std::size_t count, std::size_t channels, std::int16_t * interleaved );
 	std::size_t read_interleaved_wrapper( std::size_t count, std::size_t channels, float * interleaved );
+	std::size_t read_interleaved_add_wrapper( std::size_t count, std::size_t channels, float * interleaved, float gain );
+	std::size_t read_stems_wrapper( std::size_t count, float * const * interleaved_stereo_stems );
 	std::pair< std::string, std::string > format_and_highlight_pattern_row_channel_command( std::int32_t p, std::int32_t r, std::int32_t c, int command ) const;
 	std::pair< std::string, std::string > format_and_highlight_pattern_row_channel( std::int32_t p, std::int32_t r, std::int32_t c, std::size_t width, bool pad ) const;
+	void format_pattern_cell( std::int32_t p, std::int32_t r, std::int32_t c, const OpenMPT::ModCommand & cell, std::size_t width, char * text, char * high ) const;
 	static double could_open_probability( const OpenMPT::FileReader & file, double effort, std::unique_ptr<log_interface> log );
 public:
 	static std::vector<std::string> get_supported_extensions();
@@ -141,6 +156,7 @@ public:
 	static int probe_file_header( std::uint64_t flags, const void * data, std::size_t size );
 	static int probe_file_header( std::uint64_t flags, std::istream & stream );
 	static int probe_file_header( std::uint64_t flags, callback_stream_wrapper stream );
+	static void probe_file_headers_batch( std::uint64_t flags, std::size_t count, const void * const * data, const std::size_t * sizes, const std::uint64_t * filesizes, int * results );
 	module_impl( callback_stream_wrapper stream, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( std::istream & stream, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
 	module_impl( const std::vector<std::uint8_t> & data, std::unique_ptr<log_interface> log, const std::map< std::string, std::string > & ctls );
@@ -170,6 +186,9 @@ public:
 	std::size_t read_interleaved_quad( std::int32_t samplerate, std::size_t count, std::int16_t * interleaved_quad );
 	std::size_t read_interleaved_stereo( std::int32_t samplerate, std::size_t count, float * interleaved_stereo );
 	std::size_t read_interleaved_quad( std::int32_t samplerate, std::size_t count, float * interleaved_quad );
+	std::size_t read_interleaved_stereo_add( std::int32_t samplerate, std::size_t count, float * interleaved_stereo, float gain );
+	std::size_t read_interleaved_quad_add( std::int32_t samplerate, std::size_t count, float * interleaved_quad, float gain );
+	std::size_t read_stems_interleaved_stereo( std::int32_t samplerate, std::size_t count, float * const * interleaved_stereo_stems );
 	std::vector<std::string> get_metadata_keys() const;
 	std::string get_metadata( const std::string & key ) const;
 	std::int32_t get_current_speed() const;
@@ -198,10 +217,12 @@ public:
 	std::int32_t get_order_pattern( std::int32_t o ) const;
 	std::int32_t get_pattern_num_rows( std::int32_t p ) const;
 	std::uint8_t get_pattern_row_channel_command( std::int32_t p, std::int32_t r, std::int32_t c, int cmd ) const;
+	std::int32_t get_pattern_data( std::int32_t p, std::uint8_t * data, std::size_t size ) const;
 	std::string format_pattern_row_channel_command( std::int32_t p, std::int32_t r, std::int32_t c, int cmd ) const;
 	std::string highlight_pattern_row_channel_command( std::int32_t p, std::int32_t r, std::int32_t c, int cmd ) const;
 	std::string format_pattern_row_channel( std::int32_t p, std::int32_t r, std::int32_t c, std::size_t width, bool pad ) const;
 	std::string highlight_pattern_row_channel( std::int32_t p, std::int32_t r, std::int32_t c, std::size_t width, bool pad ) const;
+	void format_pattern_window( std::int32_t p, std::int32_t first_row, std::int32_t rows, std::int32_t first_channel, std::int32_t channels, std::size_t width, char * text, char * high ) const;
 	std::vector<std::string> get_ctls() const;
 	std::string ctl_get( std::string ctl, bool throw_if_unknown = true ) const;
 	void ctl_set( std::string ctl, const std::string & value, bool throw_if_unknown = true );
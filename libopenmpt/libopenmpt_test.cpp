@@ -7,14 +7,17 @@
  * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
  */
 
-#include "BuildSettings.h"
+#include "common/stdafx.h"
 
 #include "libopenmpt_internal.h"
 
+#include "common/mptPathString.h"
 #include "test/test.h"
 
 #include <iostream>
 #include <locale>
+#include <string>
+#include <vector>
 
 #include <clocale>
 #include <cstdlib>
@@ -28,11 +31,33 @@ using namespace OpenMPT;
 // mingw-w64 g++ does only default to special C linkage for "main", but not for "wmain" (see <https://sourceforge.net/p/mingw-w64/wiki2/Unicode%20apps/>).
 extern "C"
 #endif
-int wmain( int /*argc*/ , wchar_t * /*argv*/ [] ) {
+int wmain( int argc, wchar_t * argv [] ) {
+	const bool benchmark = ( argc > 1 && std::wstring( argv[1] ) == L"--benchmark" );
+	const bool generate_resampler_tables = ( argc > 1 && std::wstring( argv[1] ) == L"--generate-resampler-tables" );
 #else
-int main( int /*argc*/ , char * /*argv*/ [] ) {
+int main( int argc, char * argv [] ) {
+	const bool benchmark = ( argc > 1 && std::string( argv[1] ) == "--benchmark" );
+	const bool generate_resampler_tables = ( argc > 1 && std::string( argv[1] ) == "--generate-resampler-tables" );
 #endif
 	try {
+
+		if ( benchmark ) {
+			std::vector<mpt::PathString> files;
+			for ( int i = 2; i < argc; ++i ) {
+				files.push_back( mpt::PathString::FromNative( argv[i] ) );
+			}
+			Test::DoBenchmarks( files );
+			return 0;
+		}
+
+		if ( generate_resampler_tables ) {
+			// libopenmpt_test --generate-resampler-tables > soundlib/ResamplerTables.h
+			if ( !Test::GenerateResamplerTables( std::cout ) ) {
+				std::cerr << "This build does not use pre-computed resampler tables." << std::endl;
+				return 1;
+			}
+			return 0;
+		}
 	
 		// run test with "C" / classic() locale
 		Test::DoTests();
@@ -1962,7 +1962,7 @@ void CCtrlSamples::ApplyResample(uint32 newRate, ResamplingMode mode)
 			uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(mode);
 			if(sample.uFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
 			if(sample.uFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
-			ModChannel chn{};
+			MixVoice chn{};
 			chn.pCurrentSample = sample.samplev();
 			chn.increment = SamplePosition::Ratio(oldRate, newRate);
 			chn.position.Set(selection.nStart);
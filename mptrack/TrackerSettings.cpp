@@ -345,6 +345,8 @@ TrackerSettings::TrackerSettings(SettingsContainer &conf)
 #ifndef NO_REVERB
 	m_ReverbSettings.m_nReverbDepth = conf.Read<int32>(U_("Effects"), U_("ReverbDepth"), m_ReverbSettings.m_nReverbDepth);
 	m_ReverbSettings.m_nReverbType = conf.Read<int32>(U_("Effects"), U_("ReverbType"), m_ReverbSettings.m_nReverbType);
+	m_ReverbSettings.m_halfRate = conf.Read<bool>(U_("Effects"), U_("ReverbHalfRate"), m_ReverbSettings.m_halfRate);
+	m_ReverbSettings.m_floatProcessing = conf.Read<bool>(U_("Effects"), U_("ReverbFloat"), m_ReverbSettings.m_floatProcessing);
 #endif
 #ifndef NO_DSP
 	m_SurroundSettings.m_nProLogicDepth = conf.Read<int32>(U_("Effects"), U_("ProLogicDepth"), m_SurroundSettings.m_nProLogicDepth);
@@ -1130,6 +1132,8 @@ void TrackerSettings::SaveSettings()
 #ifndef NO_REVERB
 	conf.Write<int32>(U_("Effects"), U_("ReverbDepth"), m_ReverbSettings.m_nReverbDepth);
 	conf.Write<int32>(U_("Effects"), U_("ReverbType"), m_ReverbSettings.m_nReverbType);
+	conf.Write<bool>(U_("Effects"), U_("ReverbHalfRate"), m_ReverbSettings.m_halfRate);
+	conf.Write<bool>(U_("Effects"), U_("ReverbFloat"), m_ReverbSettings.m_floatProcessing);
 #endif
 #ifndef NO_DSP
 	conf.Write<int32>(U_("Effects"), U_("ProLogicDepth"), m_SurroundSettings.m_nProLogicDepth);
@@ -78,8 +78,20 @@ void CopyInterleavedSampleStreams(typename SampleConversion::output_t * MPT_REST
 }
 
 
-template<int fractionalBits, bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither>
-void ConvertBufferMixFixedToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count)
+// Gain functor that leaves the samples untouched (see ConvertBufferMixFixedToBuffer and ConvertBufferMixFloatToBuffer).
+struct NoGain
+{
+	template <typename T>
+	MPT_FORCEINLINE T operator()(T sample) const
+	{
+		return sample;
+	}
+};
+
+
+// preGain is applied to the mix buffer samples before dithering, postGain to the converted output samples.
+template<int fractionalBits, bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither, typename TpreGain, typename TpostGain>
+void ConvertBufferMixFixedToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count, TpreGain preGain, TpostGain postGain)
 {
 	using TOutSample = typename std::remove_const<typename TOutBuf::sample_type>::type;
 	using TInSample = typename std::remove_const<typename TInBuf::sample_type>::type;
@@ -96,12 +108,19 @@ void ConvertBufferMixFixedToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dithe
 	{
 		for(std::size_t channel = 0; channel < channels; ++channel)
 		{
-			outBuf(channel, i) = conv(clip(dither.template process<ditherBits>(channel, inBuf(channel, i))));
+			outBuf(channel, i) = postGain(conv(clip(dither.template process<ditherBits>(channel, preGain(inBuf(channel, i))))));
 		}
 	}
 }
 
 
+template<int fractionalBits, bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither>
+void ConvertBufferMixFixedToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count)
+{
+	ConvertBufferMixFixedToBuffer<fractionalBits, clipOutput>(outBuf, inBuf, dither, channels, count, NoGain(), NoGain());
+}
+
+
 template<int fractionalBits, typename TOutBuf, typename TInBuf>
 void ConvertBufferToBufferMixFixed(TOutBuf outBuf, TInBuf inBuf, std::size_t channels, std::size_t count)
 {
@@ -122,8 +141,9 @@ void ConvertBufferToBufferMixFixed(TOutBuf outBuf, TInBuf inBuf, std::size_t cha
 }
 
 
-template<bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither>
-void ConvertBufferMixFloatToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count)
+// preGain is applied to the mix buffer samples before dithering.
+template<bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither, typename TpreGain>
+void ConvertBufferMixFloatToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count, TpreGain preGain)
 {
 	using TOutSample = typename std::remove_const<typename TOutBuf::sample_type>::type;
 	using TInSample = typename std::remove_const<typename TInBuf::sample_type>::type;
@@ -140,12 +160,19 @@ void ConvertBufferMixFloatToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dithe
 	{
 		for(std::size_t channel = 0; channel < channels; ++channel)
 		{
-			outBuf(channel, i) = conv(clip(dither.template process<ditherBits>(channel, inBuf(channel, i))));
+			outBuf(channel, i) = conv(clip(dither.template process<ditherBits>(channel, preGain(inBuf(channel, i)))));
 		}
 	}
 }
 
 
+template<bool clipOutput, typename TOutBuf, typename TInBuf, typename Tdither>
+void ConvertBufferMixFloatToBuffer(TOutBuf outBuf, TInBuf inBuf, Tdither & dither, std::size_t channels, std::size_t count)
+{
+	ConvertBufferMixFloatToBuffer<clipOutput>(outBuf, inBuf, dither, channels, count, NoGain());
+}
+
+
 template<typename TOutBuf, typename TInBuf>
 void ConvertBufferToBufferMixFloat(TOutBuf outBuf, TInBuf inBuf, std::size_t channels, std::size_t count)
 {
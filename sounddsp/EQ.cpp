@@ -216,35 +216,127 @@ done:;
 
 #endif
 
-static void EQFilter(EQBANDSTRUCT *pbs, float32 *pbuffer, UINT nCount)
+static MPT_FORCEINLINE bool IsActiveEQBand(const EQBANDSTRUCT &band)
 {
-	for (UINT i=0; i<nCount; i++)
-	{
-		float32 x = pbuffer[i];
-		float32 y = pbs->a1 * pbs->x1 + pbs->a2 * pbs->x2 + pbs->a0 * x + pbs->b1 * pbs->y1 + pbs->b2 * pbs->y2;
-		pbs->x2 = pbs->x1;
-		pbs->y2 = pbs->y1;
-		pbs->x1 = x;
-		pbuffer[i] = y;
-		pbs->y1 = y;
-	}
+	return band.bEnable && band.Gain != 1.0f;
 }
 
 
-void CEQ::ProcessMono(int *pbuffer, float *MixFloatBuffer, UINT nCount)
+// Runs all active bands of one or more interleaved buffers in a single pass.
+// Each channel is a lane (lane c uses the bands starting at laneBands[c], and lanes
+// are numbered through the buffers in order), and a band is evaluated for all lanes
+// side by side, so that the filter state of the whole cascade stays local and the
+// compiler is free to vectorize across lanes.
+// A lane whose band is inactive while another lane's band is active runs an identity
+// filter instead, which leaves its samples untouched.
+template<UINT numBuffers, UINT stride>
+static void EQFilterCascade(EQBANDSTRUCT * const (&laneBands)[numBuffers * stride], float32 * const (&buffers)[numBuffers], UINT nCount)
 {
-	MonoMixToFloat(pbuffer, MixFloatBuffer, nCount, 1.0f/MIXING_SCALEF);
-	for (UINT b=0; b<MAX_EQ_BANDS; b++)
+	static const UINT channels = numBuffers * stride;
+	struct BandLanes
 	{
-		#ifdef ENABLE_X86
-			if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
+		float32 a0[channels], a1[channels], a2[channels], b1[channels], b2[channels];
+		float32 x1[channels], x2[channels], y1[channels], y2[channels];
+	};
+
+	BandLanes cascade[MAX_EQ_BANDS];
+	UINT bandIndex[MAX_EQ_BANDS];
+	UINT numBands = 0;
+	for(UINT b = 0; b < MAX_EQ_BANDS; b++)
+	{
+		bool active = false;
+		for(UINT c = 0; c < channels; c++)
+		{
+			active |= IsActiveEQBand(laneBands[c][b]);
+		}
+		if(!active)
+		{
+			continue;
+		}
+		BandLanes &lanes = cascade[numBands];
+		for(UINT c = 0; c < channels; c++)
+		{
+			const EQBANDSTRUCT &band = laneBands[c][b];
+			if(IsActiveEQBand(band))
 			{
-				if ((gEQ[b].bEnable) && (gEQ[b].Gain != 1.0f)) X86_EQFilter(&gEQ[b], MixFloatBuffer, nCount);
+				lanes.a0[c] = band.a0; lanes.a1[c] = band.a1; lanes.a2[c] = band.a2;
+				lanes.b1[c] = band.b1; lanes.b2[c] = band.b2;
+				lanes.x1[c] = band.x1; lanes.x2[c] = band.x2;
+				lanes.y1[c] = band.y1; lanes.y2[c] = band.y2;
 			} else
-		#endif // ENABLE_X86
 			{
-				if ((gEQ[b].bEnable) && (gEQ[b].Gain != 1.0f)) EQFilter(&gEQ[b], MixFloatBuffer, nCount);
+				lanes.a0[c] = 1; lanes.a1[c] = 0; lanes.a2[c] = 0;
+				lanes.b1[c] = 0; lanes.b2[c] = 0;
+				lanes.x1[c] = 0; lanes.x2[c] = 0;
+				lanes.y1[c] = 0; lanes.y2[c] = 0;
+			}
+		}
+		bandIndex[numBands++] = b;
+	}
+	if(!numBands)
+	{
+		return;
+	}
+
+	for(UINT i = 0; i < nCount; i++)
+	{
+		float32 x[channels];
+		for(UINT c = 0; c < channels; c++)
+		{
+			x[c] = buffers[c / stride][i * stride + c % stride];
+		}
+		for(UINT n = 0; n < numBands; n++)
+		{
+			BandLanes &lanes = cascade[n];
+			for(UINT c = 0; c < channels; c++)
+			{
+				// Same evaluation order as the per-band filter, so that results do not change (unless the compiler reorders floating-point math).
+				float32 y = lanes.a1[c] * lanes.x1[c] + lanes.a2[c] * lanes.x2[c] + lanes.a0[c] * x[c] + lanes.b1[c] * lanes.y1[c] + lanes.b2[c] * lanes.y2[c];
+				lanes.x2[c] = lanes.x1[c];
+				lanes.y2[c] = lanes.y1[c];
+				lanes.x1[c] = x[c];
+				lanes.y1[c] = y;
+				x[c] = y;
+			}
+		}
+		for(UINT c = 0; c < channels; c++)
+		{
+			buffers[c / stride][i * stride + c % stride] = x[c];
+		}
+	}
+
+	for(UINT n = 0; n < numBands; n++)
+	{
+		const BandLanes &lanes = cascade[n];
+		for(UINT c = 0; c < channels; c++)
+		{
+			EQBANDSTRUCT &band = laneBands[c][bandIndex[n]];
+			if(IsActiveEQBand(band))
+			{
+				band.x1 = lanes.x1[c]; band.x2 = lanes.x2[c];
+				band.y1 = lanes.y1[c]; band.y2 = lanes.y2[c];
 			}
+		}
+	}
+}
+
+
+void CEQ::ProcessMono(int *pbuffer, float *MixFloatBuffer, UINT nCount)
+{
+	MonoMixToFloat(pbuffer, MixFloatBuffer, nCount, 1.0f/MIXING_SCALEF);
+#ifdef ENABLE_X86
+	if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
+	{
+		for (UINT b=0; b<MAX_EQ_BANDS; b++)
+		{
+			if ((gEQ[b].bEnable) && (gEQ[b].Gain != 1.0f)) X86_EQFilter(&gEQ[b], MixFloatBuffer, nCount);
+		}
+	} else
+#endif // ENABLE_X86
+	{
+		EQBANDSTRUCT * const laneBands[1] = { gEQ };
+		float32 * const buffers[1] = { MixFloatBuffer };
+		EQFilterCascade<1, 1>(laneBands, buffers, nCount);
 	}
 	FloatToMonoMix(MixFloatBuffer, pbuffer, nCount, MIXING_SCALEF);
 }
@@ -298,18 +390,12 @@ void CEQ::ProcessStereo(int *pbuffer, float *MixFloatBuffer, UINT nCount)
 
 	{
 
-		StereoMixToFloat(pbuffer, MixFloatBuffer, MixFloatBuffer+MIXBUFFERSIZE, nCount, 1.0f/MIXING_SCALEF);
-		
-		for (UINT bl=0; bl<MAX_EQ_BANDS; bl++)
-		{
-			if ((gEQ[bl].bEnable) && (gEQ[bl].Gain != 1.0f)) EQFilter(&gEQ[bl], MixFloatBuffer, nCount);
-		}
-		for (UINT br=MAX_EQ_BANDS; br<MAX_EQ_BANDS*2; br++)
-		{
-			if ((gEQ[br].bEnable) && (gEQ[br].Gain != 1.0f)) EQFilter(&gEQ[br], MixFloatBuffer+MIXBUFFERSIZE, nCount);
-		}
-
-		FloatToStereoMix(MixFloatBuffer, MixFloatBuffer+MIXBUFFERSIZE, pbuffer, nCount, MIXING_SCALEF);
+		// Both channels stay interleaved and are filtered side by side by the cascade.
+		MonoMixToFloat(pbuffer, MixFloatBuffer, nCount*2, 1.0f/MIXING_SCALEF);
+		EQBANDSTRUCT * const laneBands[2] = { gEQ, gEQ + MAX_EQ_BANDS };
+		float32 * const buffers[1] = { MixFloatBuffer };
+		EQFilterCascade<1, 2>(laneBands, buffers, nCount);
+		FloatToMonoMix(MixFloatBuffer, pbuffer, nCount*2, MIXING_SCALEF);
 
 	}
 }
@@ -457,8 +543,23 @@ void CQuadEQ::Process(int *frontBuffer, int *rearBuffer, UINT nCount, UINT nChan
 		front.ProcessStereo(frontBuffer, EQTempFloatBuffer, nCount);
 	} else if(nChannels == 4)
 	{
-		front.ProcessStereo(frontBuffer, EQTempFloatBuffer, nCount);
-		rear.ProcessStereo(rearBuffer, EQTempFloatBuffer, nCount);
+#ifdef ENABLE_X86
+		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
+		{
+			front.ProcessStereo(frontBuffer, EQTempFloatBuffer, nCount);
+			rear.ProcessStereo(rearBuffer, EQTempFloatBuffer, nCount);
+			return;
+		}
+#endif // ENABLE_X86
+		// Front and rear channels go through the cascade together, as four lanes.
+		float32 *frontFloat = EQTempFloatBuffer, *rearFloat = EQTempFloatBuffer + nCount * 2;
+		MonoMixToFloat(frontBuffer, frontFloat, nCount * 2, 1.0f/MIXING_SCALEF);
+		MonoMixToFloat(rearBuffer, rearFloat, nCount * 2, 1.0f/MIXING_SCALEF);
+		EQBANDSTRUCT * const laneBands[4] = { front.gEQ, front.gEQ + MAX_EQ_BANDS, rear.gEQ, rear.gEQ + MAX_EQ_BANDS };
+		float32 * const buffers[2] = { frontFloat, rearFloat };
+		EQFilterCascade<2, 2>(laneBands, buffers, nCount);
+		FloatToMonoMix(frontFloat, frontBuffer, nCount * 2, MIXING_SCALEF);
+		FloatToMonoMix(rearFloat, rearBuffer, nCount * 2, MIXING_SCALEF);
 	}
 }
 
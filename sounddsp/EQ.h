@@ -39,11 +39,13 @@ typedef struct _EQBANDSTRUCT
 
 class CEQ
 {
+	friend class CQuadEQ;
 private:
 	EQBANDSTRUCT gEQ[MAX_EQ_BANDS*2];
 public:
 	CEQ();
 public:
+	const EQBANDSTRUCT &GetBand(UINT band) const { return gEQ[band]; }
 	void Initialize(bool bReset, DWORD MixingFreq);
 	void ProcessStereo(int *pbuffer, float *MixFloatBuffer, UINT nCount);
 	void ProcessMono(int *pbuffer, float *MixFloatBuffer, UINT nCount);
@@ -56,11 +58,13 @@ class CQuadEQ
 private:
 	CEQ front;
 	CEQ rear;
-	float EQTempFloatBuffer[MIXBUFFERSIZE * 2];
+	float EQTempFloatBuffer[MIXBUFFERSIZE * 4];
 public:
 	void Initialize(bool bReset, DWORD MixingFreq);
 	void Process(int *frontBuffer, int *rearBuffer, UINT nCount, UINT nChannels);
 	void SetEQGains(const UINT *pGains, UINT nGains, const UINT *pFreqs, bool bReset, DWORD MixingFreq);
+	const CEQ &GetFront() const { return front; }
+	const CEQ &GetRear() const { return rear; }
 };
 
 
@@ -19,6 +19,15 @@
 #include <emmintrin.h>
 #endif
 
+// The floating-point reverb only needs SSE, which is always available on some targets
+#if !defined(ENABLE_SSE) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1)))
+#define MPT_REVERB_SSE_BASELINE
+#endif
+#if defined(ENABLE_SSE) || defined(MPT_REVERB_SSE_BASELINE)
+#define MPT_REVERB_SSE
+#include <xmmintrin.h>
+#endif
+
 #endif // NO_REVERB
 
 
@@ -38,6 +47,34 @@ static MPT_FORCEINLINE void Store64SSE(int32 *dst, __m128i src) { return _mm_sto
 static MPT_FORCEINLINE void Store64SSE(LR16 (&dst)[2], __m128i src) { return _mm_storel_epi64(&reinterpret_cast<__m128i &>(dst), src); }
 #endif
 
+#ifdef MPT_REVERB_SSE
+// Load a stereo float pair into the lower half of a register
+static MPT_FORCEINLINE __m128 LoadLRSSE(const FloatLR &x) { return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(&x)); }
+static MPT_FORCEINLINE __m128 LoadLRSSE(const float *x) { return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(x)); }
+// Store the lower half of a register as a stereo float pair
+static MPT_FORCEINLINE void StoreLRSSE(FloatLR &dst, __m128 src) { _mm_storel_pi(reinterpret_cast<__m64 *>(&dst), src); }
+static MPT_FORCEINLINE void StoreLRSSE(float *dst, __m128 src) { _mm_storel_pi(reinterpret_cast<__m64 *>(dst), src); }
+// [ l | r | l | r ]
+static MPT_FORCEINLINE __m128 LoadLRDupSSE(const FloatLR &x) { __m128 v = LoadLRSSE(x); return _mm_movelh_ps(v, v); }
+// [ a | b | c | d ] -> [ a+b | c+d | a+b | c+d ]
+static MPT_FORCEINLINE __m128 PairSumSSE(__m128 x)
+{
+	__m128 sum = _mm_add_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 0, 2, 0));
+}
+// Four 16-bit gains {ll, lr, rl, rr} as floats with the given scale
+static MPT_FORCEINLINE __m128 GainsSSE(const LR16 (&x)[2], float scale) { return _mm_mul_ps(_mm_setr_ps(x[0].c.l, x[0].c.r, x[1].c.l, x[1].c.r), _mm_set1_ps(scale)); }
+
+static MPT_FORCEINLINE bool ReverbHasSSE()
+{
+#ifdef MPT_REVERB_SSE_BASELINE
+	return true;
+#else
+	return (GetProcSupport() & PROCSUPPORT_SSE) != 0;
+#endif
+}
+#endif // MPT_REVERB_SSE
+
 
 CReverb::CReverb()
 {
@@ -262,6 +299,12 @@ void CReverb::Shutdown()
 	MemsetZero(gnDCRRvb_X1);
 	MemsetZero(gnDCRRvb_Y1);
 
+	// Zero filter histories and delay line positions, so that the reverb behaves exactly like after construction
+	g_RefDelay.nDelayPos = g_RefDelay.nPreDifPos = g_RefDelay.nRefOutPos = 0;
+	g_RefDelay.History.lr = 0;
+	g_LateReverb.nDelayPos = 0;
+	MemsetZero(g_LateReverb.LPHistory);
+
 	// Zero internal buffers
 	MemsetZero(g_LateReverb.Diffusion1);
 	MemsetZero(g_LateReverb.Diffusion2);
@@ -270,6 +313,10 @@ void CReverb::Shutdown()
 	MemsetZero(g_RefDelay.RefDelayBuffer);
 	MemsetZero(g_RefDelay.PreDifBuffer);
 	MemsetZero(g_RefDelay.RefOut);
+	if(g_RefDelayFloat)
+		MemsetZero(*g_RefDelayFloat);
+	if(g_LateReverbFloat)
+		MemsetZero(*g_LateReverbFloat);
 }
 
 
@@ -278,14 +325,37 @@ void CReverb::Initialize(bool bReset, uint32 MixingFreq)
 	if (m_Settings.m_nReverbType >= NUM_REVERBTYPES) m_Settings.m_nReverbType = 0;
 	const SNDMIX_REVERB_PROPERTIES *rvbPreset = &ReverbPresets[m_Settings.m_nReverbType].first;
 
+	if(m_Settings.m_halfRate != m_currentHalfRate)
+	{
+		// Filter and delay line state is not compatible between both modes
+		bReset = true;
+	}
+	if(m_Settings.m_floatProcessing != m_currentFloat)
+	{
+		m_currentFloat = m_Settings.m_floatProcessing;
+		if(m_currentFloat)
+		{
+			g_RefDelayFloat = std::make_unique<SWRvbRefDelayFloat>();
+			g_LateReverbFloat = std::make_unique<SWLateReverbFloat>();
+		} else
+		{
+			g_RefDelayFloat.reset();
+			g_LateReverbFloat.reset();
+		}
+		// The new state starts out silent, so the rest of the reverb has to start over as well
+		bReset = true;
+	}
+
 	if ((rvbPreset != m_currentPreset) || (bReset))
 	{
-		// Reverb output frequency is half of the dry output rate
-		float flOutputFrequency = (float)MixingFreq;
+		// Reverb output frequency is either the dry output rate or half of it
+		const uint32 rateDivisor = m_Settings.m_halfRate ? 2 : 1;
+		float flOutputFrequency = (float)MixingFreq / rateDivisor;
 		EnvironmentReverb rvb;
 
 		// Reset reverb parameters
 		m_currentPreset = rvbPreset;
+		m_currentHalfRate = m_Settings.m_halfRate;
 		I3dl2_to_Generic(rvbPreset, &rvb, flOutputFrequency,
 							RVBMINREFDELAY, RVBMAXREFDELAY,
 							RVBMINRVBDELAY, RVBMAXRVBDELAY,
@@ -294,8 +364,8 @@ void CReverb::Initialize(bool bReset, uint32 MixingFreq)
 							+ RVBDLY1L_LEN + RVBDLY1R_LEN
 							+ RVBDLY2L_LEN + RVBDLY2R_LEN) / 2);
 
-		// Store reverb decay time (in samples) for reverb auto-shutdown
-		gnReverbDecaySamples = rvb.ReverbDecaySamples;
+		// Store reverb decay time (in dry output samples) for reverb auto-shutdown
+		gnReverbDecaySamples = rvb.ReverbDecaySamples * rateDivisor;
 
 		// Room attenuation at high frequencies
 		int32 nRoomLP;
@@ -425,12 +495,27 @@ void CReverb::Process(MixSampleInt *MixSoundBuffer, uint32 nSamples)
 	if (lDryVol > 16) lDryVol = 16;
 	lDryVol = 16 - (((16-lDryVol) * lMaxRvbGain) >> 15);
 	ReverbDryMix(MixSoundBuffer, MixReverbBuffer, lDryVol, nSamples);
-	// Downsample 2x + 1st stage of lowpass filter
-	nIn = ReverbProcessPreFiltering1x(MixReverbBuffer, nSamples);
-	nOut = nIn;
+	if(m_currentHalfRate)
+	{
+		// Downsample 2x + 1st stage of lowpass filter
+		nIn = ReverbProcessPreFiltering2x(MixReverbBuffer, nSamples);
+		// Number of reverb samples consumed by the 2x upsampling stage
+		nOut = (nSamples - (g_bLastOutPresent ? 1 : 0) + 1) / 2;
+	} else
+	{
+		// 1st stage of lowpass filter
+		nIn = ReverbProcessPreFiltering1x(MixReverbBuffer, nSamples);
+		nOut = nIn;
+	}
 	// Main reverb processing: split into small chunks (needed for short reverb delays)
 	// Reverb Input + Low-Pass stage #2 + Pre-diffusion
-	if (nIn > 0) ProcessPreDelay(&g_RefDelay, MixReverbBuffer, nIn);
+	if (nIn > 0)
+	{
+		if(m_currentFloat)
+			ProcessPreDelayFloat(&g_RefDelay, g_RefDelayFloat.get(), MixReverbBuffer, nIn);
+		else
+			ProcessPreDelay(&g_RefDelay, MixReverbBuffer, nIn);
+	}
 	// Process Reverb Reflections and Late Reverberation
 	int32 *pRvbOut = MixReverbBuffer;
 	uint32 nRvbSamples = nOut, nCount = 0;
@@ -444,10 +529,22 @@ void CReverb::Process(MixSampleInt *MixSoundBuffer, uint32 nSamples)
 		uint32 n = nRvbSamples;
 		if (n > nmax1) n = nmax1;
 		if (n > 64) n = 64;
-		// Reflections output + late reverb delay
-		ProcessReflections(&g_RefDelay, &g_RefDelay.RefOut[nPosRef], pRvbOut, n);
-		// Late Reverberation
-		ProcessLateReverb(&g_LateReverb, &g_RefDelay.RefOut[nPosRvb], pRvbOut, n);
+		if(m_currentFloat)
+		{
+			float rvbOut[64 * 2];
+			ProcessReflectionsFloat(&g_RefDelay, g_RefDelayFloat.get(), &g_RefDelayFloat->RefOut[nPosRef], rvbOut, n);
+			ProcessLateReverbFloat(&g_LateReverb, g_LateReverbFloat.get(), &g_RefDelayFloat->RefOut[nPosRvb], rvbOut, n);
+			for(uint32 i = 0; i < n * 2; i++)
+			{
+				pRvbOut[i] = mpt::saturate_round<int32>(rvbOut[i]);
+			}
+		} else
+		{
+			// Reflections output + late reverb delay
+			ProcessReflections(&g_RefDelay, &g_RefDelay.RefOut[nPosRef], pRvbOut, n);
+			// Late Reverberation
+			ProcessLateReverb(&g_LateReverb, &g_RefDelay.RefOut[nPosRvb], pRvbOut, n);
+		}
 		// Update delay positions
 		g_RefDelay.nRefOutPos = (g_RefDelay.nRefOutPos + n) & SNDMIX_REVERB_DELAY_MASK;
 		g_RefDelay.nDelayPos = (g_RefDelay.nDelayPos + n) & SNDMIX_REFLECTIONS_DELAY_MASK;
@@ -457,8 +554,16 @@ void CReverb::Process(MixSampleInt *MixSoundBuffer, uint32 nSamples)
 	}
 	// Adjust nDelayPos, in case nIn != nOut
 	g_RefDelay.nDelayPos = (g_RefDelay.nDelayPos - nOut + nIn) & SNDMIX_REFLECTIONS_DELAY_MASK;
-	// Upsample 2x
-	ReverbProcessPostFiltering1x(MixReverbBuffer, MixSoundBuffer, nSamples);
+	if(m_currentHalfRate)
+	{
+		// DC removal + upsample 2x
+		ReverbDCRemoval(MixReverbBuffer, nOut);
+		ReverbProcessPostFiltering2x(MixReverbBuffer, MixSoundBuffer, nSamples);
+	} else
+	{
+		// Stereo add + DC removal
+		ReverbProcessPostFiltering1x(MixReverbBuffer, MixSoundBuffer, nSamples);
+	}
 	// Automatically shut down if needed
 	if(gnReverbSend) gnReverbSamples = gnReverbDecaySamples; // reset decay counter
 	else if(gnReverbSamples > nSamples) gnReverbSamples -= nSamples; // decay
@@ -1032,6 +1137,276 @@ void CReverb::ProcessLateReverb(SWLateReverb * MPT_RESTRICT pReverb, LR16 * MPT_
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Floating-point reverb:
+//
+// Same topology and coefficients as the fixed-point code above. Values stay at
+// the same 16-bit scale, but nothing is saturated between the stages.
+//
+
+void CReverb::ProcessPreDelayFloat(SWRvbRefDelay * MPT_RESTRICT pPreDelay, SWRvbRefDelayFloat * MPT_RESTRICT pState, const int32 * MPT_RESTRICT pIn, uint32 nSamples)
+{
+	uint32 preDifPos = pPreDelay->nPreDifPos;
+	uint32 delayPos = pPreDelay->nDelayPos - 1;
+#ifdef MPT_REVERB_SSE
+	if(ReverbHasSSE())
+	{
+		const __m128 coeffs = _mm_setr_ps(pPreDelay->nCoeffs.c.l / 32768.0f, pPreDelay->nCoeffs.c.r / 32768.0f, 0.0f, 0.0f);
+		const __m128 preDifCoeffs = _mm_setr_ps(pPreDelay->nPreDifCoeffs.c.l / 65536.0f, pPreDelay->nPreDifCoeffs.c.r / 65536.0f, 0.0f, 0.0f);
+		__m128 history = LoadLRSSE(pState->History);
+		while(nSamples--)
+		{
+			const __m128 in = _mm_setr_ps(static_cast<float>(pIn[0]), static_cast<float>(pIn[1]), 0.0f, 0.0f);
+			pIn += 2;
+			// Low-pass
+			history = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(history, in), coeffs), in);
+			// Pre-Diffusion
+			const __m128 preDif = LoadLRSSE(pState->PreDifBuffer[preDifPos]);
+			preDifPos = (preDifPos + 1) & SNDMIX_PREDIFFUSION_DELAY_MASK;
+			delayPos = (delayPos + 1) & SNDMIX_REFLECTIONS_DELAY_MASK;
+			const __m128 preDif2 = _mm_sub_ps(history, _mm_mul_ps(preDif, preDifCoeffs));
+			StoreLRSSE(pState->PreDifBuffer[preDifPos], preDif2);
+			StoreLRSSE(pState->RefDelayBuffer[delayPos], _mm_add_ps(_mm_mul_ps(preDifCoeffs, preDif2), preDif));
+		}
+		pPreDelay->nPreDifPos = preDifPos;
+		StoreLRSSE(pState->History, history);
+		return;
+	}
+#endif
+	const float coeffsL = pPreDelay->nCoeffs.c.l / 32768.0f, coeffsR = pPreDelay->nCoeffs.c.r / 32768.0f;
+	const float preDifCoeffsL = pPreDelay->nPreDifCoeffs.c.l / 65536.0f, preDifCoeffsR = pPreDelay->nPreDifCoeffs.c.r / 65536.0f;
+	float historyL = pState->History.l, historyR = pState->History.r;
+	while(nSamples--)
+	{
+		const float inL = static_cast<float>(pIn[0]);
+		const float inR = static_cast<float>(pIn[1]);
+		pIn += 2;
+		// Low-pass
+		historyL = (historyL - inL) * coeffsL + inL;
+		historyR = (historyR - inR) * coeffsR + inR;
+		// Pre-Diffusion
+		const float preDifL = pState->PreDifBuffer[preDifPos].l;
+		const float preDifR = pState->PreDifBuffer[preDifPos].r;
+		preDifPos = (preDifPos + 1) & SNDMIX_PREDIFFUSION_DELAY_MASK;
+		delayPos = (delayPos + 1) & SNDMIX_REFLECTIONS_DELAY_MASK;
+		const float preDif2L = historyL - preDifL * preDifCoeffsL;
+		const float preDif2R = historyR - preDifR * preDifCoeffsR;
+		pState->PreDifBuffer[preDifPos].l = preDif2L;
+		pState->PreDifBuffer[preDifPos].r = preDif2R;
+		pState->RefDelayBuffer[delayPos].l = preDifCoeffsL * preDif2L + preDifL;
+		pState->RefDelayBuffer[delayPos].r = preDifCoeffsR * preDif2R + preDifR;
+	}
+	pPreDelay->nPreDifPos = preDifPos;
+	pState->History.l = historyL;
+	pState->History.r = historyR;
+}
+
+
+// Sums all 7 reflections in one go and writes the reflections output to pOut (overwriting its contents)
+void CReverb::ProcessReflectionsFloat(const SWRvbRefDelay * MPT_RESTRICT pPreDelay, SWRvbRefDelayFloat * MPT_RESTRICT pState, FloatLR * MPT_RESTRICT pRefOut, float * MPT_RESTRICT pOut, uint32 nSamples)
+{
+	uint32 pos[7];
+	for(int i = 0; i < 7; i++)
+		pos[i] = pPreDelay->nDelayPos - pPreDelay->Reflections[i].Delay - 1;
+	// Same output scale as the fixed-point reflections
+	const float refGain = static_cast<float>(pPreDelay->ReflectionsGain.c.l / (1 << 3));
+#ifdef MPT_REVERB_SSE
+	if(ReverbHasSSE())
+	{
+		__m128 gains[7];
+		for(int i = 0; i < 7; i++)
+			gains[i] = GainsSSE(pPreDelay->Reflections[i].Gains, 1.0f / 32768.0f);
+		const __m128 refGainSSE = _mm_set1_ps(refGain);
+		while(nSamples--)
+		{
+			__m128 refOut = _mm_setzero_ps();
+			for(int i = 0; i < 7; i++)
+			{
+				pos[i] = (pos[i] + 1) & SNDMIX_REFLECTIONS_DELAY_MASK;
+				refOut = _mm_add_ps(refOut, _mm_mul_ps(LoadLRDupSSE(pState->RefDelayBuffer[pos[i]]), gains[i]));
+			}
+			refOut = PairSumSSE(refOut);
+			StoreLRSSE(*pRefOut, refOut);
+			pRefOut++;
+			StoreLRSSE(pOut, _mm_mul_ps(refOut, refGainSSE));
+			pOut += 2;
+		}
+		return;
+	}
+#endif
+	float gains[7][4];
+	for(int i = 0; i < 7; i++)
+	{
+		gains[i][0] = pPreDelay->Reflections[i].Gains[0].c.l / 32768.0f;
+		gains[i][1] = pPreDelay->Reflections[i].Gains[0].c.r / 32768.0f;
+		gains[i][2] = pPreDelay->Reflections[i].Gains[1].c.l / 32768.0f;
+		gains[i][3] = pPreDelay->Reflections[i].Gains[1].c.r / 32768.0f;
+	}
+	while(nSamples--)
+	{
+		float refOutL = 0.0f, refOutR = 0.0f;
+		for(int i = 0; i < 7; i++)
+		{
+			pos[i] = (pos[i] + 1) & SNDMIX_REFLECTIONS_DELAY_MASK;
+			const float refL = pState->RefDelayBuffer[pos[i]].l, refR = pState->RefDelayBuffer[pos[i]].r;
+			refOutL += refL * gains[i][0] + refR * gains[i][1];
+			refOutR += refL * gains[i][2] + refR * gains[i][3];
+		}
+		pRefOut->l = refOutL;
+		pRefOut->r = refOutR;
+		pRefOut++;
+		pOut[0] = refOutL * refGain;
+		pOut[1] = refOutR * refGain;
+		pOut += 2;
+	}
+}
+
+
+void CReverb::ProcessLateReverbFloat(SWLateReverb * MPT_RESTRICT pReverb, SWLateReverbFloat * MPT_RESTRICT pState, const FloatLR * MPT_RESTRICT pRefOut, float * MPT_RESTRICT pMixOut, uint32 nSamples)
+{
+	// Calculate delay line offset from current delay position
+	#define DELAY_OFFSET(x) ((delayPos - (x)) & RVBDLY_MASK)
+
+	int delayPos = pReverb->nDelayPos & RVBDLY_MASK;
+#ifdef MPT_REVERB_SSE
+	if(ReverbHasSSE())
+	{
+		// All vectors are either {ll, lr, rl, rr} or {l, r, l, r}
+		const __m128 rvbOutGains = GainsSSE(pReverb->RvbOutGains, 1.0f);
+		const __m128 difCoeffs = GainsSSE(pReverb->nDifCoeffs, 1.0f / 65536.0f);
+		const __m128 decayLP = GainsSSE(pReverb->nDecayLP, 1.0f / 32768.0f);
+		const __m128 decayDC = GainsSSE(pReverb->nDecayDC, 1.0f / 32768.0f);
+		const __m128 dif2InGains = GainsSSE(pReverb->Dif2InGains, 1.0f / 32768.0f);
+		const __m128 quarter = _mm_set1_ps(0.25f);
+		__m128 lpHistory = _mm_loadu_ps(pState->LPHistory);
+		while(nSamples--)
+		{
+			const __m128 refIn = _mm_mul_ps(LoadLRDupSSE(*pRefOut), quarter);
+			pRefOut++;
+
+			const __m128 delay2 = _mm_movelh_ps(LoadLRSSE(pState->Delay2[DELAY_OFFSET(RVBDLY2L_LEN)]), LoadLRSSE(pState->Delay2[DELAY_OFFSET(RVBDLY2R_LEN)]));
+
+			const float diff1L = pState->Diffusion1[DELAY_OFFSET(RVBDIF1L_LEN)].l;
+			const float diff1R = pState->Diffusion1[DELAY_OFFSET(RVBDIF1R_LEN)].r;
+			const __m128 diffusion1 = _mm_setr_ps(diff1L, diff1R, diff1L, diff1R);	// diffusion1 history
+
+			const float diff2L = pState->Diffusion2[DELAY_OFFSET(RVBDIF2L_LEN)].l;
+			const float diff2R = pState->Diffusion2[DELAY_OFFSET(RVBDIF2R_LEN)].r;
+			const __m128 diffusion2 = _mm_setr_ps(diff2L, diff2R, diff2L, diff2R);	// diffusion2 history
+
+			lpHistory = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(lpHistory, delay2), decayLP), delay2);	// Low-passed decay
+
+			// Apply decay gain
+			const __m128 histDecayIn = _mm_add_ps(PairSumSSE(_mm_mul_ps(lpHistory, decayDC)), refIn);
+			const __m128 histDecayInDiff = _mm_sub_ps(histDecayIn, _mm_mul_ps(diffusion1, difCoeffs));
+			StoreLRSSE(pState->Diffusion1[delayPos], histDecayInDiff);
+
+			const __m128 delay1Out = _mm_add_ps(_mm_mul_ps(difCoeffs, histDecayInDiff), diffusion1);
+			// Insert the diffusion output in the reverb delay line
+			StoreLRSSE(pState->Delay1[delayPos], delay1Out);
+			const __m128 histDecayInDelay = _mm_add_ps(histDecayIn, delay1Out);
+
+			// Input to second diffuser
+			const __m128 delay1 = _mm_movelh_ps(LoadLRSSE(pState->Delay1[DELAY_OFFSET(RVBDLY1L_LEN)]), LoadLRSSE(pState->Delay1[DELAY_OFFSET(RVBDLY1R_LEN)]));
+
+			const __m128 delay1Gains = PairSumSSE(_mm_mul_ps(delay1, dif2InGains));
+			const __m128 histDelay1 = _mm_sub_ps(_mm_add_ps(histDecayInDelay, delay1), delay1Gains);	// accumulate with reverb output
+			const __m128 diff2out = _mm_sub_ps(delay1Gains, _mm_mul_ps(diffusion2, difCoeffs));
+			const __m128 diff2outCoeffs = _mm_mul_ps(difCoeffs, diff2out);
+			StoreLRSSE(pState->Diffusion2[delayPos], diff2out);
+
+			const __m128 delay2out = _mm_add_ps(diff2outCoeffs, diffusion2);
+			StoreLRSSE(pState->Delay2[delayPos], delay2out);
+			delayPos = (delayPos + 1) & RVBDLY_MASK;
+			// Accumulate with reverb output
+			const __m128 out = PairSumSSE(_mm_mul_ps(_mm_add_ps(histDelay1, _mm_movelh_ps(delay2out, diff2outCoeffs)), rvbOutGains));
+			StoreLRSSE(pMixOut, _mm_add_ps(LoadLRSSE(pMixOut), out));
+			pMixOut += 2;
+		}
+		_mm_storeu_ps(pState->LPHistory, lpHistory);
+		pReverb->nDelayPos = delayPos;
+		return;
+	}
+#endif
+	const float difCoeffsL = pReverb->nDifCoeffs[0].c.l / 65536.0f, difCoeffsR = pReverb->nDifCoeffs[0].c.r / 65536.0f;
+	const float decayLP[4] = { pReverb->nDecayLP[0].c.l / 32768.0f, pReverb->nDecayLP[0].c.r / 32768.0f, pReverb->nDecayLP[1].c.l / 32768.0f, pReverb->nDecayLP[1].c.r / 32768.0f };
+	const float decayDCL = pReverb->nDecayDC[0].c.l / 32768.0f, decayDCR = pReverb->nDecayDC[1].c.r / 32768.0f;
+	const float dif2InGains[4] = { pReverb->Dif2InGains[0].c.l / 32768.0f, pReverb->Dif2InGains[0].c.r / 32768.0f, pReverb->Dif2InGains[1].c.l / 32768.0f, pReverb->Dif2InGains[1].c.r / 32768.0f };
+	const float rvbOutGains[4] = { static_cast<float>(pReverb->RvbOutGains[0].c.l), static_cast<float>(pReverb->RvbOutGains[0].c.r), static_cast<float>(pReverb->RvbOutGains[1].c.l), static_cast<float>(pReverb->RvbOutGains[1].c.r) };
+	float *lpHistory = pState->LPHistory;
+	while(nSamples--)
+	{
+		const float refInL = pRefOut->l, refInR = pRefOut->r;
+		pRefOut++;
+
+		const float delay2[4] =
+		{
+			pState->Delay2[DELAY_OFFSET(RVBDLY2L_LEN)].l, pState->Delay2[DELAY_OFFSET(RVBDLY2L_LEN)].r,
+			pState->Delay2[DELAY_OFFSET(RVBDLY2R_LEN)].l, pState->Delay2[DELAY_OFFSET(RVBDLY2R_LEN)].r,
+		};
+
+		const float diff1L = pState->Diffusion1[DELAY_OFFSET(RVBDIF1L_LEN)].l;
+		const float diff1R = pState->Diffusion1[DELAY_OFFSET(RVBDIF1R_LEN)].r;
+
+		const float diff2L = pState->Diffusion2[DELAY_OFFSET(RVBDIF2L_LEN)].l;
+		const float diff2R = pState->Diffusion2[DELAY_OFFSET(RVBDIF2R_LEN)].r;
+
+		// Low-passed decay
+		for(int i = 0; i < 4; i++)
+			lpHistory[i] = (lpHistory[i] - delay2[i]) * decayLP[i] + delay2[i];
+
+		// Apply decay gain
+		const float histDecayInL = decayDCL * lpHistory[0] + refInL * 0.25f;
+		const float histDecayInR = decayDCR * lpHistory[3] + refInR * 0.25f;
+		const float histDecayInDiffL = histDecayInL - diff1L * difCoeffsL;
+		const float histDecayInDiffR = histDecayInR - diff1R * difCoeffsR;
+		pState->Diffusion1[delayPos].l = histDecayInDiffL;
+		pState->Diffusion1[delayPos].r = histDecayInDiffR;
+
+		const float delay1L = difCoeffsL * histDecayInDiffL + diff1L;
+		const float delay1R = difCoeffsR * histDecayInDiffR + diff1R;
+		// Insert the diffusion output in the reverb delay line
+		pState->Delay1[delayPos].l = delay1L;
+		pState->Delay1[delayPos].r = delay1R;
+		const float histDecayInDelayL = histDecayInL + delay1L;
+		const float histDecayInDelayR = histDecayInR + delay1R;
+
+		// Input to second diffuser
+		const float delay1LL = pState->Delay1[DELAY_OFFSET(RVBDLY1L_LEN)].l, delay1LR = pState->Delay1[DELAY_OFFSET(RVBDLY1L_LEN)].r;
+		const float delay1RL = pState->Delay1[DELAY_OFFSET(RVBDLY1R_LEN)].l, delay1RR = pState->Delay1[DELAY_OFFSET(RVBDLY1R_LEN)].r;
+
+		const float delay1GainsL = delay1LL * dif2InGains[0] + delay1LR * dif2InGains[1];
+		const float delay1GainsR = delay1RL * dif2InGains[2] + delay1RR * dif2InGains[3];
+
+		// accumulate with reverb output
+		const float histDelay1LL = histDecayInDelayL + delay1LL - delay1GainsL;
+		const float histDelay1LR = histDecayInDelayR + delay1LR - delay1GainsR;
+		const float histDelay1RL = histDecayInDelayL + delay1RL - delay1GainsL;
+		const float histDelay1RR = histDecayInDelayR + delay1RR - delay1GainsR;
+		const float diff2outL = delay1GainsL - diff2L * difCoeffsL;
+		const float diff2outR = delay1GainsR - diff2R * difCoeffsR;
+		const float diff2outCoeffsL = difCoeffsL * diff2outL;
+		const float diff2outCoeffsR = difCoeffsR * diff2outR;
+		pState->Diffusion2[delayPos].l = diff2outL;
+		pState->Diffusion2[delayPos].r = diff2outR;
+
+		const float delay2outL = diff2outCoeffsL + diff2L;
+		const float delay2outR = diff2outCoeffsR + diff2R;
+		pState->Delay2[delayPos].l = delay2outL;
+		pState->Delay2[delayPos].r = delay2outR;
+		delayPos = (delayPos + 1) & RVBDLY_MASK;
+		// Accumulate with reverb output
+		pMixOut[0] += (histDelay1LL + delay2outL) * rvbOutGains[0] + (histDelay1LR + delay2outR) * rvbOutGains[1];
+		pMixOut[1] += (histDelay1RL + diff2outCoeffsL) * rvbOutGains[2] + (histDelay1RR + diff2outCoeffsR) * rvbOutGains[3];
+		pMixOut += 2;
+	}
+	pReverb->nDelayPos = delayPos;
+
+	#undef DELAY_OFFSET
+}
+
+
 #else
 
 
@@ -16,6 +16,8 @@
 
 #include "../soundlib/Mixer.h"	// For MIXBUFFERSIZE
 
+#include <memory>
+
 OPENMPT_NAMESPACE_BEGIN
 
 ////////////////////////////////////////////////////////////////////////
@@ -100,6 +102,31 @@ struct SWLateReverb
 	LR16   Delay2[RVBDLY_MASK + 1];		// {dly2_l, dly2_r}
 };
 
+// Floating-point reverb state, used instead of the LR16 buffers if CReverbSettings::m_floatProcessing is set.
+// Values are kept at the same 16-bit scale as the fixed-point buffers, but they are not saturated.
+struct FloatLR
+{
+	float l, r;
+};
+
+struct SWRvbRefDelayFloat
+{
+	FloatLR History;	// room low-pass history
+	FloatLR RefDelayBuffer[SNDMIX_REFLECTIONS_DELAY_MASK + 1]; // reflections delay buffer
+	FloatLR PreDifBuffer[SNDMIX_PREDIFFUSION_DELAY_MASK + 1]; // pre-diffusion
+	FloatLR RefOut[SNDMIX_REVERB_DELAY_MASK + 1]; // stereo output of reflections
+};
+
+struct SWLateReverbFloat
+{
+	float   LPHistory[4];	// Low-pass history {ll, lr, rl, rr}
+	// Tank Delay lines
+	FloatLR Diffusion1[RVBDLY_MASK + 1];	// {dif1_l, dif1_r}
+	FloatLR Diffusion2[RVBDLY_MASK + 1];	// {dif2_l, dif2_r}
+	FloatLR Delay1[RVBDLY_MASK + 1];		// {dly1_l, dly1_r}
+	FloatLR Delay2[RVBDLY_MASK + 1];		// {dly2_l, dly2_r}
+};
+
 #define ENVIRONMENT_NUMREFLECTIONS		8
 
 struct EnvironmentReflection
@@ -128,6 +155,8 @@ class CReverbSettings
 public:
 	uint32 m_nReverbDepth = 8; // 50%
 	uint32 m_nReverbType = 0;
+	bool m_halfRate = false; // Process reverb at half the mixing rate
+	bool m_floatProcessing = false; // Process reflections and late reverb in floating point
 };
 
 
@@ -144,6 +173,8 @@ public:
 
 private:
 	const SNDMIX_REVERB_PROPERTIES *m_currentPreset = nullptr;
+	bool m_currentHalfRate = false;
+	bool m_currentFloat = false;
 
 	uint32 gnReverbSend = 0;
 
@@ -165,6 +196,9 @@ private:
 	// Reverb mix buffers
 	SWRvbRefDelay g_RefDelay;
 	SWLateReverb g_LateReverb;
+	// Only allocated while floating-point processing is enabled
+	std::unique_ptr<SWRvbRefDelayFloat> g_RefDelayFloat;
+	std::unique_ptr<SWLateReverbFloat> g_LateReverbFloat;
 
 public:
 	CReverb();
@@ -192,6 +226,10 @@ private:
 	static void ProcessReflections(SWRvbRefDelay *pPreDelay, LR16 *pRefOut, int32 *pMixOut, uint32 nSamples);
 	// Process Late Reverb (SW Reflections): stereo reflections output, 32-bit reverb output, SW reverb gain
 	static void ProcessLateReverb(SWLateReverb *pReverb, LR16 *pRefOut, int32 *pMixOut, uint32 nSamples);
+	// Floating-point versions of the above, using the coefficients and delay positions of the fixed-point state
+	static void ProcessPreDelayFloat(SWRvbRefDelay *pPreDelay, SWRvbRefDelayFloat *pState, const int32 *pIn, uint32 nSamples);
+	static void ProcessReflectionsFloat(const SWRvbRefDelay *pPreDelay, SWRvbRefDelayFloat *pState, FloatLR *pRefOut, float *pMixOut, uint32 nSamples);
+	static void ProcessLateReverbFloat(SWLateReverb *pReverb, SWLateReverbFloat *pState, const FloatLR *pRefOut, float *pMixOut, uint32 nSamples);
 };
 
 
@@ -24,6 +24,45 @@
 OPENMPT_NAMESPACE_BEGIN
 
 
+struct GainFloat
+{
+	float factor;
+	template<typename T>
+	MPT_FORCEINLINE T operator()(T sample) const
+	{
+		return sample * factor;
+	}
+};
+
+
+// Conversions with a vectorized implementation: Undithered 16-bit or float interleaved output from a float mix buffer.
+// The generic code loops over frames and channels, which compilers do not vectorize unless the channel count is known.
+// Return false if the conversion has to be done by the generic code.
+template<typename TOutBuf, typename Tdither, typename TpreGain>
+inline bool ConvertMixBufferVectorized(TOutBuf, const MixSampleFloat *, Tdither &, std::size_t, std::size_t, TpreGain)
+{
+	return false;
+}
+template<typename TpreGain>
+inline bool ConvertMixBufferVectorized(audio_buffer_interleaved<float> outBuf, const MixSampleFloat * MPT_RESTRICT inBuf, DitherTemplate<Dither_None, 4> &, std::size_t channels, std::size_t count, TpreGain preGain)
+{
+	float * MPT_RESTRICT out = outBuf.data();
+	for(std::size_t i = 0; i < channels * count; i++)
+	{
+		out[i] = static_cast<float>(preGain(inBuf[i]));
+	}
+	return true;
+}
+inline bool ConvertMixBufferVectorized(audio_buffer_interleaved<int16> outBuf, const MixSampleFloat *inBuf, DitherTemplate<Dither_None, 4> &, std::size_t channels, std::size_t count, NoGain)
+{
+	return FloatToInt16(inBuf, outBuf.data(), channels * count, 1.0f);
+}
+inline bool ConvertMixBufferVectorized(audio_buffer_interleaved<int16> outBuf, const MixSampleFloat *inBuf, DitherTemplate<Dither_None, 4> &, std::size_t channels, std::size_t count, GainFloat gain)
+{
+	return FloatToInt16(inBuf, outBuf.data(), channels * count, gain.factor);
+}
+
+
 template<typename Tbuffer>
 class AudioReadTargetBuffer
 	: public IAudioReadTarget
@@ -42,74 +81,57 @@ public:
 		MPT_ASSERT(SampleFormat(SampleFormatTraits<typename Tbuffer::sample_type>::sampleFormat()).IsValid());
 	}
 	std::size_t GetRenderedCount() const { return countRendered; }
-public:
-	void DataCallback(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+protected:
+	template<typename TpreGain, typename TpostGain>
+	void ConvertMixBuffer(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk, TpreGain preGain, TpostGain postGain)
 	{
 		dither.WithDither(
 			[&](auto &ditherInstance)
 			{
-				ConvertBufferMixFixedToBuffer<MixSampleIntTraits::mix_fractional_bits(), false>(advance_audio_buffer(outputBuffer, countRendered), audio_buffer_interleaved<MixSampleInt>(MixSoundBuffer, channels, countChunk), ditherInstance, channels, countChunk);
+				ConvertBufferMixFixedToBuffer<MixSampleIntTraits::mix_fractional_bits(), false>(advance_audio_buffer(outputBuffer, countRendered), audio_buffer_interleaved<MixSampleInt>(MixSoundBuffer, channels, countChunk), ditherInstance, channels, countChunk, preGain, postGain);
 			}
 		);
 		countRendered += countChunk;
 	}
-	void DataCallback(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	template<typename TpreGain>
+	void ConvertMixBuffer(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk, TpreGain preGain)
 	{
 		dither.WithDither(
 			[&](auto &ditherInstance)
 			{
-				ConvertBufferMixFloatToBuffer<false>(advance_audio_buffer(outputBuffer, countRendered), audio_buffer_interleaved<MixSampleFloat>(MixSoundBuffer, channels, countChunk), ditherInstance, channels, countChunk);
+				if(ConvertMixBufferVectorized(advance_audio_buffer(outputBuffer, countRendered), MixSoundBuffer, ditherInstance, channels, countChunk, preGain))
+					return;
+				ConvertBufferMixFloatToBuffer<false>(advance_audio_buffer(outputBuffer, countRendered), audio_buffer_interleaved<MixSampleFloat>(MixSoundBuffer, channels, countChunk), ditherInstance, channels, countChunk, preGain);
 			}
 		);
 		countRendered += countChunk;
 	}
+public:
+	void DataCallback(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain(), NoGain());
+	}
+	void DataCallback(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain());
+	}
 };
 
 
 #if defined(LIBOPENMPT_BUILD)
 
 
-template<typename Tsample>
-void ApplyGainBeforeConversionIfAppropriateFixed(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk, float gainFactor)
-{
-	// Apply final output gain for non floating point output
-	ApplyGain(MixSoundBuffer, channels, countChunk, mpt::saturate_round<int32>(gainFactor * (1<<16)));
-}
-template<>
-void ApplyGainBeforeConversionIfAppropriateFixed<float>(MixSampleInt * /*MixSoundBuffer*/, std::size_t /*channels*/, std::size_t /*countChunk*/, float /*gainFactor*/)
-{
-	// nothing
-}
-
-template<typename Tsample>
-void ApplyGainAfterConversionIfAppropriateFixed(audio_buffer_interleaved<Tsample> /*buffer*/, std::size_t /*countRendered*/, std::size_t /*channels*/, std::size_t /*countChunk*/, float /*gainFactor*/)
-{
-	// nothing
-}
-template<typename Tsample>
-void ApplyGainAfterConversionIfAppropriateFixed(audio_buffer_planar<Tsample> /*buffer*/, std::size_t /*countRendered*/, std::size_t /*channels*/, std::size_t /*countChunk*/, float /*gainFactor*/)
-{
-	// nothing
-}
-template<>
-void ApplyGainAfterConversionIfAppropriateFixed<float>(audio_buffer_interleaved<float> buffer, std::size_t countRendered, std::size_t channels, std::size_t countChunk, float gainFactor)
+// Gain in 16.16 fixed point, no clipping prevention is done here
+struct GainFixed16_16
 {
-	// Apply final output gain for floating point output after conversion so we do not suffer underflow or clipping
-	ApplyGain(buffer, countRendered, channels, countChunk, gainFactor);
-}
-template<>
-void ApplyGainAfterConversionIfAppropriateFixed<float>(audio_buffer_planar<float> buffer, std::size_t countRendered, std::size_t channels, std::size_t countChunk, float gainFactor)
-{
-	// Apply final output gain for floating point output after conversion so we do not suffer underflow or clipping
-	ApplyGain(buffer, countRendered, channels, countChunk, gainFactor);
-}
-
-inline void ApplyGainBeforeConversionIfAppropriateFloat(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk, float gainFactor)
-{
-	// Apply final output gain for non floating point output
-	ApplyGain(MixSoundBuffer, channels, countChunk, gainFactor);
-}
+	int32 factor;
+	MPT_FORCEINLINE MixSampleInt operator()(MixSampleInt sample) const
+	{
+		return Util::muldiv(sample, factor, 1<<16);
+	}
+};
 
+// The gain is applied in the same pass as the output conversion.
 template<typename Tbuffer>
 class AudioReadTargetGainBuffer
 	: public AudioReadTargetBuffer<Tbuffer>
@@ -125,19 +147,142 @@ public:
 	{
 		return;
 	}
+private:
+	void DataCallbackFixed(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk, std::true_type /* floatOutput */)
+	{
+		// Apply final output gain for floating point output after conversion so we do not suffer underflow or clipping
+		if(gainFactor == 1.0f)
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain(), NoGain());
+		else
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain(), GainFloat{gainFactor});
+	}
+	void DataCallbackFixed(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk, std::false_type /* floatOutput */)
+	{
+		// Apply final output gain for non floating point output
+		const int32 gainFactor16_16 = mpt::saturate_round<int32>(gainFactor * (1<<16));
+		if(gainFactor16_16 == (1<<16))
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain(), NoGain());
+		else
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, GainFixed16_16{gainFactor16_16}, NoGain());
+	}
+public:
+	void DataCallback(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		DataCallbackFixed(MixSoundBuffer, channels, countChunk, std::is_floating_point<typename Tbuffer::sample_type>());
+	}
+	void DataCallback(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
+	{
+		// Apply final output gain before conversion
+		if(gainFactor == 1.0f)
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, NoGain());
+		else
+			Tbase::ConvertMixBuffer(MixSoundBuffer, channels, countChunk, GainFloat{gainFactor});
+	}
+};
+
+
+// Adds the rendered audio, scaled by gainFactor, to the existing contents of a floating point buffer.
+// Conversion from the mix format, gain and accumulation are done in a single pass without dithering or clipping.
+template<typename Tbuffer>
+class AudioReadTargetAccumulateBuffer
+	: public IAudioReadTarget
+{
+private:
+	std::size_t countRendered;
+	Tbuffer outputBuffer;
+	const float gainFactor;
+public:
+	AudioReadTargetAccumulateBuffer(Tbuffer buf, float gainFactor_)
+		: countRendered(0)
+		, outputBuffer(buf)
+		, gainFactor(gainFactor_)
+	{
+		STATIC_ASSERT(std::is_floating_point<typename Tbuffer::sample_type>::value);
+	}
+	std::size_t GetRenderedCount() const { return countRendered; }
 public:
 	void DataCallback(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
 	{
-		const std::size_t countRendered_ = Tbase::GetRenderedCount();
-		ApplyGainBeforeConversionIfAppropriateFixed<typename Tbuffer::sample_type>(MixSoundBuffer, channels, countChunk, gainFactor);
-		Tbase::DataCallback(MixSoundBuffer, channels, countChunk);
-		ApplyGainAfterConversionIfAppropriateFixed<typename Tbuffer::sample_type>(Tbase::outputBuffer, countRendered_, channels, countChunk, gainFactor);
+		const typename Tbuffer::sample_type factor = static_cast<typename Tbuffer::sample_type>(gainFactor) / static_cast<typename Tbuffer::sample_type>(1 << MixSampleIntTraits::mix_fractional_bits());
+		Tbuffer buf = advance_audio_buffer(outputBuffer, countRendered);
+		for(std::size_t i = 0; i < countChunk; ++i)
+		{
+			for(std::size_t channel = 0; channel < channels; ++channel)
+			{
+				buf(channel, i) += static_cast<typename Tbuffer::sample_type>(*MixSoundBuffer) * factor;
+				MixSoundBuffer++;
+			}
+		}
+		countRendered += countChunk;
 	}
 	void DataCallback(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk) override
 	{
-		ApplyGainBeforeConversionIfAppropriateFloat(MixSoundBuffer, channels, countChunk, gainFactor);
-		Tbase::DataCallback(MixSoundBuffer, channels, countChunk);
+		const typename Tbuffer::sample_type factor = static_cast<typename Tbuffer::sample_type>(gainFactor);
+		Tbuffer buf = advance_audio_buffer(outputBuffer, countRendered);
+		for(std::size_t i = 0; i < countChunk; ++i)
+		{
+			for(std::size_t channel = 0; channel < channels; ++channel)
+			{
+				buf(channel, i) += static_cast<typename Tbuffer::sample_type>(*MixSoundBuffer) * factor;
+				MixSoundBuffer++;
+			}
+		}
+		countRendered += countChunk;
+	}
+};
+
+
+// Converts the per-channel stems to separate interleaved stereo floating point buffers, the master mix is discarded.
+// Stems without an output buffer (nullptr) are skipped.
+class AudioReadTargetStemBuffers
+	: public IAudioReadTarget
+{
+private:
+	std::size_t countRendered;
+	float * const *stemBuffers;
+	const std::size_t numStemBuffers;
+	const float gainFactor;
+public:
+	AudioReadTargetStemBuffers(float * const *stemBuffers_, std::size_t numStemBuffers_, float gainFactor_)
+		: countRendered(0)
+		, stemBuffers(stemBuffers_)
+		, numStemBuffers(numStemBuffers_)
+		, gainFactor(gainFactor_)
+	{
+		return;
+	}
+	std::size_t GetRenderedCount() const { return countRendered; }
+private:
+	template<typename Tsample>
+	void ConvertStems(Tsample * const *StemMixBuffers, std::size_t numStems, std::size_t countChunk, float factor)
+	{
+		numStems = std::min(numStems, numStemBuffers);
+		for(std::size_t stem = 0; stem < numStems; ++stem)
+		{
+			if(!stemBuffers[stem])
+			{
+				continue;
+			}
+			const Tsample *in = StemMixBuffers[stem];
+			float *out = stemBuffers[stem] + countRendered * 2;
+			for(std::size_t i = 0; i < countChunk * 2; ++i)
+			{
+				out[i] = static_cast<float>(in[i]) * factor;
+			}
+		}
+		countRendered += countChunk;
+	}
+public:
+	void StemDataCallback(MixSampleInt * const *StemMixBuffers, std::size_t numStems, std::size_t countChunk) override
+	{
+		ConvertStems(StemMixBuffers, numStems, countChunk, gainFactor / static_cast<float>(1 << MixSampleIntTraits::mix_fractional_bits()));
+	}
+	void StemDataCallback(MixSampleFloat * const *StemMixBuffers, std::size_t numStems, std::size_t countChunk) override
+	{
+		ConvertStems(StemMixBuffers, numStems, countChunk, gainFactor);
 	}
+	void DataCallback(MixSampleInt *, std::size_t, std::size_t) override { }
+	void DataCallback(MixSampleFloat *, std::size_t, std::size_t) override { }
 };
 
 
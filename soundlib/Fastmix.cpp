@@ -23,6 +23,7 @@
 #include <cfloat>	// For FLT_EPSILON
 #include "plugins/PlugInterface.h"
 #include <algorithm>
+#include <bitset>
 
 
 OPENMPT_NAMESPACE_BEGIN
@@ -37,7 +38,7 @@ struct MixLoopState
 	SmpLength lookaheadStart;
 	uint32 maxSamples;
 
-	MixLoopState(const ModChannel &chn)
+	MixLoopState(const MixVoice &chn)
 	{
 		UpdateLookaheadPointers(chn);
 
@@ -51,7 +52,7 @@ struct MixLoopState
 	}
 
 	// Calculate offset of loop wrap-around buffer for this sample.
-	void UpdateLookaheadPointers(const ModChannel &chn)
+	void UpdateLookaheadPointers(const MixVoice &chn)
 	{
 		samplePointer = static_cast<const int8 *>(chn.pCurrentSample);
 		lookaheadPointer = nullptr;
@@ -84,8 +85,50 @@ struct MixLoopState
 		return static_cast<uint32>((to - from - SamplePosition(1)) / inc) + 1;
 	}
 
+	// For a voice that is played back from one of the decimated copies of its sample data, check if the next nSmpCount samples can be read from that copy.
+	// Near loop boundaries, the copies do not represent the looped signal, so the original sample data has to be used there.
+	// nSmpCount may be reduced so that the voice can switch between the two at the correct position.
+	// Returns the pyramid level to read from, or 0 for the original sample data.
+	static int GetPyramidSegment(const MixVoice &chn, int level, int32 &nSmpCount)
+	{
+		if(!chn.dwFlags[CHN_LOOP])
+			return level;
+		const SmpLength margin = SamplePyramid::GetMargin(level);
+		if(chn.nLoopEnd - chn.nLoopStart <= 2 * margin)
+			return 0;
+
+		const SamplePosition safeStart(chn.nLoopStart + margin, 0), safeEnd(chn.nLoopEnd - margin, 0);
+		const SamplePosition pos = chn.position;
+		SamplePosition inc = chn.increment;
+		uint32 safeCount;
+		if(inc.IsPositive())
+		{
+			if(pos >= safeEnd)
+				return 0;
+			if(pos < safeStart)
+			{
+				nSmpCount = std::min(nSmpCount, static_cast<int32>(DistanceToBufferLength(pos, safeStart, inc)));
+				return 0;
+			}
+			safeCount = DistanceToBufferLength(pos, safeEnd, inc);
+		} else
+		{
+			inc.Negate();
+			if(pos < safeStart)
+				return 0;
+			if(pos >= safeEnd)
+			{
+				nSmpCount = std::min(nSmpCount, static_cast<int32>(DistanceToBufferLength(safeEnd, pos + SamplePosition(1), inc)));
+				return 0;
+			}
+			safeCount = DistanceToBufferLength(safeStart, pos + SamplePosition(1), inc);
+		}
+		nSmpCount = std::min(nSmpCount, static_cast<int32>(safeCount));
+		return level;
+	}
+
 	// Check how many samples can be rendered without encountering loop or sample end, and also update loop position / direction
-	MPT_FORCEINLINE uint32 GetSampleCount(ModChannel &chn, uint32 nSamples, bool ITPingPongMode) const
+	MPT_FORCEINLINE uint32 GetSampleCount(MixVoice &chn, uint32 nSamples, bool ITPingPongMode) const
 	{
 		int32 nLoopStart = chn.dwFlags[CHN_LOOP] ? chn.nLoopStart : 0;
 		SamplePosition nInc = chn.increment;
@@ -271,6 +314,99 @@ struct MixLoopState
 };
 
 
+#ifdef MPT_INTMIXER
+
+// A voice that is rendered up to the end of the chunk after all other voices, together with voices using the same mix function.
+// Voices that were ramping at the start of the chunk only defer the part after the ramp, starting at offset.
+struct DeferredMixVoice
+{
+	MixVoiceLane lane;
+	uint32 functionNdx;
+	uint32 offset;
+};
+
+
+// Render deferred voices. Voices using the same mix function and offset are mixed MIXVOICES_PER_BATCH at a time, the remaining ones one by one.
+static void MixDeferredVoices(DeferredMixVoice *deferred, uint32 numDeferred, const CResampler &resampler, mixsample_t *mixBuffer, uint32 mixCount, CSoundFile::MixerStatistics &statistics)
+{
+	std::sort(deferred, deferred + numDeferred, [](const DeferredMixVoice &l, const DeferredMixVoice &r) { return l.functionNdx < r.functionNdx || (l.functionNdx == r.functionNdx && l.offset < r.offset); });
+
+	uint32 i = 0;
+	while(i < numDeferred)
+	{
+		const uint32 functionNdx = deferred[i].functionNdx;
+		const uint32 offset = deferred[i].offset;
+		mixsample_t *buffer = mixBuffer + offset * 2;
+		const uint32 count = mixCount - offset;
+		uint32 groupEnd = i;
+		while(groupEnd < numDeferred && deferred[groupEnd].functionNdx == functionNdx && deferred[groupEnd].offset == offset)
+		{
+			groupEnd++;
+		}
+
+		for(; i + MIXVOICES_PER_BATCH <= groupEnd; i += MIXVOICES_PER_BATCH)
+		{
+			MixVoiceLane lanes[MIXVOICES_PER_BATCH];
+			for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+			{
+				lanes[v] = deferred[i + v].lane;
+			}
+			const bool is16BitMono = (functionNdx & ~MixFuncTable::ndxLinear) == MixFuncTable::ndx16Bit;
+			if(!is16BitMono || !MultiVoiceMix16Mono(lanes, functionNdx == (MixFuncTable::ndx16Bit | MixFuncTable::ndxLinear), buffer, count))
+			{
+				MixFuncTable::MultiVoiceFunctions[functionNdx](lanes, resampler, buffer, count);
+			}
+			statistics.multiVoiceFrames += count * MIXVOICES_PER_BATCH;
+		}
+
+		// Not enough voices left for another batch
+		for(; i < groupEnd; i++)
+		{
+			MixVoice &chn = *deferred[i].lane.voice;
+			const SamplePosition endPos = chn.position;
+			const void *sample = chn.pCurrentSample;
+			chn.position = deferred[i].lane.position;
+			chn.pCurrentSample = deferred[i].lane.sample;
+
+			mixsample_t *pbufmax = buffer + (count * 2);
+			chn.nROfs = -*(pbufmax - 2);
+			chn.nLOfs = -*(pbufmax - 1);
+			MixFuncTable::Functions[functionNdx](chn, resampler, buffer, count);
+			chn.nROfs += *(pbufmax - 2);
+			chn.nLOfs += *(pbufmax - 1);
+			statistics.noRampFrames += count;
+
+			chn.position = endPos;
+			chn.pCurrentSample = sample;
+		}
+	}
+}
+
+#endif // MPT_INTMIXER
+
+
+void CSoundFile::SetStemRendering(bool enable)
+{
+	if(!enable)
+	{
+		m_StemMixBuffer.clear();
+		m_StemMixBuffers.clear();
+		m_StemOfsVol.clear();
+		return;
+	}
+	const CHANNELINDEX numStems = GetNumChannels();
+	if(m_StemMixBuffers.size() == numStems)
+		return;
+	m_StemMixBuffer.assign(numStems * MIXBUFFERSIZE * 2, 0);
+	m_StemMixBuffers.resize(numStems);
+	for(CHANNELINDEX stem = 0; stem < numStems; stem++)
+	{
+		m_StemMixBuffers[stem] = m_StemMixBuffer.data() + stem * MIXBUFFERSIZE * 2;
+	}
+	m_StemOfsVol.assign(numStems * 2, 0);
+}
+
+
 // Render count * number of channels samples
 void CSoundFile::CreateStereoMix(int count)
 {
@@ -282,19 +418,42 @@ void CSoundFile::CreateStereoMix(int count)
 	StereoFill(MixSoundBuffer, count, gnDryROfsVol, gnDryLOfsVol);
 	if(m_MixerSettings.gnChannels > 2) InitMixBuffer(MixRearBuffer, count*2);
 
+	const CHANNELINDEX numStems = static_cast<CHANNELINDEX>(m_StemMixBuffers.size());
+	for(CHANNELINDEX stem = 0; stem < numStems; stem++)
+	{
+		StereoFill(m_StemMixBuffers[stem], count, m_StemOfsVol[stem * 2], m_StemOfsVol[stem * 2 + 1]);
+	}
+
 	CHANNELINDEX nchmixed = 0;
 
 	const bool ITPingPongMode = m_playBehaviour[kITPingPongMode];
 
+	// Gather the hot state of all voices to be mixed into a compact array
+	MixVoice *voices = m_MixVoices.data();
+	for(uint32 nChn = 0; nChn < m_nMixChannels; nChn++)
+	{
+		m_PlayState.Chn[m_PlayState.ChnMix[nChn]].GetMixVoice(voices[nChn]);
+	}
+
+#ifdef MPT_INTMIXER
+	// Voices that can be rendered in one go for the whole chunk are deferred and then mixed together with other voices of the same format
+	DeferredMixVoice deferredVoices[MAX_CHANNELS];
+	uint32 numDeferredVoices = 0;
+#endif // MPT_INTMIXER
+
 	for(uint32 nChn = 0; nChn < m_nMixChannels; nChn++)
 	{
-		ModChannel &chn = m_PlayState.Chn[m_PlayState.ChnMix[nChn]];
+		MixVoice &chn = voices[nChn];
 
 		if(!chn.pCurrentSample) continue;
+		// Only needed for rarely accessed information that is not part of the voice render state
+		const ModChannel &channel = m_PlayState.Chn[m_PlayState.ChnMix[nChn]];
+
 		pOfsR = &gnDryROfsVol;
 		pOfsL = &gnDryLOfsVol;
 
-		uint32 functionNdx = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
+		const MixFuncTable::ResamplingIndex resamplingIndex = MixFuncTable::ResamplingModeToMixFlags(static_cast<ResamplingMode>(chn.resamplingMode));
+		uint32 functionNdx = resamplingIndex;
 		if(chn.dwFlags[CHN_16BIT]) functionNdx |= MixFuncTable::ndx16Bit;
 		if(chn.dwFlags[CHN_STEREO]) functionNdx |= MixFuncTable::ndxStereo;
 #ifndef NO_FILTER
@@ -302,41 +461,75 @@ void CSoundFile::CreateStereoMix(int count)
 #endif
 
 		mixsample_t *pbuffer = MixSoundBuffer;
-#ifndef NO_REVERB
-		if(((m_MixerSettings.DSPMask & SNDDSP_REVERB) && !chn.dwFlags[CHN_NOREVERB]) || chn.dwFlags[CHN_REVERB])
+#ifndef NO_PLUGINS
+		PLUGINDEX nMixPlugin = 0;
+#endif // NO_PLUGINS
+		if(numStems)
 		{
-			pbuffer = m_Reverb.GetReverbSendBuffer(count);
-			pOfsR = &m_Reverb.gnRvbROfsVol;
-			pOfsL = &m_Reverb.gnRvbLOfsVol;
-		}
+			// Mix NNA voices into the stem of the pattern channel they originate from.
+			// Voices without any pattern channel association stay in the master mix.
+			const CHANNELINDEX stem = (m_PlayState.ChnMix[nChn] < GetNumChannels()) ? m_PlayState.ChnMix[nChn] : static_cast<CHANNELINDEX>(channel.nMasterChn - 1);
+			if(stem < numStems)
+			{
+				pbuffer = m_StemMixBuffers[stem];
+				pOfsR = &m_StemOfsVol[stem * 2];
+				pOfsL = &m_StemOfsVol[stem * 2 + 1];
+			}
+		} else
+		{
+#ifndef NO_REVERB
+			if(((m_MixerSettings.DSPMask & SNDDSP_REVERB) && !chn.dwFlags[CHN_NOREVERB]) || chn.dwFlags[CHN_REVERB])
+			{
+				pbuffer = m_Reverb.GetReverbSendBuffer(count);
+				pOfsR = &m_Reverb.gnRvbROfsVol;
+				pOfsL = &m_Reverb.gnRvbLOfsVol;
+			}
 #endif
-		if(chn.dwFlags[CHN_SURROUND] && m_MixerSettings.gnChannels > 2)
-			pbuffer = MixRearBuffer;
+			if(chn.dwFlags[CHN_SURROUND] && m_MixerSettings.gnChannels > 2)
+				pbuffer = MixRearBuffer;
 
-		//Look for plugins associated with this implicit tracker channel.
+			//Look for plugins associated with this implicit tracker channel.
 #ifndef NO_PLUGINS
-		PLUGINDEX nMixPlugin = GetBestPlugin(m_PlayState.ChnMix[nChn], PrioritiseInstrument, RespectMutes);
+			nMixPlugin = GetBestPlugin(m_PlayState.ChnMix[nChn], PrioritiseInstrument, RespectMutes);
 
-		if ((nMixPlugin > 0) && (nMixPlugin <= MAX_MIXPLUGINS) && m_MixPlugins[nMixPlugin - 1].pMixPlugin != nullptr)
-		{
-			// Render into plugin buffer instead of global buffer
-			SNDMIXPLUGINSTATE &mixState = m_MixPlugins[nMixPlugin - 1].pMixPlugin->m_MixState;
-			if (mixState.pMixBuffer)
-			{
-				pbuffer = mixState.pMixBuffer;
-				pOfsR = &mixState.nVolDecayR;
-				pOfsL = &mixState.nVolDecayL;
-				if (!(mixState.dwFlags & SNDMIXPLUGINSTATE::psfMixReady))
+			if ((nMixPlugin > 0) && (nMixPlugin <= MAX_MIXPLUGINS) && m_MixPlugins[nMixPlugin - 1].pMixPlugin != nullptr)
+			{
+				// Render into plugin buffer instead of global buffer
+				SNDMIXPLUGINSTATE &mixState = m_MixPlugins[nMixPlugin - 1].pMixPlugin->m_MixState;
+				if (mixState.pMixBuffer)
 				{
-					StereoFill(pbuffer, count, *pOfsR, *pOfsL);
-					mixState.dwFlags |= SNDMIXPLUGINSTATE::psfMixReady;
+					pbuffer = mixState.pMixBuffer;
+					pOfsR = &mixState.nVolDecayR;
+					pOfsL = &mixState.nVolDecayL;
+					if (!(mixState.dwFlags & SNDMIXPLUGINSTATE::psfMixReady))
+					{
+						StereoFill(pbuffer, count, *pOfsR, *pOfsL);
+						mixState.dwFlags |= SNDMIXPLUGINSTATE::psfMixReady;
+					}
 				}
 			}
-		}
 #endif // NO_PLUGINS
+		}
 
 		MixLoopState mixLoopState(chn);
 
+		// Voices that skip over most of the sample data are read from a decimated copy to avoid aliasing, if enabled.
+		// The level is chosen so that the increment on that level is less than 2.
+		int pyramidLevel = 0;
+		const SamplePyramid *pyramid = nullptr;
+		if(m_Resampler.m_Settings.samplePyramids && chn.pModSample != nullptr && (resamplingIndex == MixFuncTable::ndxKaiser || resamplingIndex == MixFuncTable::ndxFIRFilter))
+		{
+			const uint64 increment = static_cast<uint64>(std::abs(chn.increment.GetRaw()));
+			while(pyramidLevel < SamplePyramid::numLevels && increment >= (uint64(2) << (32 + pyramidLevel)))
+				pyramidLevel++;
+			if(pyramidLevel)
+			{
+				pyramid = GetSamplePyramid(*chn.pModSample);
+				if(pyramid == nullptr || pyramid->source != mixLoopState.samplePointer)
+					pyramidLevel = 0;
+			}
+		}
+
 		////////////////////////////////////////////////////
 		CHANNELINDEX naddmix = 0;
 		int nsamples = count;
@@ -365,6 +558,12 @@ void CSoundFile::CreateStereoMix(int count)
 				break;
 			}
 
+			int segmentLevel = 0;
+			if(pyramidLevel && chn.pCurrentSample == mixLoopState.samplePointer)
+			{
+				segmentLevel = MixLoopState::GetPyramidSegment(chn, pyramidLevel, nSmpCount);
+			}
+
 			// Should we mix this channel ?
 			if((nchmixed >= m_MixerSettings.m_nMaxMixChannels)				// Too many channels
 				|| (!chn.nRampLength && !(chn.leftVol | chn.rightVol)))		// Channel is completely silent
@@ -386,6 +585,17 @@ void CSoundFile::CreateStereoMix(int count)
 				}
 			}
 #endif
+#ifdef MPT_INTMIXER
+			else if(nSmpCount == nsamples && !chn.nRampLength && !segmentLevel && pbuffer == MixSoundBuffer + (count - nsamples) * 2 && (nsamples == count || m_MixerPaths.deferPostRampTails) && MixFuncTable::MultiVoiceFunctions[functionNdx] != nullptr)
+			{
+				// Defer mixing until we know which other voices can be mixed together with this one.
+				// This also applies to the rest of the chunk after a volume ramp has finished.
+				deferredVoices[numDeferredVoices++] = { { &chn, chn.pCurrentSample, chn.position }, functionNdx, static_cast<uint32>(count - nsamples) };
+				chn.position += chn.increment * nSmpCount;
+				pbuffer += nSmpCount * 2;
+				naddmix = 1;
+			}
+#endif // MPT_INTMIXER
 			else
 			{
 				// Do mixing
@@ -396,7 +606,25 @@ void CSoundFile::CreateStereoMix(int count)
 #ifdef MPT_BUILD_DEBUG
 				SamplePosition targetpos = chn.position + chn.increment * nSmpCount;
 #endif
-				MixFuncTable::Functions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+				if(segmentLevel)
+				{
+					// Read from the decimated sample data, at a correspondingly lower position and increment
+					const SamplePosition position = chn.position, increment = chn.increment;
+					chn.pCurrentSample = pyramid->GetLevel(segmentLevel);
+					chn.position = SamplePosition(position.GetRaw() / (int64(1) << segmentLevel));
+					chn.increment = SamplePosition(increment.GetRaw() / (int64(1) << segmentLevel));
+					MixFuncTable::Functions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+					chn.pCurrentSample = mixLoopState.samplePointer;
+					chn.position = position + increment * nSmpCount;
+					chn.increment = increment;
+				} else
+				{
+					MixFuncTable::Functions[functionNdx | (chn.nRampLength ? MixFuncTable::ndxRamp : 0)](chn, m_Resampler, pbuffer, nSmpCount);
+				}
+				if(chn.nRampLength)
+					m_MixerStatistics.rampFrames += nSmpCount;
+				else
+					m_MixerStatistics.noRampFrames += nSmpCount;
 #ifdef MPT_BUILD_DEBUG
 				MPT_ASSERT(chn.position.GetUInt() == targetpos.GetUInt());
 #endif
@@ -414,10 +642,10 @@ void CSoundFile::CreateStereoMix(int count)
 				{
 					// Ramping is done
 					chn.nRampLength = 0;
-					chn.leftVol = chn.newLeftVol;
-					chn.rightVol = chn.newRightVol;
+					chn.leftVol = channel.newLeftVol;
+					chn.rightVol = channel.newRightVol;
 					chn.rightRamp = chn.leftRamp = 0;
-					if(chn.dwFlags[CHN_NOTEFADE] && !chn.nFadeOutVol)
+					if(chn.dwFlags[CHN_NOTEFADE] && !channel.nFadeOutVol)
 					{
 						chn.nLength = 0;
 						chn.pCurrentSample = nullptr;
@@ -429,13 +657,13 @@ void CSoundFile::CreateStereoMix(int count)
 			}
 
 			const bool pastLoopEnd = chn.position.GetUInt() >= chn.nLoopEnd && chn.dwFlags[CHN_LOOP];
-			const bool pastSampleEnd = chn.position.GetUInt() >= chn.nLength && !chn.dwFlags[CHN_LOOP] && chn.nLength && !chn.nMasterChn;
-			const bool doSampleSwap = m_playBehaviour[kMODSampleSwap] && chn.nNewIns && chn.nNewIns <= GetNumSamples() && chn.pModSample != &Samples[chn.nNewIns];
+			const bool pastSampleEnd = chn.position.GetUInt() >= chn.nLength && !chn.dwFlags[CHN_LOOP] && chn.nLength && !channel.nMasterChn;
+			const bool doSampleSwap = m_playBehaviour[kMODSampleSwap] && channel.nNewIns && channel.nNewIns <= GetNumSamples() && chn.pModSample != &Samples[channel.nNewIns];
 			if((pastLoopEnd || pastSampleEnd) && doSampleSwap)
 			{
 				// ProTracker compatibility: Instrument changes without a note do not happen instantly, but rather when the sample loop has finished playing.
 				// Test case: PTInstrSwap.mod, PTSwapNoLoop.mod
-				const ModSample &smp = Samples[chn.nNewIns];
+				const ModSample &smp = Samples[channel.nNewIns];
 				chn.pModSample = &smp;
 				chn.pCurrentSample = smp.samplev();
 				chn.dwFlags = (chn.dwFlags & CHN_CHANNELFLAGS) | smp.uFlags;
@@ -467,10 +695,123 @@ void CSoundFile::CreateStereoMix(int count)
 		}
 #endif // NO_PLUGINS
 	}
+
+#ifdef MPT_INTMIXER
+	if(numDeferredVoices)
+	{
+		MixDeferredVoices(deferredVoices, numDeferredVoices, m_Resampler, MixSoundBuffer, count, m_MixerStatistics);
+	}
+#endif // MPT_INTMIXER
+
+	// Write back the updated voice state
+	for(uint32 nChn = 0; nChn < m_nMixChannels; nChn++)
+	{
+		m_PlayState.Chn[m_PlayState.ChnMix[nChn]].SetMixVoice(voices[nChn]);
+	}
+
 	m_nMixStat = std::max(m_nMixStat, nchmixed);
 }
 
 
+#ifndef NO_PLUGINS
+static bool IsSilentBuffer(const float *buffer, uint32 numFrames)
+{
+	for(uint32 i = 0; i < numFrames; i++)
+	{
+		if(buffer[i] >= FLT_EPSILON || buffer[i] <= -FLT_EPSILON)
+			return false;
+	}
+	return true;
+}
+
+
+// Process a plugin into the given output buffers, or pass its input through if it is bypassed or suspended
+static void ProcessPlugin(SNDMIXPLUGIN &plugin, float *pOutL, float *pOutR, uint32 nCount, bool positionChanged, uint32 mixingFreq)
+{
+	IMixPlugin *pObject = plugin.pMixPlugin;
+	SNDMIXPLUGINSTATE &state = pObject->m_MixState;
+	if(plugin.IsBypassed() || (state.dwFlags & SNDMIXPLUGINSTATE::psfSilenceBypass))
+	{
+		const float * const pInL = pObject->m_mixBuffer.GetInputBuffer(0);
+		const float * const pInR = pObject->m_mixBuffer.GetInputBuffer(1);
+		for (uint32 i=0; i<nCount; i++)
+		{
+			pOutL[i] += pInL[i];
+			pOutR[i] += pInR[i];
+		}
+	} else
+	{
+		if(positionChanged)
+			pObject->PositionChanged();
+		pObject->Process(pOutL, pOutR, nCount);
+
+		state.inputSilenceCount += nCount;
+		const uint32 tailSize = pObject->GetTailSize();
+		if(tailSize != IMixPlugin::InfiniteTail && state.inputSilenceCount >= tailSize)
+		{
+			// The plugin's tail has fully decayed, so it can be suspended until it receives new input.
+			// Its output is inaudible from now on, so this is done whether auto-suspend is enabled or not.
+			bool isSilent = true;
+			const int numOutputs = std::min(pObject->GetNumOutputChannels(), 2);
+			for(int i = 0; i < numOutputs && isSilent; i++)
+			{
+				isSilent = IsSilentBuffer(pObject->m_mixBuffer.GetOutputBuffer(i), nCount);
+			}
+			if(isSilent)
+			{
+				state.dwFlags |= SNDMIXPLUGINSTATE::psfSilenceBypass;
+			}
+		} else if(plugin.IsAutoSuspendable() && pObject->GetNumOutputChannels() > 0 && state.inputSilenceCount >= mixingFreq * 4)
+		{
+			// Without a known tail, only suspend plugins that have opted in once the mix has been silent for a while.
+			if(IsSilentBuffer(pOutL, nCount) && IsSilentBuffer(pOutR, nCount))
+			{
+				state.dwFlags |= SNDMIXPLUGINSTATE::psfSilenceBypass;
+			} else
+			{
+				state.inputSilenceCount = 0;
+			}
+		}
+	}
+	state.dwFlags &= ~SNDMIXPLUGINSTATE::psfHasInput;
+}
+
+
+// Process the plugins of a chain that does not depend on any other plugins (see PluginGraph).
+// This may run on a worker thread. The last plugin writes into the chain's own output buffer.
+void CSoundFile::ProcessPluginChain(PluginGraph::Chain &chain, const std::bitset<MAX_MIXPLUGINS> &hasPluginInput, uint32 nCount, bool positionChanged)
+{
+	chain.hasOutput = false;
+	for(PLUGINDEX plug : chain.plugins)
+	{
+		SNDMIXPLUGIN &plugin = m_MixPlugins[plug];
+		SNDMIXPLUGINSTATE &state = plugin.pMixPlugin->m_MixState;
+		if(!plugin.pMixPlugin->ShouldProcessSilence() && !(state.dwFlags & SNDMIXPLUGINSTATE::psfHasInput) && !hasPluginInput[plug])
+		{
+			continue;
+		}
+
+		float *pOutL, *pOutR;
+		if(plug == chain.plugins.back())
+		{
+			pOutL = chain.output.data();
+			pOutR = chain.output.data() + MIXBUFFERSIZE;
+			std::fill(pOutL, pOutL + nCount, 0.0f);
+			std::fill(pOutR, pOutR + nCount, 0.0f);
+			chain.hasOutput = true;
+		} else
+		{
+			IMixPlugin *outPlugin = m_MixPlugins[plugin.GetOutputPlugin()].pMixPlugin;
+			if(!(state.dwFlags & SNDMIXPLUGINSTATE::psfSilenceBypass)) outPlugin->ResetSilence();
+			pOutL = outPlugin->m_mixBuffer.GetInputBuffer(0);
+			pOutR = outPlugin->m_mixBuffer.GetInputBuffer(1);
+		}
+		ProcessPlugin(plugin, pOutL, pOutR, nCount, positionChanged, m_MixerSettings.gdwMixingFreq);
+	}
+}
+#endif // NO_PLUGINS
+
+
 void CSoundFile::ProcessPlugins(uint32 nCount)
 {
 #ifndef NO_PLUGINS
@@ -482,10 +823,18 @@ void CSoundFile::ProcessPlugins(uint32 nCount)
 	const float FloatToInt = m_PlayConfig.getFloatToInt();
 #endif // MPT_INTMIXER
 
+	// Plugins which receive input from a plugin processed before them
+	std::bitset<MAX_MIXPLUGINS> hasPluginInput;
+
 	// Setup float inputs from samples
 	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
 	{
 		SNDMIXPLUGIN &plugin = m_MixPlugins[plug];
+		const PLUGINDEX output = plugin.GetOutputPlugin();
+		if(output > plug && output < MAX_MIXPLUGINS)
+		{
+			hasPluginInput.set(output);
+		}
 		if(plugin.pMixPlugin != nullptr
 			&& plugin.pMixPlugin->m_MixState.pMixBuffer != nullptr
 			&& plugin.pMixPlugin->m_mixBuffer.Ok())
@@ -545,6 +894,23 @@ void CSoundFile::ProcessPlugins(uint32 nCount)
 
 	const bool positionChanged = HasPositionChanged();
 
+	// Process independent plugin chains on the worker threads first.
+	// The output of each chain is added to the mix below, when the loop reaches the chain's last plugin.
+	bool chainsProcessed = false;
+	if(m_PluginWorkers)
+	{
+		m_PluginGraph.Update(m_MixPlugins);
+		auto &chains = m_PluginGraph.GetChains();
+		if(!chains.empty())
+		{
+			m_PluginWorkers->Run(static_cast<uint32>(chains.size()), [&](uint32 chain)
+			{
+				ProcessPluginChain(chains[chain], hasPluginInput, nCount, positionChanged);
+			});
+			chainsProcessed = true;
+		}
+	}
+
 	// Process Plugins
 	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
 	{
@@ -553,21 +919,28 @@ void CSoundFile::ProcessPlugins(uint32 nCount)
 			&& plugin.pMixPlugin->m_MixState.pMixBuffer != nullptr
 			&& plugin.pMixPlugin->m_mixBuffer.Ok())
 		{
-			IMixPlugin *pObject = plugin.pMixPlugin;
-			if(!plugin.IsMasterEffect() && !plugin.pMixPlugin->ShouldProcessSilence() && !(plugin.pMixPlugin->m_MixState.dwFlags & SNDMIXPLUGINSTATE::psfHasInput))
+			if(chainsProcessed && m_PluginGraph.GetChainIndex(plug) != PLUGINDEX_INVALID)
 			{
-				// If plugin has no inputs and isn't a master plugin, we shouldn't let it process silence if possible.
-				// I have yet to encounter a VST plugin which actually sets this flag.
-				bool hasInput = false;
-				for(PLUGINDEX inPlug = 0; inPlug < plug; inPlug++)
+				const PluginGraph::Chain &chain = m_PluginGraph.GetChains()[m_PluginGraph.GetChainIndex(plug)];
+				if(chain.hasOutput && chain.plugins.back() == plug)
 				{
-					if(m_MixPlugins[inPlug].GetOutputPlugin() == plug)
+					const float *chainL = chain.output.data();
+					const float *chainR = chain.output.data() + MIXBUFFERSIZE;
+					for(uint32 i = 0; i < nCount; i++)
 					{
-						hasInput = true;
-						break;
+						pMixL[i] += chainL[i];
+						pMixR[i] += chainR[i];
 					}
 				}
-				if(!hasInput)
+				continue;
+			}
+
+			IMixPlugin *pObject = plugin.pMixPlugin;
+			if(!plugin.IsMasterEffect() && !plugin.pMixPlugin->ShouldProcessSilence() && !(plugin.pMixPlugin->m_MixState.dwFlags & SNDMIXPLUGINSTATE::psfHasInput))
+			{
+				// If plugin has no inputs and isn't a master plugin, we shouldn't let it process silence if possible.
+				// I have yet to encounter a VST plugin which actually sets this flag.
+				if(!hasPluginInput[plug])
 				{
 					continue;
 				}
@@ -652,44 +1025,7 @@ void CSoundFile::ProcessPlugins(uint32 nCount)
 				}
 			}
 
-			if(plugin.IsBypassed() || (plugin.IsAutoSuspendable() && (state.dwFlags & SNDMIXPLUGINSTATE::psfSilenceBypass)))
-			{
-				const float * const pInL = plugInputL;
-				const float * const pInR = plugInputR;
-				for (uint32 i=0; i<nCount; i++)
-				{
-					pOutL[i] += pInL[i];
-					pOutR[i] += pInR[i];
-				}
-			} else
-			{
-				if(positionChanged)
-					pObject->PositionChanged();
-				pObject->Process(pOutL, pOutR, nCount);
-
-				state.inputSilenceCount += nCount;
-				if(plugin.IsAutoSuspendable() && pObject->GetNumOutputChannels() > 0 && state.inputSilenceCount >= m_MixerSettings.gdwMixingFreq * 4)
-				{
-					bool isSilent = true;
-					for(uint32 i = 0; i < nCount; i++)
-					{
-						if(pOutL[i] >= FLT_EPSILON || pOutL[i] <= -FLT_EPSILON
-							|| pOutR[i] >= FLT_EPSILON || pOutR[i] <= -FLT_EPSILON)
-						{
-							isSilent = false;
-							break;
-						}
-					}
-					if(isSilent)
-					{
-						state.dwFlags |= SNDMIXPLUGINSTATE::psfSilenceBypass;
-					} else
-					{
-						state.inputSilenceCount = 0;
-					}
-				}
-			}
-			state.dwFlags &= ~SNDMIXPLUGINSTATE::psfHasInput;
+			ProcessPlugin(plugin, pOutL, pOutR, nCount, positionChanged, m_MixerSettings.gdwMixingFreq);
 		}
 	}
 #ifdef MPT_INTMIXER
@@ -41,9 +41,9 @@ typedef IntToFloatTraits<2, 2, mixsample_t, int16, -int16_min> Int16SToFloatS;
 template<class Traits>
 struct LinearInterpolation
 {
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &) { }
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const uint32 posLo)
 	{
@@ -64,8 +64,8 @@ struct LinearInterpolation
 template<class Traits>
 struct FastSincInterpolation
 {
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &) { }
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const uint32 posLo)
 	{
@@ -89,13 +89,13 @@ struct PolyphaseInterpolation
 {
 	const typename Traits::output_t *sinc;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn, const CResampler &resampler)
+	MPT_FORCEINLINE void Start(const MixVoice &chn, const CResampler &resampler)
 	{
 		sinc = (((chn.increment > SamplePosition(0x130000000ll)) || (chn.increment < -SamplePosition(-0x130000000ll))) ?
 			(((chn.increment > SamplePosition(0x180000000ll)) || (chn.increment < SamplePosition(-0x180000000ll))) ? resampler.gDownsample2x : resampler.gDownsample13x) : resampler.gKaiserSinc);
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const uint32 posLo)
 	{
@@ -123,12 +123,12 @@ struct FIRFilterInterpolation
 {
 	const typename Traits::output_t *WFIRlut;
 
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &resampler)
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &resampler)
 	{
-		WFIRlut = resampler.m_WindowedFIR.lut;
+		WFIRlut = resampler.m_WindowedFIR.GetLUT();
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const uint32 posLo)
 	{
@@ -159,13 +159,13 @@ struct NoRamp
 {
 	typename Traits::output_t lVol, rVol;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		lVol = static_cast<Traits::output_t>(chn.leftVol) * (1.0f / 4096.0f);
 		rVol = static_cast<Traits::output_t>(chn.rightVol) * (1.0f / 4096.0f);
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 };
 
 
@@ -173,13 +173,13 @@ struct Ramp
 {
 	int32 lRamp, rRamp;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		lRamp = chn.rampLeftVol;
 		rRamp = chn.rampRightVol;
 	}
 
-	MPT_FORCEINLINE void End(ModChannel &chn)
+	MPT_FORCEINLINE void End(MixVoice &chn)
 	{
 		chn.rampLeftVol = lRamp; chn.leftVol = lRamp >> VOLUMERAMPPRECISION;
 		chn.rampRightVol = rRamp; chn.rightVol = rRamp >> VOLUMERAMPPRECISION;
@@ -191,7 +191,7 @@ struct Ramp
 template<class Traits>
 struct MixMonoFastNoRamp : public NoRamp<Traits>
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &chn, typename Traits::output_t * const outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &chn, typename Traits::output_t * const outBuffer)
 	{
 		typename Traits::output_t vol = outSample[0] * lVol;
 		for(int i = 0; i < Traits::numChannelsOut; i++)
@@ -205,7 +205,7 @@ struct MixMonoFastNoRamp : public NoRamp<Traits>
 template<class Traits>
 struct MixMonoNoRamp : public NoRamp<Traits>
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &, typename Traits::output_t * const outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &, typename Traits::output_t * const outBuffer)
 	{
 		outBuffer[0] += outSample[0] * lVol;
 		outBuffer[1] += outSample[0] * rVol;
@@ -216,7 +216,7 @@ struct MixMonoNoRamp : public NoRamp<Traits>
 template<class Traits>
 struct MixMonoRamp : public Ramp
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &chn, typename Traits::output_t * const outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &chn, typename Traits::output_t * const outBuffer)
 	{
 		// TODO volume is not float, can we optimize this?
 		lRamp += chn.leftRamp;
@@ -230,7 +230,7 @@ struct MixMonoRamp : public Ramp
 template<class Traits>
 struct MixStereoNoRamp : public NoRamp<Traits>
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &, typename Traits::output_t * const outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &, typename Traits::output_t * const outBuffer)
 	{
 		outBuffer[0] += outSample[0] * lVol;
 		outBuffer[1] += outSample[1] * rVol;
@@ -241,7 +241,7 @@ struct MixStereoNoRamp : public NoRamp<Traits>
 template<class Traits>
 struct MixStereoRamp : public Ramp
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &chn, typename Traits::output_t * const outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &chn, typename Traits::output_t * const outBuffer)
 	{
 		// TODO volume is not float, can we optimize this?
 		lRamp += chn.leftRamp;
@@ -259,10 +259,10 @@ struct MixStereoRamp : public Ramp
 template<class Traits>
 struct NoFilter
 {
-	MPT_FORCEINLINE void Start(const ModChannel &) { }
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &, const ModChannel &) { }
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &, const MixVoice &) { }
 };
 
 
@@ -273,7 +273,7 @@ struct ResonantFilter
 	// Filter history
 	typename Traits::output_t fy[Traits::numChannelsIn][2];
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		for(int i = 0; i < Traits::numChannelsIn; i++)
 		{
@@ -282,7 +282,7 @@ struct ResonantFilter
 		}
 	}
 
-	MPT_FORCEINLINE void End(ModChannel &chn)
+	MPT_FORCEINLINE void End(MixVoice &chn)
 	{
 		for(int i = 0; i < Traits::numChannelsIn; i++)
 		{
@@ -294,7 +294,7 @@ struct ResonantFilter
 	// Filter values are clipped to double the input range
 #define ClipFilter(x) Clamp(x, static_cast<Traits::output_t>(-2.0f), static_cast<Traits::output_t>(2.0f))
 
-	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const ModChannel &chn)
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const MixVoice &chn)
 	{
 		static_assert(static_cast<int>(Traits::numChannelsIn) <= static_cast<int>(Traits::numChannelsOut), "Too many input channels");
 
@@ -54,16 +54,16 @@ struct AmigaBlepInterpolation
 	int numSteps;
 	bool filter;
 
-	MPT_FORCEINLINE void Start(ModChannel &chn, const CResampler &)
+	MPT_FORCEINLINE void Start(MixVoice &chn, const CResampler &)
 	{
-		paula = &chn.paulaState;
+		paula = chn.paulaState;
 		numSteps = paula->numSteps;
 		filter = chn.dwFlags[CHN_AMIGAFILTER];
 		if(numSteps)
 			subIncrement = chn.increment / paula->numSteps;
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
 	{
@@ -104,9 +104,9 @@ struct AmigaBlepInterpolation
 template<class Traits>
 struct LinearInterpolation
 {
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &) { }
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
 	{
@@ -127,8 +127,8 @@ struct LinearInterpolation
 template<class Traits>
 struct FastSincInterpolation
 {
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &) { }
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
 	{
@@ -152,7 +152,7 @@ struct PolyphaseInterpolation
 {
 	const SINC_TYPE *sinc;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn, const CResampler &resampler)
+	MPT_FORCEINLINE void Start(const MixVoice &chn, const CResampler &resampler)
 	{
 		#ifdef MODPLUG_TRACKER
 			// Otherwise causes "warning C4100: 'resampler' : unreferenced formal parameter"
@@ -164,7 +164,7 @@ struct PolyphaseInterpolation
 			(((chn.increment > SamplePosition(0x180000000ll)) || (chn.increment < SamplePosition(-0x180000000ll))) ? resampler.gDownsample2x : resampler.gDownsample13x) : resampler.gKaiserSinc);
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
 	{
@@ -192,12 +192,12 @@ struct FIRFilterInterpolation
 {
 	const int16 *WFIRlut;
 
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &resampler)
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &resampler)
 	{
-		WFIRlut = resampler.m_WindowedFIR.lut;
+		WFIRlut = resampler.m_WindowedFIR.GetLUT();
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const MPT_RESTRICT inBuffer, const uint32 posLo)
 	{
@@ -230,13 +230,13 @@ struct NoRamp
 {
 	typename Traits::output_t lVol, rVol;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		lVol = chn.leftVol;
 		rVol = chn.rightVol;
 	}
 
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 };
 
 
@@ -244,13 +244,13 @@ struct Ramp
 {
 	int32 lRamp, rRamp;
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		lRamp = chn.rampLeftVol;
 		rRamp = chn.rampRightVol;
 	}
 
-	MPT_FORCEINLINE void End(ModChannel &chn)
+	MPT_FORCEINLINE void End(MixVoice &chn)
 	{
 		chn.rampLeftVol = lRamp; chn.leftVol = lRamp >> VOLUMERAMPPRECISION;
 		chn.rampRightVol = rRamp; chn.rightVol = rRamp >> VOLUMERAMPPRECISION;
@@ -263,7 +263,7 @@ template<class Traits>
 struct MixMonoFastNoRamp : public NoRamp<Traits>
 {
 	typedef NoRamp<Traits> base_t;
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
 	{
 		typename Traits::output_t vol = outSample[0] * base_t::lVol;
 		for(int i = 0; i < Traits::numChannelsOut; i++)
@@ -278,7 +278,7 @@ template<class Traits>
 struct MixMonoNoRamp : public NoRamp<Traits>
 {
 	typedef NoRamp<Traits> base_t;
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
 	{
 		outBuffer[0] += outSample[0] * base_t::lVol;
 		outBuffer[1] += outSample[0] * base_t::rVol;
@@ -289,7 +289,7 @@ struct MixMonoNoRamp : public NoRamp<Traits>
 template<class Traits>
 struct MixMonoRamp : public Ramp
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &chn, typename Traits::output_t * const MPT_RESTRICT outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &chn, typename Traits::output_t * const MPT_RESTRICT outBuffer)
 	{
 		lRamp += chn.leftRamp;
 		rRamp += chn.rightRamp;
@@ -303,7 +303,7 @@ template<class Traits>
 struct MixStereoNoRamp : public NoRamp<Traits>
 {
 	typedef NoRamp<Traits> base_t;
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &, typename Traits::output_t * const MPT_RESTRICT outBuffer)
 	{
 		outBuffer[0] += outSample[0] * base_t::lVol;
 		outBuffer[1] += outSample[1] * base_t::rVol;
@@ -314,7 +314,7 @@ struct MixStereoNoRamp : public NoRamp<Traits>
 template<class Traits>
 struct MixStereoRamp : public Ramp
 {
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const ModChannel &chn, typename Traits::output_t * const MPT_RESTRICT outBuffer)
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &outSample, const MixVoice &chn, typename Traits::output_t * const MPT_RESTRICT outBuffer)
 	{
 		lRamp += chn.leftRamp;
 		rRamp += chn.rightRamp;
@@ -331,10 +331,10 @@ struct MixStereoRamp : public Ramp
 template<class Traits>
 struct NoFilter
 {
-	MPT_FORCEINLINE void Start(const ModChannel &) { }
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
-	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &, const ModChannel &) { }
+	MPT_FORCEINLINE void operator() (const typename Traits::outbuf_t &, const MixVoice &) { }
 };
 
 
@@ -345,7 +345,7 @@ struct ResonantFilter
 	// Filter history
 	typename Traits::output_t fy[Traits::numChannelsIn][2];
 
-	MPT_FORCEINLINE void Start(const ModChannel &chn)
+	MPT_FORCEINLINE void Start(const MixVoice &chn)
 	{
 		for(int i = 0; i < Traits::numChannelsIn; i++)
 		{
@@ -354,7 +354,7 @@ struct ResonantFilter
 		}
 	}
 
-	MPT_FORCEINLINE void End(ModChannel &chn)
+	MPT_FORCEINLINE void End(MixVoice &chn)
 	{
 		for(int i = 0; i < Traits::numChannelsIn; i++)
 		{
@@ -368,7 +368,7 @@ struct ResonantFilter
 	// Filter values are clipped to double the input range
 #define ClipFilter(x) Clamp<typename Traits::output_t, typename Traits::output_t>(x, int16_min * 2 * MIXING_FILTER_PREAMP, int16_max * 2 * MIXING_FILTER_PREAMP)
 
-	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const ModChannel &chn)
+	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const MixVoice &chn)
 	{
 		static_assert(static_cast<int>(Traits::numChannelsIn) <= static_cast<int>(Traits::numChannelsOut), "Too many input channels");
 
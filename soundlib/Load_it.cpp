@@ -891,7 +891,8 @@ bool CSoundFile::ReadIT(FileReader &file, ModLoadingFlags loadFlags)
 			|| !file.Skip(4))
 			continue;
 
-		FileReader patternData = file.ReadChunk(len);
+		FileReader::PinnedRawDataView patternDataView = file.ReadPinnedRawDataView(len);
+		MemoryFileReader patternData(patternDataView.span());
 		ROWINDEX row = 0;
 		std::vector<uint8> chnMask(GetNumChannels());
 
@@ -1000,11 +1001,15 @@ bool CSoundFile::ReadIT(FileReader &file, ModLoadingFlags loadFlags)
 			|| !Patterns.Insert(pat, numRows))
 			continue;
 			
-		FileReader patternData = file.ReadChunk(len);
+		FileReader::PinnedRawDataView patternDataView = file.ReadPinnedRawDataView(len);
+		MemoryFileReader patternData(patternDataView.span());
 
 		// Now (after the Insert() call), we can read the pattern name.
 		CopyPatternName(Patterns[pat], patNames);
 
+		if(loadFlags & loadMetadataOnly)
+			continue;
+
 		std::vector<uint8> chnMask(GetNumChannels());
 		std::vector<ModCommand> lastValue(GetNumChannels(), ModCommand::Empty());
 
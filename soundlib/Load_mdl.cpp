@@ -658,14 +658,17 @@ bool CSoundFile::ReadMDL(FileReader &file, ModLoadingFlags loadFlags)
 	}
 
 	// Read pattern tracks
-	std::vector<FileReader> tracks;
+	FileReader::PinnedRawDataView tracksView;
+	std::vector<MemoryFileReader> tracks;
 	if((loadFlags & loadPatternData) && (chunk = chunks.GetChunk(MDLChunk::idTracks)).IsValid())
 	{
-		uint32 numTracks = chunk.ReadUint16LE();
+		tracksView = chunk.GetPinnedRawDataView();
+		MemoryFileReader tracksChunk(tracksView.span());
+		uint32 numTracks = tracksChunk.ReadUint16LE();
 		tracks.resize(numTracks + 1);
 		for(uint32 i = 1; i <= numTracks; i++)
 		{
-			tracks[i] = chunk.ReadChunk(chunk.ReadUint16LE());
+			tracks[i] = tracksChunk.ReadChunk(tracksChunk.ReadUint16LE());
 		}
 	}
 
@@ -722,7 +725,7 @@ bool CSoundFile::ReadMDL(FileReader &file, ModLoadingFlags loadFlags)
 				if(!trkNum || trkNum >= tracks.size() || chn >= m_nChannels)
 					continue;
 
-				FileReader &track = tracks[trkNum];
+				MemoryFileReader &track = tracks[trkNum];
 				track.Rewind();
 				ROWINDEX row = 0;
 				while(row < numRows && track.CanRead(1))
@@ -519,7 +519,8 @@ static uint32 ReadSample(FileReader &file, MODSampleHeader &sampleHeader, ModSam
 
 
 // Parse the order list to determine how many patterns are used in the file.
-static PATTERNINDEX GetNumPatterns(FileReader &file, ModSequence &Order, ORDERINDEX numOrders, SmpLength totalSampleLen, CHANNELINDEX &numChannels, bool checkForWOW)
+// If useFileSize is false, heuristics that compare the expected and actual file size are skipped (for loading unseekable streams progressively).
+static PATTERNINDEX GetNumPatterns(FileReader &file, ModSequence &Order, ORDERINDEX numOrders, SmpLength totalSampleLen, CHANNELINDEX &numChannels, bool checkForWOW, bool useFileSize)
 {
 	PATTERNINDEX numPatterns = 0;         // Total number of patterns in file (determined by going through the whole order list) with pattern number < 128
 	PATTERNINDEX officialPatterns = 0;    // Number of patterns only found in the "official" part of the order list (i.e. order positions < claimed order length)
@@ -548,7 +549,7 @@ static PATTERNINDEX GetNumPatterns(FileReader &file, ModSequence &Order, ORDERIN
 	const size_t patternStartOffset = file.GetPosition();
 	const size_t sizeWithoutPatterns = totalSampleLen + patternStartOffset;
 
-	if(checkForWOW && sizeWithoutPatterns + numPatterns * 8 * 256 == file.GetLength())
+	if(checkForWOW && useFileSize && sizeWithoutPatterns + numPatterns * 8 * 256 == file.GetLength())
 	{
 		// Check if this is a Mod's Grave WOW file... Never seen one of those, but apparently they *do* exist.
 		// WOW files should use the M.K. magic but are actually 8CHN files.
@@ -596,13 +597,14 @@ static PATTERNINDEX GetNumPatterns(FileReader &file, ModSequence &Order, ORDERIN
 	// correctly when also loading the inofficial patterns.
 	// See also the above check for ambiguities with SoundTracker modules.
 	// Keep this assertion in the code to find potential other broken MODs.
-	if(numPatterns != officialPatterns && sizeWithoutPatterns + officialPatterns * numChannels * 256 == file.GetLength())
+	// The file size is not known in advance when loading progressively from an unseekable stream.
+	if(numPatterns != officialPatterns && useFileSize && sizeWithoutPatterns + officialPatterns * numChannels * 256 == file.GetLength())
 	{
 		MPT_ASSERT(false);
 		//numPatterns = officialPatterns;
 	} else
 #endif
-	if(numPatternsIllegal > numPatterns && sizeWithoutPatterns + numPatternsIllegal * numChannels * 256 == file.GetLength())
+	if(numPatternsIllegal > numPatterns && useFileSize && sizeWithoutPatterns + numPatternsIllegal * numChannels * 256 == file.GetLength())
 	{
 		// Even those illegal pattern indexes (> 128) appear to be valid... What a weird file!
 		// e.g. NIETNU.MOD, where the end of the order list is filled with FF rather than 00, and the file actually contains 256 patterns.
@@ -878,7 +880,7 @@ bool CSoundFile::ReadMOD(FileReader &file, ModLoadingFlags loadFlags)
 	}
 
 	// Get number of patterns (including some order list sanity checks)
-	PATTERNINDEX numPatterns = GetNumPatterns(file, Order(), realOrders, totalSampleLen, m_nChannels, isMdKd);
+	PATTERNINDEX numPatterns = GetNumPatterns(file, Order(), realOrders, totalSampleLen, m_nChannels, isMdKd, !(loadFlags & deferSampleData));
 	if(isMdKd && GetNumChannels() == 8)
 	{
 		// M.K. with 8 channels = Grave Composer
@@ -1006,6 +1008,10 @@ bool CSoundFile::ReadMOD(FileReader &file, ModLoadingFlags loadFlags)
 		{
 			break;
 		}
+		if(loadFlags & loadMetadataOnly)
+		{
+			continue;
+		}
 
 		// For detecting PT1x mode
 		std::vector<ModCommand::INSTR> lastInstrument(GetNumChannels(), 0);
@@ -1131,10 +1137,27 @@ bool CSoundFile::ReadMOD(FileReader &file, ModLoadingFlags loadFlags)
 	if(loadFlags & loadSampleData)
 	{
 		file.Seek(1084 + (readChannels * 64 * 4) * numPatterns);
+		// When deferring sample data, samples are assumed to be uncompressed. ReadPendingSampleData() checks each sample for ADPCM compression
+		// once its data is reached and corrects the location of the following samples.
+		FileReader::off_t sampleOffset = file.GetPosition();
+		const bool deferSamples = (loadFlags & deferSampleData) != 0;
 		for(SAMPLEINDEX smp = 1; smp <= 31; smp++)
 		{
 			ModSample &sample = Samples[smp];
-			if(sample.nLength)
+			if(sample.nLength && deferSamples)
+			{
+				SampleIO sampleIO(
+					SampleIO::_8bit,
+					SampleIO::mono,
+					SampleIO::littleEndian,
+					isInconexia ? SampleIO::deltaPCM : SampleIO::signedPCM);
+				const SmpLength encodedLength = sample.nLength;
+				// Inconexia samples cannot be ADPCM-compressed
+				DeferSampleData(smp, sampleIO, file, sampleOffset, isInconexia ? FlagSet<DeferSampleFlags>() : FlagSet<DeferSampleFlags>(deferMODSample));
+				if(isMdKd && onlyAmigaNotes)
+					sample.nLength = std::max(sample.nLength, sample.nLoopEnd);
+				sampleOffset += sampleIO.CalculateEncodedSize(encodedLength);
+			} else if(sample.nLength)
 			{
 				SampleIO::Encoding encoding = SampleIO::signedPCM;
 				if(isInconexia)
@@ -1498,7 +1521,7 @@ bool CSoundFile::ReadM15(FileReader &file, ModLoadingFlags loadFlags)
 	file.ReadStruct(fileHeader);
 
 	ReadOrderFromArray(Order(), fileHeader.orderList);
-	PATTERNINDEX numPatterns = GetNumPatterns(file, Order(), fileHeader.numOrders, totalSampleLen, m_nChannels, false);
+	PATTERNINDEX numPatterns = GetNumPatterns(file, Order(), fileHeader.numOrders, totalSampleLen, m_nChannels, false, true);
 
 	// Most likely just a file with lots of NULs at the start
 	if(fileHeader.restartPos == 0 && fileHeader.numOrders == 0 && numPatterns <= 1)
@@ -454,9 +454,16 @@ bool CSoundFile::ReadS3M(FileReader &file, ModLoadingFlags loadFlags)
 		if(sampleHeader.sampleType < S3MSampleHeader::typeAdMel)
 		{
 			const uint32 sampleOffset = (sampleHeader.dataPointer[1] << 4) | (sampleHeader.dataPointer[2] << 12) | (sampleHeader.dataPointer[0] << 20);
-			if((loadFlags & loadSampleData) && sampleHeader.length != 0 && file.Seek(sampleOffset))
+			const SampleIO sampleIO = sampleHeader.GetSampleFormat((fileHeader.formatVersion == S3MFileHeader::oldVersion));
+			if(!(loadFlags & loadSampleData) || sampleHeader.length == 0)
 			{
-				sampleHeader.GetSampleFormat((fileHeader.formatVersion == S3MFileHeader::oldVersion)).ReadSample(Samples[smp + 1], file);
+				continue;
+			} else if(loadFlags & deferSampleData)
+			{
+				DeferSampleData(smp + 1, sampleIO, file, sampleOffset);
+			} else if(file.Seek(sampleOffset))
+			{
+				sampleIO.ReadSample(Samples[smp + 1], file);
 			}
 		}
 	}
@@ -481,7 +488,7 @@ bool CSoundFile::ReadS3M(FileReader &file, ModLoadingFlags loadFlags)
 	for(PATTERNINDEX pat = 0; pat < readPatterns; pat++)
 	{
 		// A zero parapointer indicates an empty pattern.
-		if(!Patterns.Insert(pat, 64) || patternOffsets[pat] == 0 || !file.Seek(patternOffsets[pat] * 16))
+		if(!Patterns.Insert(pat, 64) || (loadFlags & loadMetadataOnly) || patternOffsets[pat] == 0 || !file.Seek(patternOffsets[pat] * 16))
 		{
 			continue;
 		}
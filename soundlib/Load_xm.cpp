@@ -234,10 +234,17 @@ static std::vector<SAMPLEINDEX> AllocateXMSamples(CSoundFile &sndFile, SAMPLEIND
 
 
 // Read .XM patterns
-static void ReadXMPatterns(FileReader &file, const XMFileHeader &fileHeader, CSoundFile &sndFile)
+// Without loadPatternData, the pattern data is only skipped to get to the data following it.
+// With loadMetadataOnly, the patterns are created but their contents are not decoded.
+static void ReadXMPatterns(FileReader &file, const XMFileHeader &fileHeader, CSoundFile &sndFile, CSoundFile::ModLoadingFlags loadFlags)
 {
+	const bool loadPatterns = (loadFlags & CSoundFile::loadPatternData) != 0;
+	const bool decodePatterns = loadPatterns && !(loadFlags & CSoundFile::loadMetadataOnly);
 	// Reading patterns
-	sndFile.Patterns.ResizeArray(fileHeader.patterns);
+	if(loadPatterns)
+	{
+		sndFile.Patterns.ResizeArray(fileHeader.patterns);
+	}
 	for(PATTERNINDEX pat = 0; pat < fileHeader.patterns; pat++)
 	{
 		FileReader::off_t curPos = file.GetPosition();
@@ -263,9 +270,10 @@ static void ReadXMPatterns(FileReader &file, const XMFileHeader &fileHeader, CSo
 		}
 
 		file.Seek(curPos + headerSize);
-		FileReader patternChunk = file.ReadChunk(packedSize);
+		FileReader::PinnedRawDataView patternChunkView = file.ReadPinnedRawDataView(packedSize);
+		MemoryFileReader patternChunk(patternChunkView.span());
 
-		if(!sndFile.Patterns.Insert(pat, numRows) || packedSize == 0)
+		if(!loadPatterns || !sndFile.Patterns.Insert(pat, numRows) || !decodePatterns || packedSize == 0)
 		{
 			continue;
 		}
@@ -688,7 +696,7 @@ bool CSoundFile::ReadXM(FileReader &file, ModLoadingFlags loadFlags)
 
 	if(fileHeader.version >= 0x0104)
 	{
-		ReadXMPatterns(file, fileHeader, *this);
+		ReadXMPatterns(file, fileHeader, *this, loadFlags);
 	}
 
 	bool isOXM = false;
@@ -857,7 +865,7 @@ bool CSoundFile::ReadXM(FileReader &file, ModLoadingFlags loadFlags)
 		// Load Patterns and Samples (Version 1.02 and 1.03)
 		if(loadFlags & (loadPatternData | loadSampleData))
 		{
-			ReadXMPatterns(file, fileHeader, *this);
+			ReadXMPatterns(file, fileHeader, *this, loadFlags);
 		}
 
 		if(loadFlags & loadSampleData)
@@ -73,6 +73,42 @@ const MixFuncInterface Functions[6 * 16] =
 #undef BuildMixFuncTable
 
 
+#ifdef MPT_INTMIXER
+
+// Build multi-voice mix function table for given resampling and filter settings: One function each for 8-Bit / 16-Bit Mono / Stereo
+#define BuildMultiVoiceFuncTableNoRamp(resampling, filter) \
+	MultiVoiceSampleLoop<I8M, resampling<I8M>, filter<I8M>, MixMonoNoRamp<I8M> >, \
+	MultiVoiceSampleLoop<I16M, resampling<I16M>, filter<I16M>, MixMonoNoRamp<I16M> >, \
+	MultiVoiceSampleLoop<I8S, resampling<I8S>, filter<I8S>, MixStereoNoRamp<I8S> >, \
+	MultiVoiceSampleLoop<I16S, resampling<I16S>, filter<I16S>, MixStereoNoRamp<I16S> >
+
+#define NoMultiVoiceFunc \
+	nullptr, nullptr, nullptr, nullptr
+
+// Build multi-voice mix function table for given resampling settings: Ramping voices are always mixed one by one
+#define BuildMultiVoiceFuncTable(resampling) \
+	BuildMultiVoiceFuncTableNoRamp(resampling, NoFilter), \
+	NoMultiVoiceFunc, \
+	BuildMultiVoiceFuncTableNoRamp(resampling, ResonantFilter), \
+	NoMultiVoiceFunc
+
+const MultiVoiceMixFuncInterface MultiVoiceFunctions[6 * 16] =
+{
+	BuildMultiVoiceFuncTable(NoInterpolation),			// No SRC
+	BuildMultiVoiceFuncTable(LinearInterpolation),		// Linear SRC
+	BuildMultiVoiceFuncTable(FastSincInterpolation),	// Fast Sinc (Cubic Spline) SRC
+	BuildMultiVoiceFuncTable(PolyphaseInterpolation),	// Kaiser SRC
+	BuildMultiVoiceFuncTable(FIRFilterInterpolation),	// FIR SRC
+	NoMultiVoiceFunc, NoMultiVoiceFunc, NoMultiVoiceFunc, NoMultiVoiceFunc,	// Amiga emulation is always mixed one voice at a time
+};
+
+#undef BuildMultiVoiceFuncTableNoRamp
+#undef NoMultiVoiceFunc
+#undef BuildMultiVoiceFuncTable
+
+#endif // MPT_INTMIXER
+
+
 ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode)
 {
 	switch(resamplingMode)
@@ -46,6 +46,12 @@ namespace MixFuncTable
 
 	extern const MixFuncInterface Functions[6 * 16];
 
+#ifdef MPT_INTMIXER
+	// Multi-voice mix functions, using the same index as Functions.
+	// nullptr if there is no multi-voice implementation for this combination (ramping voices, Amiga resampler).
+	extern const MultiVoiceMixFuncInterface MultiVoiceFunctions[6 * 16];
+#endif // MPT_INTMIXER
+
 	ResamplingIndex ResamplingModeToMixFlags(ResamplingMode resamplingMode);
 }
 
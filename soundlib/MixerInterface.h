@@ -41,8 +41,8 @@ struct MixerTraits
 template<class Traits>
 struct NoInterpolation
 {
-	MPT_FORCEINLINE void Start(const ModChannel &, const CResampler &) { }
-	MPT_FORCEINLINE void End(const ModChannel &) { }
+	MPT_FORCEINLINE void Start(const MixVoice &, const CResampler &) { }
+	MPT_FORCEINLINE void End(const MixVoice &) { }
 
 	MPT_FORCEINLINE void operator() (typename Traits::outbuf_t &outSample, const typename Traits::input_t * const inBuffer, const int32)
 	{
@@ -67,9 +67,9 @@ struct NoInterpolation
 // FilterFunc: Functor for applying the resonant filter
 // MixFunc: Functor for mixing the computed sample data into the output buffer
 template<class Traits, class InterpolationFunc, class FilterFunc, class MixFunc>
-static void SampleLoop(ModChannel &chn, const CResampler &resampler, typename Traits::output_t * MPT_RESTRICT outBuffer, unsigned int numSamples)
+static void SampleLoop(MixVoice &chn, const CResampler &resampler, typename Traits::output_t * MPT_RESTRICT outBuffer, unsigned int numSamples)
 {
-	ModChannel &c = chn;
+	MixVoice &c = chn;
 	const typename Traits::input_t * MPT_RESTRICT inSample = static_cast<const typename Traits::input_t *>(c.pCurrentSample);
 
 	InterpolationFunc interpolate;
@@ -104,6 +104,96 @@ static void SampleLoop(ModChannel &chn, const CResampler &resampler, typename Tr
 }
 
 // Type of the SampleLoop function above
-typedef void (*MixFuncInterface)(ModChannel &, const CResampler &, mixsample_t *, unsigned int);
+typedef void (*MixFuncInterface)(MixVoice &, const CResampler &, mixsample_t *, unsigned int);
+
+
+//////////////////////////////////////////////////////////////////////////
+// Multi-voice render loop
+
+// Number of voices rendered at once by MultiVoiceSampleLoop
+enum : int { MIXVOICES_PER_BATCH = 4 };
+
+// A voice whose render span has been deferred to a multi-voice render loop.
+// The voice's position has already been advanced past the span, so the start of the span is stored here.
+struct MixVoiceLane
+{
+	MixVoice *voice;
+	const void *sample;       // Sample pointer to render from (may point into the loop wrap-around buffer)
+	SamplePosition position;  // Play position at the start of the span
+};
+
+// Render MIXVOICES_PER_BATCH voices that share the same sample format, interpolation and filter type at once.
+// Samples of all voices are summed up before being added to the output buffer, so this is only equivalent
+// to calling SampleLoop for each voice if additions are associative (i.e. for the integer mixer).
+// Ramping voices are not supported.
+// The voices' nROfs and nLOfs are set to the voices' contribution to the last sampling point.
+template<class Traits, class InterpolationFunc, class FilterFunc, class MixFunc>
+static void MultiVoiceSampleLoop(const MixVoiceLane *lanes, const CResampler &resampler, typename Traits::output_t * MPT_RESTRICT outBuffer, unsigned int numSamples)
+{
+	const typename Traits::input_t * MPT_RESTRICT inSample[MIXVOICES_PER_BATCH];
+	SamplePosition smpPos[MIXVOICES_PER_BATCH];
+	SamplePosition increment[MIXVOICES_PER_BATCH];
+
+	InterpolationFunc interpolate[MIXVOICES_PER_BATCH];
+	FilterFunc filter[MIXVOICES_PER_BATCH];
+	MixFunc mix[MIXVOICES_PER_BATCH];
+
+	for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+	{
+		MixVoice &c = *lanes[v].voice;
+		inSample[v] = static_cast<const typename Traits::input_t *>(lanes[v].sample);
+		smpPos[v] = lanes[v].position;
+		increment[v] = c.increment;
+		interpolate[v].Start(c, resampler);
+		filter[v].Start(c);
+		mix[v].Start(c);
+	}
+
+	unsigned int samples = numSamples - 1;
+	while(samples--)
+	{
+		typename Traits::output_t mixed[Traits::numChannelsOut] = {};
+		for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+		{
+			typename Traits::outbuf_t outSample;
+			interpolate[v](outSample, inSample[v] + smpPos[v].GetInt() * Traits::numChannelsIn, smpPos[v].GetFract());
+			filter[v](outSample, *lanes[v].voice);
+			mix[v](outSample, *lanes[v].voice, mixed);
+			smpPos[v] += increment[v];
+		}
+		for(int i = 0; i < Traits::numChannelsOut; i++)
+		{
+			outBuffer[i] += mixed[i];
+		}
+		outBuffer += Traits::numChannelsOut;
+	}
+
+	// Last sampling point: Also remember each voice's contribution
+	for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+	{
+		typename Traits::outbuf_t outSample;
+		typename Traits::output_t mixed[Traits::numChannelsOut] = {};
+		interpolate[v](outSample, inSample[v] + smpPos[v].GetInt() * Traits::numChannelsIn, smpPos[v].GetFract());
+		filter[v](outSample, *lanes[v].voice);
+		mix[v](outSample, *lanes[v].voice, mixed);
+		for(int i = 0; i < Traits::numChannelsOut; i++)
+		{
+			outBuffer[i] += mixed[i];
+		}
+		lanes[v].voice->nROfs = mixed[0];
+		lanes[v].voice->nLOfs = mixed[1];
+	}
+
+	for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+	{
+		MixVoice &c = *lanes[v].voice;
+		mix[v].End(c);
+		filter[v].End(c);
+		interpolate[v].End(c);
+	}
+}
+
+// Type of the MultiVoiceSampleLoop function above
+typedef void (*MultiVoiceMixFuncInterface)(const MixVoiceLane *, const CResampler &, mixsample_t *, unsigned int);
 
 OPENMPT_NAMESPACE_END
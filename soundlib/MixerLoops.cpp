@@ -12,12 +12,28 @@
 
 #include "stdafx.h"
 #include "MixerLoops.h"
-#include "..//soundbase/SampleBuffer.h"
 #include "Snd_defs.h"
 #include "ModChannel.h"
-#ifdef ENABLE_SSE2
+#include "MixerInterface.h"
+#include "../soundbase/SampleFormatConverters.h"
+
+// SSE2 is part of the x86-64 baseline (and may be required by 32-bit x86 builds as well),
+// in which case the intrinsics can be used without having to check the CPU at runtime.
+#if !defined(ENABLE_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define MPT_MIXERLOOPS_SSE2_BASELINE
+#endif
+#if defined(ENABLE_SSE2) || defined(MPT_MIXERLOOPS_SSE2_BASELINE)
+#define MPT_MIXERLOOPS_SSE2
 #include <emmintrin.h>
 #endif
+// AVX2 is only used where the compiler allows it without special code generation flags.
+#if !defined(ENABLE_AVX2) && defined(__AVX2__)
+#define MPT_MIXERLOOPS_AVX2_BASELINE
+#endif
+#if (defined(ENABLE_AVX2) || defined(MPT_MIXERLOOPS_AVX2_BASELINE)) && defined(MPT_MIXERLOOPS_SSE2)
+#define MPT_MIXERLOOPS_AVX2
+#include <immintrin.h>
+#endif
 
 
 OPENMPT_NAMESPACE_BEGIN
@@ -25,16 +41,23 @@ OPENMPT_NAMESPACE_BEGIN
 ///////////////////////////////////////////////////////////////////////////////////////
 // SSE Optimizations
 
-#ifdef ENABLE_SSE2
+#ifdef MPT_MIXERLOOPS_SSE2
+
+// Builds with inline assembly have always rounded to nearest when converting floats back to the integer mix format,
+// while the portable code truncates. Both variants are provided so that no build changes its output.
+template<bool roundToNearest>
+static MPT_FORCEINLINE __m128i SSE2_FloatToInt(__m128 f)
+{
+	return roundToNearest ? _mm_cvtps_epi32(f) : _mm_cvttps_epi32(f);
+}
+
 
 static void SSE2_StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc)
 {
-	__m128 i2fc = _mm_load_ps1(&_i2fc);
+	const __m128 i2fc = _mm_set1_ps(_i2fc);
 	const __m128i *in = reinterpret_cast<const __m128i *>(pSrc);
 
-	// We may read beyond the wanted length... this works because we know that we will always work on our buffers of size MIXBUFFERSIZE
-	nCount = (nCount + 3) / 4;
-	do
+	for(uint32 i = nCount / 4; i != 0; i--)
 	{
 		__m128i i1 = _mm_loadu_si128(in);		// Load four integer values, LRLR
 		__m128i i2 = _mm_loadu_si128(in + 1);	// Load four integer values, LRLR
@@ -49,18 +72,23 @@ static void SSE2_StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2,
 		_mm_storeu_ps(pOut2, fr);				// Store four float values, RRRR
 		pOut1 += 4;
 		pOut2 += 4;
-	} while(--nCount);
+	}
+	pSrc = reinterpret_cast<const int32 *>(in);
+	for(uint32 i = nCount % 4; i != 0; i--)
+	{
+		*pOut1++ = *pSrc++ * _i2fc;
+		*pOut2++ = *pSrc++ * _i2fc;
+	}
 }
 
 
+template<bool roundToNearest>
 static void SSE2_FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *pOut, uint32 nCount, const float _f2ic)
 {
-	__m128 f2ic = _mm_load_ps1(&_f2ic);
+	const __m128 f2ic = _mm_set1_ps(_f2ic);
 	__m128i *out = reinterpret_cast<__m128i *>(pOut);
 
-	// We may read beyond the wanted length... this works because we know that we will always work on our buffers of size MIXBUFFERSIZE
-	nCount = (nCount + 3) / 4;
-	do
+	for(uint32 i = nCount / 4; i != 0; i--)
 	{
 		__m128 fl = _mm_loadu_ps(pIn1);			// Load four float values, LLLL
 		__m128 fr = _mm_loadu_ps(pIn2);			// Load four float values, RRRR
@@ -70,15 +98,147 @@ static void SSE2_FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *p
 		fr = _mm_mul_ps(fr, f2ic);				// Apply int->float factor
 		__m128 f1 = _mm_unpacklo_ps(fl, fr);	// LL__+RR__ => LRLR
 		__m128 f2 = _mm_unpackhi_ps(fl, fr);	// __LL+__RR => LRLR
-		__m128i i1 =_mm_cvtps_epi32(f1);		// Convert to four ints
-		__m128i i2 =_mm_cvtps_epi32(f2);		// Convert to four ints
+		__m128i i1 = SSE2_FloatToInt<roundToNearest>(f1);	// Convert to four ints
+		__m128i i2 = SSE2_FloatToInt<roundToNearest>(f2);	// Convert to four ints
 		_mm_storeu_si128(out, i1);				// Store four int values, LRLR
 		_mm_storeu_si128(out + 1, i2);			// Store four int values, LRLR
 		out += 2;
-	} while(--nCount);
+	}
+	pOut = reinterpret_cast<int32 *>(out);
+	for(uint32 i = nCount % 4; i != 0; i--)
+	{
+		*pOut++ = _mm_cvtsi128_si32(SSE2_FloatToInt<roundToNearest>(_mm_mul_ss(_mm_load_ss(pIn1++), f2ic)));
+		*pOut++ = _mm_cvtsi128_si32(SSE2_FloatToInt<roundToNearest>(_mm_mul_ss(_mm_load_ss(pIn2++), f2ic)));
+	}
+}
+
+
+static void SSE2_MonoMixToFloat(const int32 *pSrc, float *pOut, uint32 nCount, const float _i2fc)
+{
+	const __m128 i2fc = _mm_set1_ps(_i2fc);
+	for(uint32 i = nCount / 4; i != 0; i--)
+	{
+		_mm_storeu_ps(pOut, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc))), i2fc));
+		pSrc += 4;
+		pOut += 4;
+	}
+	for(uint32 i = nCount % 4; i != 0; i--)
+	{
+		*pOut++ = *pSrc++ * _i2fc;
+	}
+}
+
+
+static void SSE2_FloatToMonoMix(const float *pIn, int32 *pOut, uint32 nCount, const float _f2ic)
+{
+	const __m128 f2ic = _mm_set1_ps(_f2ic);
+	for(uint32 i = nCount / 4; i != 0; i--)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pOut), SSE2_FloatToInt<false>(_mm_mul_ps(_mm_loadu_ps(pIn), f2ic)));
+		pIn += 4;
+		pOut += 4;
+	}
+	for(uint32 i = nCount % 4; i != 0; i--)
+	{
+		*pOut++ = _mm_cvtsi128_si32(SSE2_FloatToInt<false>(_mm_mul_ss(_mm_load_ss(pIn++), f2ic)));
+	}
+}
+
+// Same result as SC::Convert<int16, float32>, which the remaining samples are converted with.
+static void SSE2_FloatToInt16(const float *pIn, int16 *pOut, std::size_t numSamples, float gain)
+{
+	const __m128 gainFactor = _mm_set1_ps(gain);
+	const __m128 one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(32768.0f), half = _mm_set1_ps(0.5f);
+	const auto convert = [&](__m128 f)
+	{
+		f = _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_mul_ps(f, gainFactor), one), minusOne), scale);
+#if MPT_SC_AVOID_ROUND
+		// floor(f + 0.5)
+		f = _mm_add_ps(f, half);
+		const __m128i i = _mm_cvttps_epi32(f);
+		return _mm_add_epi32(i, _mm_castps_si128(_mm_cmplt_ps(f, _mm_cvtepi32_ps(i))));
+#else
+		// Round half away from zero, like std::round. The difference to the truncated value is exact.
+		const __m128i i = _mm_cvttps_epi32(f);
+		const __m128 frac = _mm_sub_ps(f, _mm_cvtepi32_ps(i));
+		const __m128i up = _mm_castps_si128(_mm_cmpge_ps(frac, half));
+		const __m128i down = _mm_castps_si128(_mm_cmple_ps(frac, _mm_sub_ps(_mm_setzero_ps(), half)));
+		return _mm_add_epi32(_mm_sub_epi32(i, up), down);
+#endif
+	};
+	for(std::size_t i = numSamples / 8; i != 0; i--)
+	{
+		const __m128i lo = convert(_mm_loadu_ps(pIn));
+		const __m128i hi = convert(_mm_loadu_ps(pIn + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pOut), _mm_packs_epi32(lo, hi));	// Saturates to int16
+		pIn += 8;
+		pOut += 8;
+	}
+	SC::Convert<int16, float32> conv;
+	for(std::size_t i = numSamples % 8; i != 0; i--)
+	{
+		*pOut++ = conv(*pIn++ * gain);
+	}
+}
+
+#endif // MPT_MIXERLOOPS_SSE2
+
+
+#ifdef MPT_MIXERLOOPS_AVX2
+
+// Same as the SSE2 versions, but for eight frames at a time. The remaining frames are handled by the SSE2 code.
+
+static void AVX2_StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc)
+{
+	const __m256 i2fc = _mm256_set1_ps(_i2fc);
+	const __m256i *in = reinterpret_cast<const __m256i *>(pSrc);
+
+	for(uint32 i = nCount / 8; i != 0; i--)
+	{
+		__m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(in)), i2fc);		// LRLR LRLR
+		__m256 f2 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(in + 1)), i2fc);	// LRLR LRLR
+		in += 2;
+		// Shuffles work within 128-bit lanes, so the result is L0 L1 L4 L5 L2 L3 L6 L7 and has to be reordered
+		__m256 fl = _mm256_shuffle_ps(f1, f2, _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 fr = _mm256_shuffle_ps(f1, f2, _MM_SHUFFLE(3, 1, 3, 1));
+		fl = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(fl), _MM_SHUFFLE(3, 1, 2, 0)));	// LLLL LLLL
+		fr = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(fr), _MM_SHUFFLE(3, 1, 2, 0)));	// RRRR RRRR
+		_mm256_storeu_ps(pOut1, fl);
+		_mm256_storeu_ps(pOut2, fr);
+		pOut1 += 8;
+		pOut2 += 8;
+	}
+	_mm256_zeroupper();
+	SSE2_StereoMixToFloat(reinterpret_cast<const int32 *>(in), pOut1, pOut2, nCount % 8, _i2fc);
+}
+
+
+template<bool roundToNearest>
+static void AVX2_FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *pOut, uint32 nCount, const float _f2ic)
+{
+	const __m256 f2ic = _mm256_set1_ps(_f2ic);
+	__m256i *out = reinterpret_cast<__m256i *>(pOut);
+
+	for(uint32 i = nCount / 8; i != 0; i--)
+	{
+		__m256 fl = _mm256_mul_ps(_mm256_loadu_ps(pIn1), f2ic);	// LLLL LLLL
+		__m256 fr = _mm256_mul_ps(_mm256_loadu_ps(pIn2), f2ic);	// RRRR RRRR
+		pIn1 += 8;
+		pIn2 += 8;
+		__m256 lo = _mm256_unpacklo_ps(fl, fr);	// L0 R0 L1 R1 L4 R4 L5 R5
+		__m256 hi = _mm256_unpackhi_ps(fl, fr);	// L2 R2 L3 R3 L6 R6 L7 R7
+		__m256 f1 = _mm256_permute2f128_ps(lo, hi, 0x20);	// Frames 0-3
+		__m256 f2 = _mm256_permute2f128_ps(lo, hi, 0x31);	// Frames 4-7
+		_mm256_storeu_si256(out, roundToNearest ? _mm256_cvtps_epi32(f1) : _mm256_cvttps_epi32(f1));
+		_mm256_storeu_si256(out + 1, roundToNearest ? _mm256_cvtps_epi32(f2) : _mm256_cvttps_epi32(f2));
+		out += 2;
+	}
+	_mm256_zeroupper();
+	SSE2_FloatToStereoMix<roundToNearest>(pIn1, pIn2, reinterpret_cast<int32 *>(out), nCount % 8, _f2ic);
 }
 
-#endif // ENABLE_SSE2
+#endif // MPT_MIXERLOOPS_AVX2
 
 
 #if defined(ENABLE_X86) && defined(ENABLE_SSE)
@@ -177,78 +337,6 @@ static void C_MonoMixToFloat(const int32 *pSrc, float *pOut, uint32 nCount, cons
 
 
 
-void StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc)
-{
-
-	#ifdef ENABLE_SSE2
-	if(GetProcSupport() & PROCSUPPORT_SSE2)
-	{
-		SSE2_StereoMixToFloat(pSrc, pOut1, pOut2, nCount, _i2fc);
-		return;
-	}
-	#endif // ENABLE_SSE2
-
-	{
-		C_StereoMixToFloat(pSrc, pOut1, pOut2, nCount, _i2fc);
-	}
-
-}
-
-
-void FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *pOut, uint32 nCount, const float _f2ic)
-{
-	#ifdef ENABLE_SSE2
-	if(GetProcSupport() & PROCSUPPORT_SSE2)
-	{
-		SSE2_FloatToStereoMix(pIn1, pIn2, pOut, nCount, _f2ic);
-		return;
-	}
-	#endif // ENABLE_SSE2
-
-	{
-		C_FloatToStereoMix(pIn1, pIn2, pOut, nCount, _f2ic);
-	}
-
-}
-
-
-void MonoMixToFloat(const int32 *pSrc, float *pOut, uint32 nCount, const float _i2fc)
-{
-
-	#if defined(ENABLE_X86) && defined(ENABLE_SSE)
-		if(GetProcSupport() & PROCSUPPORT_SSE)
-		{
-			SSE_MonoMixToFloat(pSrc, pOut, nCount, _i2fc);
-			return;
-		}
-	#endif // ENABLE_X86 && ENABLE_SSE
-
-	{
-		C_MonoMixToFloat(pSrc, pOut, nCount, _i2fc);
-	}
-
-}
-
-
-void FloatToMonoMix(const float *pIn, int32 *pOut, uint32 nCount, const float _f2ic)
-{
-
-	#ifdef ENABLE_X86
-		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
-		{
-			X86_FloatToMonoMix(pIn, pOut, nCount, _f2ic);
-			return;
-		}
-	#endif // ENABLE_X86
-
-	{
-		C_FloatToMonoMix(pIn, pOut, nCount, _f2ic);
-	}
-
-}
-
-
-
 //////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -303,19 +391,28 @@ static void C_InterleaveFrontRear(mixsample_t *pFrontBuf, mixsample_t *pRearBuf,
 	}
 }
 
-void InterleaveFrontRear(mixsample_t *pFrontBuf, mixsample_t *pRearBuf, uint32 nFrames)
+#if defined(MPT_MIXERLOOPS_SSE2) && defined(MPT_INTMIXER)
+static void SSE2_InterleaveFrontRear(int32 *pFrontBuf, int32 *pRearBuf, uint32 nFrames)
 {
-	#if defined(ENABLE_X86) && defined(MPT_INTMIXER)
-		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
-		{
-			X86_InterleaveFrontRear(pFrontBuf, pRearBuf, nFrames);
-			return;
-		}
-	#endif
+	// copy backwards as we are writing back into FrontBuf
+	if(nFrames % 2u)
+	{
+		nFrames--;
+		pFrontBuf[nFrames * 4 + 3] = pRearBuf[nFrames * 2 + 1];
+		pFrontBuf[nFrames * 4 + 2] = pRearBuf[nFrames * 2 + 0];
+		pFrontBuf[nFrames * 4 + 1] = pFrontBuf[nFrames * 2 + 1];
+		pFrontBuf[nFrames * 4 + 0] = pFrontBuf[nFrames * 2 + 0];
+	}
+	while(nFrames)
 	{
-		C_InterleaveFrontRear(pFrontBuf, pRearBuf, nFrames);
+		nFrames -= 2;
+		const __m128i front = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pFrontBuf + nFrames * 2));	// F0 F0 F1 F1
+		const __m128i rear = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pRearBuf + nFrames * 2));	// R0 R0 R1 R1
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pFrontBuf + nFrames * 4 + 4), _mm_unpackhi_epi64(front, rear));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pFrontBuf + nFrames * 4), _mm_unpacklo_epi64(front, rear));
 	}
 }
+#endif
 
 
 #ifdef ENABLE_X86
@@ -347,19 +444,35 @@ static void C_MonoFromStereo(mixsample_t *pMixBuf, uint32 nSamples)
 	}
 }
 
-void MonoFromStereo(mixsample_t *pMixBuf, uint32 nSamples)
+#if defined(MPT_MIXERLOOPS_SSE2) && defined(MPT_INTMIXER)
+// The inline assembly version rounds down (arithmetic shift), while the C version rounds towards zero.
+template<bool roundDown>
+static void SSE2_MonoFromStereo(int32 *pMixBuf, uint32 nSamples)
 {
-	#if defined(ENABLE_X86) && defined(MPT_INTMIXER)
-		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
-		{
-			X86_MonoFromStereo(pMixBuf, nSamples);
-			return;
-		}
-	#endif
+	const int32 *in = pMixBuf;
+	int32 *out = pMixBuf;
+	for(uint32 i = nSamples / 4; i != 0; i--)
+	{
+		const __m128 i1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));		// LRLR
+		const __m128 i2 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4)));	// LRLR
+		in += 8;
+		const __m128i l = _mm_castps_si128(_mm_shuffle_ps(i1, i2, _MM_SHUFFLE(2, 0, 2, 0)));	// LLLL
+		const __m128i r = _mm_castps_si128(_mm_shuffle_ps(i1, i2, _MM_SHUFFLE(3, 1, 3, 1)));	// RRRR
+		const __m128i sum = _mm_add_epi32(l, r);
+		if(roundDown)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_srai_epi32(sum, 1));
+		else
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1));
+		out += 4;
+	}
+	for(uint32 i = nSamples % 4; i != 0; i--)
 	{
-		C_MonoFromStereo(pMixBuf, nSamples);
+		const int32 sum = in[0] + in[1];
+		*out++ = roundDown ? mpt::rshift_signed(sum, 1) : sum / 2;
+		in += 2;
 	}
 }
+#endif
 
 
 #define OFSDECAYSHIFT	8
@@ -476,31 +589,47 @@ static void C_StereoFill(mixsample_t *pBuffer, uint32 nSamples, mixsample_t &rof
 }
 
 
-void StereoFill(mixsample_t *pBuffer, uint32 nSamples, mixsample_t &rofs, mixsample_t &lofs)
+#if defined(MPT_MIXERLOOPS_SSE2) && defined(MPT_INTMIXER)
+// Decay both offsets of a stereo pair (in the lower two lanes) by one step, like the C implementation.
+static MPT_FORCEINLINE __m128i SSE2_DecayOfs(__m128i ofs)
 {
-	#if defined(ENABLE_X86) && defined(MPT_INTMIXER)
-		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
-		{
-			X86_StereoFill(pBuffer, nSamples, &rofs, &lofs);
-			return;
-		}
-	#endif
+	const __m128i sign = _mm_srai_epi32(_mm_sub_epi32(_mm_setzero_si128(), ofs), 31);
+	const __m128i x = _mm_srai_epi32(_mm_add_epi32(ofs, _mm_and_si128(sign, _mm_set1_epi32(OFSDECAYMASK))), OFSDECAYSHIFT);
+	return _mm_sub_epi32(ofs, x);
+}
+
+static MPT_FORCEINLINE bool SSE2_IsZeroOfs(__m128i ofs)
+{
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(ofs, _mm_setzero_si128())) == 0xFFFF;
+}
+
+static void SSE2_StereoFill(int32 *pBuffer, uint32 nSamples, int32 &rofs, int32 &lofs)
+{
+	__m128i ofs = _mm_setr_epi32(rofs, lofs, 0, 0);
+	uint32 i = 0;
+	// Once both offsets have decayed, the remaining buffer is silent.
+	for(; i < nSamples && !SSE2_IsZeroOfs(ofs); i++)
 	{
-		C_StereoFill(pBuffer, nSamples, rofs, lofs);
+		ofs = SSE2_DecayOfs(ofs);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(pBuffer + i * 2), ofs);
 	}
+	InitMixBuffer(pBuffer + i * 2, (nSamples - i) * 2);
+	rofs = _mm_cvtsi128_si32(ofs);
+	lofs = _mm_cvtsi128_si32(_mm_srli_si128(ofs, 4));
 }
+#endif
 
 
 #ifdef ENABLE_X86
-typedef ModChannel ModChannel_;
-static void X86_EndChannelOfs(ModChannel *pChannel, int32 *pBuffer, uint32 nSamples)
+typedef MixVoice MixVoice_;
+static void X86_EndChannelOfs(MixVoice *pChannel, int32 *pBuffer, uint32 nSamples)
 {
 	_asm {
 	mov esi, pChannel
 	mov edi, pBuffer
 	mov ecx, nSamples
-	mov eax, dword ptr [esi+ModChannel_.nROfs]
-	mov edx, dword ptr [esi+ModChannel_.nLOfs]
+	mov eax, dword ptr [esi+MixVoice_.nROfs]
+	mov edx, dword ptr [esi+MixVoice_.nLOfs]
 	or ecx, ecx
 	jz brkloop
 ofsloop:
@@ -528,14 +657,14 @@ ofsloop:
 	jnz ofsloop
 brkloop:
 	mov esi, pChannel
-	mov dword ptr [esi+ModChannel_.nROfs], eax
-	mov dword ptr [esi+ModChannel_.nLOfs], edx
+	mov dword ptr [esi+MixVoice_.nROfs], eax
+	mov dword ptr [esi+MixVoice_.nLOfs], edx
 	}
 }
 #endif
 
 // c implementation taken from libmodplug
-static void C_EndChannelOfs(ModChannel &chn, mixsample_t *pBuffer, uint32 nSamples)
+static void C_EndChannelOfs(MixVoice &chn, mixsample_t *pBuffer, uint32 nSamples)
 {
 
 	mixsample_t rofs = chn.nROfs;
@@ -570,110 +699,310 @@ static void C_EndChannelOfs(ModChannel &chn, mixsample_t *pBuffer, uint32 nSampl
 	chn.nLOfs = lofs;
 }
 
-void EndChannelOfs(ModChannel &chn, mixsample_t *pBuffer, uint32 nSamples)
+#if defined(MPT_MIXERLOOPS_SSE2) && defined(MPT_INTMIXER)
+static void SSE2_EndChannelOfs(MixVoice &chn, int32 *pBuffer, uint32 nSamples)
 {
-	#if defined(ENABLE_X86) && defined(MPT_INTMIXER)
-		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
-		{
-			X86_EndChannelOfs(&chn, pBuffer, nSamples);
-			return;
-		}
-	#endif
+	__m128i ofs = _mm_setr_epi32(chn.nROfs, chn.nLOfs, 0, 0);
+	for(uint32 i = 0; i < nSamples && !SSE2_IsZeroOfs(ofs); i++)
 	{
-		C_EndChannelOfs(chn, pBuffer, nSamples);
+		ofs = SSE2_DecayOfs(ofs);
+		__m128i *out = reinterpret_cast<__m128i *>(pBuffer + i * 2);
+		_mm_storel_epi64(out, _mm_add_epi32(_mm_loadl_epi64(out), ofs));
 	}
+	chn.nROfs = _mm_cvtsi128_si32(ofs);
+	chn.nLOfs = _mm_cvtsi128_si32(_mm_srli_si128(ofs, 4));
 }
+#endif
 
 
-void InterleaveStereo(const mixsample_t * MPT_RESTRICT inputL, const mixsample_t * MPT_RESTRICT inputR, mixsample_t * MPT_RESTRICT output, size_t numSamples)
+#if defined(MPT_MIXERLOOPS_SSE2) && defined(MPT_INTMIXER)
+template<bool linear>
+static void SSE2_MultiVoiceMix16Mono(const MixVoiceLane *lanes, int32 *pBuffer, uint32 nSamples)
 {
-	while(numSamples--)
+	MPT_STATIC_ASSERT(MIXVOICES_PER_BATCH == 4);
+	const int16 *inSample[4];
+	SamplePosition smpPos[4], increment[4];
+	for(int v = 0; v < 4; v++)
 	{
-		*(output++) = *(inputL++);
-		*(output++) = *(inputR++);
+		inSample[v] = static_cast<const int16 *>(lanes[v].sample);
+		smpPos[v] = lanes[v].position;
+		increment[v] = lanes[v].voice->increment;
+	}
+	// L0 L1 L2 L3 R0 R1 R2 R3
+	const __m128i vol = _mm_setr_epi16(
+		static_cast<int16>(lanes[0].voice->leftVol), static_cast<int16>(lanes[1].voice->leftVol), static_cast<int16>(lanes[2].voice->leftVol), static_cast<int16>(lanes[3].voice->leftVol),
+		static_cast<int16>(lanes[0].voice->rightVol), static_cast<int16>(lanes[1].voice->rightVol), static_cast<int16>(lanes[2].voice->rightVol), static_cast<int16>(lanes[3].voice->rightVol));
+	const __m128i roundTowardsZero = _mm_set1_epi32((1 << 14) - 1);
+	__m128i smp = _mm_setzero_si128();
+
+	for(uint32 i = 0; i < nSamples; i++)
+	{
+		if(linear)
+		{
+			// Load src and dest sampling points of each voice as a pair of 16-bit values
+			int32 in[4];
+			uint32 fract[4];
+			for(int v = 0; v < 4; v++)
+			{
+				std::memcpy(&in[v], inSample[v] + smpPos[v].GetInt(), sizeof(int32));
+				fract[v] = smpPos[v].GetFract() >> 18;
+			}
+			const __m128i srcDest = _mm_setr_epi32(in[0], in[1], in[2], in[3]);
+			// fract * (dest - src) = (-fract) * src + fract * dest
+			const __m128i f = _mm_setr_epi32(fract[0], fract[1], fract[2], fract[3]);
+			__m128i diff = _mm_madd_epi16(srcDest, _mm_or_si128(_mm_slli_epi32(f, 16), _mm_sub_epi16(_mm_setzero_si128(), f)));
+			// Signed division by 16384 (rounding towards zero like the scalar code)
+			diff = _mm_srai_epi32(_mm_add_epi32(diff, _mm_and_si128(_mm_srai_epi32(diff, 31), roundTowardsZero)), 14);
+			smp = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(srcDest, 16), 16), diff);
+		} else
+		{
+			smp = _mm_setr_epi32(inSample[0][smpPos[0].GetInt()], inSample[1][smpPos[1].GetInt()], inSample[2][smpPos[2].GetInt()], inSample[3][smpPos[3].GetInt()]);
+		}
+		const __m128i smp16 = _mm_packs_epi32(smp, smp);  // S0 S1 S2 S3 S0 S1 S2 S3
+		const __m128i prod = _mm_madd_epi16(smp16, vol);  // S0*L0+S1*L1, S2*L2+S3*L3, S0*R0+S1*R1, S2*R2+S3*R3
+		const __m128i sum = _mm_add_epi32(prod, _mm_shuffle_epi32(prod, _MM_SHUFFLE(2, 3, 0, 1)));  // L L R R
+		pBuffer[0] += _mm_cvtsi128_si32(sum);
+		pBuffer[1] += _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+		pBuffer += 2;
+		for(int v = 0; v < 4; v++)
+		{
+			smpPos[v] += increment[v];
+		}
+	}
+
+	// Contribution of each voice to the last sampling point
+	int32 lastSmp[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(lastSmp), smp);
+	for(int v = 0; v < 4; v++)
+	{
+		lanes[v].voice->nROfs = lastSmp[v] * lanes[v].voice->leftVol;
+		lanes[v].voice->nLOfs = lastSmp[v] * lanes[v].voice->rightVol;
 	}
 }
+#endif // MPT_MIXERLOOPS_SSE2 && MPT_INTMIXER
 
 
-void DeinterleaveStereo(const mixsample_t * MPT_RESTRICT input, mixsample_t * MPT_RESTRICT outputL, mixsample_t * MPT_RESTRICT outputR, size_t numSamples)
+//////////////////////////////////////////////////////////////////////////////////////////
+// Dispatch
+
+namespace
 {
-	while(numSamples--)
-	{
-		*(outputL++) = *(input++);
-		*(outputR++) = *(input++);
-	}
+struct MixerLoopFunctions
+{
+	void (*StereoMixToFloat)(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc);
+	void (*FloatToStereoMix)(const float *pIn1, const float *pIn2, int32 *pOut, uint32 nCount, const float _f2ic);
+	void (*MonoMixToFloat)(const int32 *pSrc, float *pOut, uint32 nCount, const float _i2fc);
+	void (*FloatToMonoMix)(const float *pIn, int32 *pOut, uint32 nCount, const float _f2ic);
+	void (*InterleaveFrontRear)(mixsample_t *pFrontBuf, mixsample_t *pRearBuf, uint32 nFrames);
+	void (*MonoFromStereo)(mixsample_t *pMixBuf, uint32 nSamples);
+	void (*StereoFill)(mixsample_t *pBuffer, uint32 nSamples, mixsample_t &rofs, mixsample_t &lofs);
+	void (*EndChannelOfs)(MixVoice &chn, mixsample_t *pBuffer, uint32 nSamples);
+	// Indexed by linear interpolation, nullptr if there is no optimized implementation
+	void (*MultiVoiceMix16Mono[2])(const MixVoiceLane *lanes, mixsample_t *pBuffer, uint32 nSamples);
+	// nullptr if there is no optimized implementation
+	void (*FloatToInt16)(const float *pIn, int16 *pOut, std::size_t numSamples, float gain);
+};
+} // namespace
+
+
+static MixerLoopFunctions SelectMixerLoopFunctions()
+{
+	MixerLoopFunctions f;
+	f.StereoMixToFloat = C_StereoMixToFloat;
+	f.FloatToStereoMix = C_FloatToStereoMix;
+	f.MonoMixToFloat = C_MonoMixToFloat;
+	f.FloatToMonoMix = C_FloatToMonoMix;
+	f.InterleaveFrontRear = C_InterleaveFrontRear;
+	f.MonoFromStereo = C_MonoFromStereo;
+	f.StereoFill = C_StereoFill;
+	f.EndChannelOfs = C_EndChannelOfs;
+	f.MultiVoiceMix16Mono[0] = nullptr;
+	f.MultiVoiceMix16Mono[1] = nullptr;
+	f.FloatToInt16 = nullptr;
+
+	#ifdef ENABLE_X86
+		if(GetProcSupport() & PROCSUPPORT_ASM_INTRIN)
+		{
+			f.FloatToMonoMix = X86_FloatToMonoMix;
+			#ifdef MPT_INTMIXER
+				f.InterleaveFrontRear = X86_InterleaveFrontRear;
+				f.MonoFromStereo = X86_MonoFromStereo;
+				f.StereoFill = [](int32 *pBuffer, uint32 nSamples, int32 &rofs, int32 &lofs) { X86_StereoFill(pBuffer, nSamples, &rofs, &lofs); };
+				f.EndChannelOfs = [](MixVoice &chn, int32 *pBuffer, uint32 nSamples) { X86_EndChannelOfs(&chn, pBuffer, nSamples); };
+			#endif // MPT_INTMIXER
+		}
+	#endif // ENABLE_X86
+
+	#if defined(ENABLE_X86) && defined(ENABLE_SSE)
+		if(GetProcSupport() & PROCSUPPORT_SSE)
+		{
+			f.MonoMixToFloat = SSE_MonoMixToFloat;
+		}
+	#endif // ENABLE_X86 && ENABLE_SSE
+
+	#ifdef MPT_MIXERLOOPS_SSE2
+		#ifdef ENABLE_SSE2
+			const bool haveSSE2 = (GetProcSupport() & PROCSUPPORT_SSE2) != 0;
+		#else
+			const bool haveSSE2 = true;
+		#endif
+		if(haveSSE2)
+		{
+			f.StereoMixToFloat = SSE2_StereoMixToFloat;
+			#ifdef ENABLE_SSE2
+				f.FloatToStereoMix = SSE2_FloatToStereoMix<true>;
+			#else
+				f.FloatToStereoMix = SSE2_FloatToStereoMix<false>;
+			#endif
+			f.MonoMixToFloat = SSE2_MonoMixToFloat;
+			#if !MPT_SC_AVOID_FLOOR
+				f.FloatToInt16 = SSE2_FloatToInt16;
+			#endif
+			#ifndef ENABLE_X86
+				// The x87 code rounds, keep using it where it is available.
+				f.FloatToMonoMix = SSE2_FloatToMonoMix;
+			#endif
+			#ifdef MPT_INTMIXER
+				f.InterleaveFrontRear = SSE2_InterleaveFrontRear;
+				#ifdef ENABLE_X86
+					f.MonoFromStereo = SSE2_MonoFromStereo<true>;
+				#else
+					f.MonoFromStereo = SSE2_MonoFromStereo<false>;
+				#endif
+				f.StereoFill = SSE2_StereoFill;
+				f.EndChannelOfs = SSE2_EndChannelOfs;
+				f.MultiVoiceMix16Mono[0] = SSE2_MultiVoiceMix16Mono<false>;
+				f.MultiVoiceMix16Mono[1] = SSE2_MultiVoiceMix16Mono<true>;
+			#endif // MPT_INTMIXER
+		}
+	#endif // MPT_MIXERLOOPS_SSE2
+
+	#ifdef MPT_MIXERLOOPS_AVX2
+		#ifdef ENABLE_AVX2
+			const bool haveAVX2 = (GetProcSupport() & PROCSUPPORT_AVX2) != 0;
+		#else
+			const bool haveAVX2 = true;
+		#endif
+		if(haveAVX2)
+		{
+			f.StereoMixToFloat = AVX2_StereoMixToFloat;
+			#ifdef ENABLE_SSE2
+				f.FloatToStereoMix = AVX2_FloatToStereoMix<true>;
+			#else
+				f.FloatToStereoMix = AVX2_FloatToStereoMix<false>;
+			#endif
+		}
+	#endif // MPT_MIXERLOOPS_AVX2
+
+	return f;
 }
 
 
-#ifndef MODPLUG_TRACKER
+// The implementations are chosen on first use, i.e. after the available CPU features have been determined.
+static const MixerLoopFunctions &GetMixerLoopFunctions()
+{
+	static const MixerLoopFunctions functions = SelectMixerLoopFunctions();
+	return functions;
+}
 
-void ApplyGain(MixSampleInt *soundBuffer, std::size_t channels, std::size_t countChunk, int32 gainFactor16_16)
+
+void StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc)
 {
-	if(gainFactor16_16 == (1<<16))
-	{
-		// nothing to do, gain == +/- 0dB
-		return; 
-	}
-	// no clipping prevention is done here
-	MixSampleInt * buf = soundBuffer;
-	for(std::size_t i=0; i<countChunk*channels; ++i)
-	{
-		*buf = Util::muldiv(*buf, gainFactor16_16, 1<<16);
-		buf++;
-	}
+	GetMixerLoopFunctions().StereoMixToFloat(pSrc, pOut1, pOut2, nCount, _i2fc);
 }
 
-void ApplyGain(MixSampleFloat *soundBuffer, std::size_t channels, std::size_t countChunk, float gainFactor)
+
+void FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *pOut, uint32 nCount, const float _f2ic)
 {
-	if(gainFactor == 1.0f)
-	{
-		// nothing to do, gain == +/- 0dB
-		return;
-	}
-	// no clipping prevention is done here
-	MixSampleFloat * buf = soundBuffer;
-	for(std::size_t i=0; i<countChunk*channels; ++i)
-	{
-		*buf *= gainFactor;
-		buf++;
-	}
+	GetMixerLoopFunctions().FloatToStereoMix(pIn1, pIn2, pOut, nCount, _f2ic);
+}
+
+
+void MonoMixToFloat(const int32 *pSrc, float *pOut, uint32 nCount, const float _i2fc)
+{
+	GetMixerLoopFunctions().MonoMixToFloat(pSrc, pOut, nCount, _i2fc);
 }
 
 
-void ApplyGain(audio_buffer_interleaved<float> outputBuffer, std::size_t offset, std::size_t channels, std::size_t countChunk, float gainFactor)
+void FloatToMonoMix(const float *pIn, int32 *pOut, uint32 nCount, const float _f2ic)
+{
+	GetMixerLoopFunctions().FloatToMonoMix(pIn, pOut, nCount, _f2ic);
+}
+
+
+void InterleaveFrontRear(mixsample_t *pFrontBuf, mixsample_t *pRearBuf, uint32 nFrames)
+{
+	GetMixerLoopFunctions().InterleaveFrontRear(pFrontBuf, pRearBuf, nFrames);
+}
+
+
+void MonoFromStereo(mixsample_t *pMixBuf, uint32 nSamples)
+{
+	GetMixerLoopFunctions().MonoFromStereo(pMixBuf, nSamples);
+}
+
+
+void StereoFill(mixsample_t *pBuffer, uint32 nSamples, mixsample_t &rofs, mixsample_t &lofs)
 {
-	if(gainFactor == 1.0f)
+	GetMixerLoopFunctions().StereoFill(pBuffer, nSamples, rofs, lofs);
+}
+
+
+void EndChannelOfs(MixVoice &chn, mixsample_t *pBuffer, uint32 nSamples)
+{
+	GetMixerLoopFunctions().EndChannelOfs(chn, pBuffer, nSamples);
+}
+
+
+bool MultiVoiceMix16Mono(const MixVoiceLane *lanes, bool linear, mixsample_t *pBuffer, uint32 nSamples)
+{
+	const auto mixFunc = GetMixerLoopFunctions().MultiVoiceMix16Mono[linear ? 1 : 0];
+	if(mixFunc == nullptr)
 	{
-		// nothing to do, gain == +/- 0dB
-		return;
+		return false;
 	}
-	for(std::size_t i = 0; i < countChunk; ++i)
+	// Volumes are multiplied as 16-bit values
+	for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
 	{
-		for(std::size_t channel = 0; channel < channels; ++channel)
-		{
-			outputBuffer(channel, offset + i) *= gainFactor;
-		}
+		const MixVoice &chn = *lanes[v].voice;
+		if(chn.leftVol != static_cast<int16>(chn.leftVol) || chn.rightVol != static_cast<int16>(chn.rightVol))
+			return false;
 	}
+	mixFunc(lanes, pBuffer, nSamples);
+	return true;
 }
 
-void ApplyGain(audio_buffer_planar<float> outputBuffer, std::size_t offset, std::size_t channels, std::size_t countChunk, float gainFactor)
+
+bool FloatToInt16(const float *pIn, int16 *pOut, std::size_t numSamples, float gain)
 {
-	if(gainFactor == 1.0f)
+	const auto convertFunc = GetMixerLoopFunctions().FloatToInt16;
+	if(convertFunc == nullptr)
 	{
-		// nothing to do, gain == +/- 0dB
-		return;
+		return false;
 	}
-	for(std::size_t i = 0; i < countChunk; ++i)
+	convertFunc(pIn, pOut, numSamples, gain);
+	return true;
+}
+
+
+void InterleaveStereo(const mixsample_t * MPT_RESTRICT inputL, const mixsample_t * MPT_RESTRICT inputR, mixsample_t * MPT_RESTRICT output, size_t numSamples)
+{
+	while(numSamples--)
 	{
-		for(std::size_t channel = 0; channel < channels; ++channel)
-		{
-			outputBuffer(channel, offset + i) *= gainFactor;
-		}
+		*(output++) = *(inputL++);
+		*(output++) = *(inputR++);
 	}
 }
 
 
-#endif // !MODPLUG_TRACKER
+void DeinterleaveStereo(const mixsample_t * MPT_RESTRICT input, mixsample_t * MPT_RESTRICT outputL, mixsample_t * MPT_RESTRICT outputR, size_t numSamples)
+{
+	while(numSamples--)
+	{
+		*(outputL++) = *(input++);
+		*(outputR++) = *(input++);
+	}
+}
 
 
 OPENMPT_NAMESPACE_END
@@ -16,22 +16,14 @@
 
 OPENMPT_NAMESPACE_BEGIN
 
-struct ModChannel;
-template <typename SampleType> struct audio_buffer_interleaved;
-template <typename SampleType> struct audio_buffer_planar;
+struct MixVoice;
+struct MixVoiceLane;
 
 void StereoMixToFloat(const int32 *pSrc, float *pOut1, float *pOut2, uint32 nCount, const float _i2fc);
 void FloatToStereoMix(const float *pIn1, const float *pIn2, int32 *pOut, uint32 uint32, const float _f2ic);
 void MonoMixToFloat(const int32 *pSrc, float *pOut, uint32 uint32, const float _i2fc);
 void FloatToMonoMix(const float *pIn, int32 *pOut, uint32 uint32, const float _f2ic);
 
-#ifndef MODPLUG_TRACKER
-void ApplyGain(MixSampleInt *soundBuffer, std::size_t channels, std::size_t countChunk, int32 gainFactor16_16);
-void ApplyGain(MixSampleFloat *soundBuffer, std::size_t channels, std::size_t countChunk, float gainFactor);
-void ApplyGain(audio_buffer_interleaved<float> outputBuffer, std::size_t offset, std::size_t channels, std::size_t countChunk, float gainFactor);
-void ApplyGain(audio_buffer_planar<float> outputBuffer, std::size_t offset, std::size_t channels, std::size_t countChunk, float gainFactor);
-#endif // !MODPLUG_TRACKER
-
 void InitMixBuffer(mixsample_t *pBuffer, uint32 nSamples);
 void InterleaveFrontRear(mixsample_t *pFrontBuf, mixsample_t *pRearBuf, uint32 nFrames);
 void MonoFromStereo(mixsample_t *pMixBuf, uint32 nSamples);
@@ -39,7 +31,15 @@ void MonoFromStereo(mixsample_t *pMixBuf, uint32 nSamples);
 void InterleaveStereo(const mixsample_t *inputL, const mixsample_t *inputR, mixsample_t *output, size_t numSamples);
 void DeinterleaveStereo(const mixsample_t *input, mixsample_t *outputL, mixsample_t *outputR, size_t numSamples);
 
-void EndChannelOfs(ModChannel &chn, mixsample_t *pBuffer, uint32 nSamples);
+void EndChannelOfs(MixVoice &chn, mixsample_t *pBuffer, uint32 nSamples);
+
+// Mix MIXVOICES_PER_BATCH non-ramping, unfiltered 16-bit mono voices using either no or linear interpolation.
+// Returns false if there is no optimized implementation available, in which case nothing is mixed.
+bool MultiVoiceMix16Mono(const MixVoiceLane *lanes, bool linear, mixsample_t *pBuffer, uint32 nSamples);
 void StereoFill(mixsample_t *pBuffer, uint32 nSamples, mixsample_t &rofs, mixsample_t &lofs);
 
+// Convert float samples multiplied by gain to 16-bit samples without dithering, like SC::Convert<int16, float32>.
+// Returns false if there is no optimized implementation available, in which case nothing is converted.
+bool FloatToInt16(const float *pIn, int16 *pOut, std::size_t numSamples, float gain);
+
 OPENMPT_NAMESPACE_END
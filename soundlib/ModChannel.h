@@ -21,6 +21,39 @@ OPENMPT_NAMESPACE_BEGIN
 
 class CSoundFile;
 
+// Hot voice state that is touched by the mixer for every rendered sample.
+// CreateStereoMix gathers this state from all channels that are about to be mixed into a compact,
+// cache-line-aligned array (CSoundFile::m_MixVoices), so that the mixer loops do not have to stride
+// through the much larger ModChannel structs. Member names match their ModChannel counterparts.
+struct MixVoice
+{
+	SamplePosition position;     // Current play position (fixed point)
+	SamplePosition increment;    // Sample speed relative to mixing frequency (fixed point)
+	const void *pCurrentSample;  // Currently playing sample (nullptr if no sample is playing)
+	const ModSample *pModSample; // Currently assigned sample slot
+	Paula::State *paulaState;    // Amiga resampler state (not copied, as it is quite big)
+	int32 leftVol, rightVol;
+	int32 leftRamp, rightRamp;
+	int32 rampLeftVol, rampRightVol;
+	mixsample_t nFilter_Y[2][2];
+	mixsample_t nFilter_A0, nFilter_B0, nFilter_B1;
+	mixsample_t nFilter_HP;
+	SmpLength nLength;
+	SmpLength nLoopStart;
+	SmpLength nLoopEnd;
+	FlagSet<ChannelFlags> dwFlags;
+	mixsample_t nROfs, nLOfs;
+	uint32 nRampLength;
+	ResamplingMode resamplingMode;
+
+	// Check if currently processed loop is a sustain loop. pModSample is not checked for validity!
+	bool InSustainLoop() const { return (dwFlags & (CHN_LOOP | CHN_KEYOFF)) == CHN_LOOP && pModSample->uFlags[CHN_SUSTAINLOOP]; }
+};
+
+// Keep it at no more than two cache lines
+MPT_STATIC_ASSERT(sizeof(MixVoice) <= 128);
+
+
 // Mix Channel Struct
 struct ModChannel
 {
@@ -178,6 +211,57 @@ struct ModChannel
 
 	bool IsSamplePlaying() const { return !increment.IsZero(); }
 
+	// Copy the mixer state to a voice render state and back
+	void GetMixVoice(MixVoice &voice)
+	{
+		voice.position = position;
+		voice.increment = increment;
+		voice.pCurrentSample = pCurrentSample;
+		voice.pModSample = pModSample;
+		voice.paulaState = &paulaState;
+		voice.leftVol = leftVol;
+		voice.rightVol = rightVol;
+		voice.leftRamp = leftRamp;
+		voice.rightRamp = rightRamp;
+		voice.rampLeftVol = rampLeftVol;
+		voice.rampRightVol = rampRightVol;
+		std::copy(&nFilter_Y[0][0], &nFilter_Y[0][0] + 4, &voice.nFilter_Y[0][0]);
+		voice.nFilter_A0 = nFilter_A0;
+		voice.nFilter_B0 = nFilter_B0;
+		voice.nFilter_B1 = nFilter_B1;
+		voice.nFilter_HP = nFilter_HP;
+		voice.nLength = nLength;
+		voice.nLoopStart = nLoopStart;
+		voice.nLoopEnd = nLoopEnd;
+		voice.dwFlags = dwFlags;
+		voice.nROfs = nROfs;
+		voice.nLOfs = nLOfs;
+		voice.nRampLength = nRampLength;
+		voice.resamplingMode = resamplingMode;
+	}
+
+	void SetMixVoice(const MixVoice &voice)
+	{
+		position = voice.position;
+		increment = voice.increment;
+		pCurrentSample = voice.pCurrentSample;
+		pModSample = voice.pModSample;
+		leftVol = voice.leftVol;
+		rightVol = voice.rightVol;
+		leftRamp = voice.leftRamp;
+		rightRamp = voice.rightRamp;
+		rampLeftVol = voice.rampLeftVol;
+		rampRightVol = voice.rampRightVol;
+		std::copy(&voice.nFilter_Y[0][0], &voice.nFilter_Y[0][0] + 4, &nFilter_Y[0][0]);
+		nLength = voice.nLength;
+		nLoopStart = voice.nLoopStart;
+		nLoopEnd = voice.nLoopEnd;
+		dwFlags = voice.dwFlags;
+		nROfs = voice.nROfs;
+		nLOfs = voice.nLOfs;
+		nRampLength = voice.nRampLength;
+	}
+
 	uint32 GetVSTVolume() { return (pModInstrument) ? pModInstrument->nGlobalVol * 4 : nVolume; }
 
 	ModCommand::NOTE GetPluginNote(bool realNoteMapping) const;
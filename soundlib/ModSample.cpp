@@ -420,6 +420,155 @@ void ModSample::PrecomputeLoops(CSoundFile &sndFile, bool updateChannels)
 		PrecomputeLoopsImpl<int16>(*this, sndFile);
 	else if(GetElementarySampleSize() == 1)
 		PrecomputeLoopsImpl<int8>(*this, sndFile);
+
+	sndFile.InvalidateSamplePyramid(*this);
+}
+
+
+namespace
+{
+
+// Blackman-windowed half-band lowpass filter with a cutoff at a quarter of the sampling rate, as 1.15 fixed point coefficients.
+// Only the centre tap and the odd taps of a half-band filter are non-zero; oddTaps[k] is the coefficient of taps +/-(2k+1).
+struct HalfBandFilter
+{
+	int32 centreTap;
+	int32 oddTaps[(SamplePyramid::filterHalfLength + 1) / 2];
+
+	HalfBandFilter()
+	{
+		const int halfLength = SamplePyramid::filterHalfLength;
+		double coeffs[SamplePyramid::filterHalfLength + 1];
+		double sum = 0.5;
+		coeffs[0] = 0.5;
+		for(int i = 1; i <= halfLength; i++)
+		{
+			const double x = M_PI * i / (halfLength + 1);
+			const double window = 0.42 + 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+			coeffs[i] = (i % 2) ? window * std::sin(M_PI * i / 2.0) / (M_PI * i) : 0.0;
+			sum += 2.0 * coeffs[i];
+		}
+		// The centre tap absorbs the rounding errors of the other taps, so that DC passes through all levels unchanged
+		centreTap = 1 << 15;
+		for(int k = 0; k < (halfLength + 1) / 2; k++)
+		{
+			oddTaps[k] = mpt::saturate_round<int32>(coeffs[2 * k + 1] / sum * (1 << 15));
+			centreTap -= 2 * oddTaps[k];
+		}
+	}
+};
+
+
+// Low-pass filter and decimate numFrames sampling points of src by 2.
+// Like the regular sample padding, the first and last sampling point are held beyond the source boundaries.
+template<typename T>
+void DecimateSampleData(T *dst, const T *src, SmpLength numFrames, int numChannels, const HalfBandFilter &filter)
+{
+	const int halfLength = SamplePyramid::filterHalfLength;
+	const SmpLength outFrames = (numFrames + 1) / 2;
+	const auto sourceFrame = [numFrames](SmpLength centre, int offset) -> SmpLength
+	{
+		if(offset < 0 && centre < static_cast<SmpLength>(-offset))
+			return 0;
+		return std::min(centre + offset, numFrames - 1);
+	};
+	for(SmpLength i = 0; i < outFrames; i++)
+	{
+		const SmpLength centre = i * 2;
+		const bool nearBoundary = centre < static_cast<SmpLength>(halfLength) || centre + halfLength >= numFrames;
+		for(int c = 0; c < numChannels; c++)
+		{
+			// With the worst-case input, the sum reaches about 1.7 times full scale in 1.15 fixed point, which is uncomfortably close to the int32 limit
+			int64 acc = static_cast<int64>(filter.centreTap) * src[centre * numChannels + c];
+			for(int k = 0; k < (halfLength + 1) / 2; k++)
+			{
+				const int offset = 2 * k + 1;
+				int32 pair;
+				if(nearBoundary)
+					pair = src[sourceFrame(centre, -offset) * numChannels + c] + src[sourceFrame(centre, offset) * numChannels + c];
+				else
+					pair = src[(centre - offset) * numChannels + c] + src[(centre + offset) * numChannels + c];
+				acc += static_cast<int64>(filter.oddTaps[k]) * pair;
+			}
+			dst[i * numChannels + c] = mpt::saturate_cast<T>((acc + (1 << 14)) >> 15);
+		}
+	}
+}
+
+
+template<typename T>
+void BuildSamplePyramid(SamplePyramid &pyramid, const ModSample &smp)
+{
+	static const HalfBandFilter filter;
+	const int numChannels = smp.GetNumChannels();
+	const SmpLength padding = InterpolationMaxLookahead;
+
+	// Each level is surrounded by padding, like the original sample data
+	SmpLength levelFrames[SamplePyramid::numLevels];
+	std::size_t totalFrames = 0;
+	SmpLength numFrames = smp.nLength;
+	for(int level = 0; level < SamplePyramid::numLevels; level++)
+	{
+		numFrames = (numFrames + 1) / 2;
+		levelFrames[level] = numFrames;
+		pyramid.levelOffset[level] = (totalFrames + padding) * numChannels * sizeof(T);
+		totalFrames += numFrames + 2 * padding;
+	}
+	pyramid.data.assign(totalFrames * numChannels * sizeof(T), 0);
+
+	const T *src = static_cast<const T *>(smp.samplev());
+	SmpLength srcFrames = smp.nLength;
+	for(int level = 0; level < SamplePyramid::numLevels; level++)
+	{
+		T *dst = reinterpret_cast<T *>(pyramid.data.data() + pyramid.levelOffset[level]);
+		DecimateSampleData(dst, src, srcFrames, numChannels, filter);
+		const SmpLength dstFrames = levelFrames[level];
+		for(SmpLength i = 0; i < padding; i++)
+		{
+			for(int c = 0; c < numChannels; c++)
+			{
+				dst[-static_cast<std::ptrdiff_t>(i + 1) * numChannels + c] = dst[c];
+				dst[(dstFrames + i) * numChannels + c] = dst[(dstFrames - 1) * numChannels + c];
+			}
+		}
+		src = dst;
+		srcFrames = dstFrames;
+	}
+}
+
+} // unnamed namespace
+
+
+void SamplePyramid::Build(const ModSample &smp)
+{
+	Reset();
+	if(!smp.HasSampleData())
+		return;
+	try
+	{
+		if(smp.GetElementarySampleSize() == 2)
+			BuildSamplePyramid<int16>(*this, smp);
+		else if(smp.GetElementarySampleSize() == 1)
+			BuildSamplePyramid<int8>(*this, smp);
+		else
+			return;
+	} MPT_EXCEPTION_CATCH_OUT_OF_MEMORY(e)
+	{
+		MPT_EXCEPTION_DELETE_OUT_OF_MEMORY(e);
+		Reset();
+		return;
+	}
+	source = smp.samplev();
+	sourceLength = smp.nLength;
+	sourceGeneration = generation;
+}
+
+
+void SamplePyramid::Reset()
+{
+	source = nullptr;
+	sourceLength = 0;
+	data.clear();
 }
 
 
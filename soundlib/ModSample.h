@@ -159,4 +159,36 @@ struct ModSample
 	void SetAdlib(bool enable, OPLPatch patch = OPLPatch{{}});
 };
 
+// Band-limited copies of a sample's data, decimated by 2, 4 and 8 (levels 1 to 3).
+// Voices that are played back at several times the sample's native rate can be rendered from these copies,
+// so that the interpolation filter does not have to skip over most of the sample data, which would cause aliasing.
+// Each level has the same format as the source sample and is padded like regular sample data, so that it can be passed to the regular mix functions.
+struct SamplePyramid
+{
+	enum : int
+	{
+		numLevels = 3,
+		filterHalfLength = 31,	// Half-length of the half-band decimation filter
+		interpolationLength = 4,	// Number of sampling points the mixer's interpolation filters read on either side of the play position
+	};
+
+	const void *source = nullptr;	// Sample data that the levels were computed from
+	SmpLength sourceLength = 0;
+	uint32 generation = 0;	// Incremented whenever the source sample's data is modified
+	uint32 sourceGeneration = 0;	// Value of generation when the levels were computed
+	std::vector<int8> data;
+	std::size_t levelOffset[numLevels] = {};	// Offset of each level's first sampling point in bytes
+
+	// Compute all levels from the sample's current data.
+	void Build(const ModSample &smp);
+	// Discard all levels. The generation counter is kept.
+	void Reset();
+	// The sample data may have been modified in place or reallocated at the same address, so comparing the pointer is not sufficient.
+	bool IsValidFor(const ModSample &smp) const { return source != nullptr && source == smp.samplev() && sourceLength == smp.nLength && sourceGeneration == generation; }
+
+	const void *GetLevel(int level) const { return data.data() + levelOffset[level - 1]; }
+	// Number of sampling points of the source sample around the play position that influence what is read from the given level
+	static SmpLength GetMargin(int level) { return filterHalfLength * ((1u << level) - 1u) + interpolationLength * (1u << level) + 1u; }
+};
+
 OPENMPT_NAMESPACE_END
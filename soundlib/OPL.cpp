@@ -20,6 +20,7 @@ OPL::OPL()
 	m_KeyOnBlock.fill(0);
 	m_OPLtoChan.fill(CHANNELINDEX_INVALID);
 	m_ChanToOPL.fill(OPL_CHANNEL_INVALID);
+	ResetResampler();
 }
 
 
@@ -31,14 +32,59 @@ OPL::~OPL()
 
 void OPL::Initialize(uint32 samplerate)
 {
+	// The emulator always runs at its native sample rate, its output is converted to the mix rate in Mix()
 	if(m_opl == nullptr)
-		m_opl = std::make_unique<Opal>(samplerate);
-	else
-		m_opl->SetSampleRate(samplerate);
+		m_opl = std::make_unique<Opal>(OPL_BASERATE);
+	if(samplerate != m_sampleRate)
+		InitResampler(samplerate);
 	Reset();
 }
 
 
+// Windowed sinc filter (4-term Blackman-Harris window) with a cutoff at 0.45 times the lower of both sample rates.
+void OPL::InitResampler(uint32 samplerate)
+{
+	m_sampleRate = samplerate;
+	m_srcCoeffs.clear();
+	ResetResampler();
+	if(samplerate == OPL_BASERATE)
+		return;
+
+	const double cutoff = 0.45 * std::min(1.0, static_cast<double>(samplerate) / OPL_BASERATE);
+	const int phases = 1 << SRC_PHASE_BITS;
+	m_srcCoeffs.resize(phases * SRC_TAPS);
+	for(int phase = 0; phase < phases; phase++)
+	{
+		double coeffs[SRC_TAPS], sum = 0.0;
+		for(int tap = 0; tap < SRC_TAPS; tap++)
+		{
+			// Distance of this tap from the output position, which lies between taps SRC_TAPS / 2 - 1 and SRC_TAPS / 2
+			const double x = (tap - (SRC_TAPS / 2 - 1)) - (phase + 0.5) / phases;
+			const double w = 2.0 * M_PI * (x + SRC_TAPS / 2) / SRC_TAPS;
+			const double window = 0.35875 - 0.48829 * std::cos(w) + 0.14128 * std::cos(2.0 * w) - 0.01168 * std::cos(3.0 * w);
+			coeffs[tap] = window * std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+			sum += coeffs[tap];
+		}
+		for(int tap = 0; tap < SRC_TAPS; tap++)
+		{
+			m_srcCoeffs[phase * SRC_TAPS + tap] = mpt::saturate_round<int16>(coeffs[tap] / sum * (1 << 15));
+		}
+	}
+	m_srcIncrement = (static_cast<uint64>(OPL_BASERATE) << 32) / samplerate;
+}
+
+
+void OPL::ResetResampler()
+{
+	// The filter needs SRC_TAPS / 2 emulator frames past the output position. If the emulator ran that far ahead of the play position,
+	// register writes from the next tick would only be heard after those frames, i.e. about 0.3 ms late, but not on the first tick.
+	// Instead, the output is delayed by half the filter length, so that the newest emulator frame read for an output frame is the one at its play position
+	// and every register write takes effect with the same latency.
+	m_nativeBuffer.assign((SRC_TAPS - 1) * 2, 0);
+	m_srcPosition = static_cast<uint64>(SRC_TAPS / 2 - 1) << 32;
+}
+
+
 void OPL::Mix(int32 *target, size_t count, uint32 volumeFactorQ16)
 {
 	if(!m_isActive)
@@ -46,14 +92,47 @@ void OPL::Mix(int32 *target, size_t count, uint32 volumeFactorQ16)
 
 	// This factor causes a sample voice to be more or less as loud as an OPL voice
 	const int32 factor = (volumeFactorQ16 * 6169) / (1 << 16);
-	while(count--)
+
+	if(m_srcCoeffs.empty())
 	{
-		int16 l, r;
-		m_opl->Sample(&l, &r);
-		target[0] += l * factor;
-		target[1] += r * factor;
+		m_nativeBuffer.resize(count * 2);
+		m_opl->SampleNative(m_nativeBuffer.data(), count);
+		for(size_t i = 0; i < count * 2; i++)
+		{
+			target[i] += m_nativeBuffer[i] * factor;
+		}
+		return;
+	}
+
+	// Render all emulator frames required for this block in one go
+	const size_t available = m_nativeBuffer.size() / 2;
+	const size_t required = static_cast<size_t>((m_srcPosition + (count - 1) * m_srcIncrement) >> 32) + SRC_TAPS / 2 + 1;
+	if(required > available)
+	{
+		m_nativeBuffer.resize(required * 2);
+		m_opl->SampleNative(m_nativeBuffer.data() + available * 2, required - available);
+	}
+
+	for(size_t i = 0; i < count; i++)
+	{
+		const int16 *coeffs = m_srcCoeffs.data() + (static_cast<uint32>(m_srcPosition) >> (32 - SRC_PHASE_BITS)) * SRC_TAPS;
+		const int16 *in = m_nativeBuffer.data() + (static_cast<size_t>(m_srcPosition >> 32) + 1 - SRC_TAPS / 2) * 2;
+		int32 l = 0, r = 0;
+		for(int tap = 0; tap < SRC_TAPS; tap++)
+		{
+			l += in[tap * 2] * coeffs[tap];
+			r += in[tap * 2 + 1] * coeffs[tap];
+		}
+		target[0] += ((l + (1 << 14)) >> 15) * factor;
+		target[1] += ((r + (1 << 14)) >> 15) * factor;
 		target += 2;
+		m_srcPosition += m_srcIncrement;
 	}
+
+	// Discard emulator frames that are not needed as filter history anymore
+	const size_t discard = static_cast<size_t>(m_srcPosition >> 32) + 1 - SRC_TAPS / 2;
+	m_nativeBuffer.erase(m_nativeBuffer.begin(), m_nativeBuffer.begin() + discard * 2);
+	m_srcPosition -= static_cast<uint64>(discard) << 32;
 }
 
 
@@ -270,6 +349,7 @@ void OPL::Reset()
 	m_KeyOnBlock.fill(0);
 	m_OPLtoChan.fill(CHANNELINDEX_INVALID);
 	m_ChanToOPL.fill(OPL_CHANNEL_INVALID);
+	ResetResampler();
 }
 
 OPENMPT_NAMESPACE_END
@@ -89,16 +89,28 @@ protected:
 	static uint8 CalcVolume(uint8 trackerVol, uint8 kslVolume);
 	uint8 GetVoice(CHANNELINDEX c) const;
 	uint8 AllocateVoice(CHANNELINDEX c);
+	void InitResampler(uint32 samplerate);
+	// Discard emulator output that has not been converted to the mix rate yet
+	void ResetResampler();
 
 	enum
 	{
 		OPL_CHANNELS = 18,	// 9 for OPL2 or 18 for OPL3
 		OPL_CHANNEL_INVALID = 0xFF,
 		OPL_BASERATE = 49716,
+		// Polyphase FIR filter for converting from OPL_BASERATE to the mix rate
+		SRC_TAPS = 32,
+		SRC_PHASE_BITS = 10,
 	};
 
 	std::unique_ptr<Opal> m_opl;
 
+	uint32 m_sampleRate = 0;
+	std::vector<int16> m_srcCoeffs;	// (1 << SRC_PHASE_BITS) rows of SRC_TAPS coefficients in 1.15 fixed point, empty if mixing at OPL_BASERATE
+	std::vector<int16> m_nativeBuffer;	// Interleaved stereo emulator output at OPL_BASERATE, including the filter history. Never contains frames past the current play position.
+	uint64 m_srcPosition = 0;	// Position of the next output frame in m_nativeBuffer, 32.32 fixed point
+	uint64 m_srcIncrement = 0;	// Emulator frames per output frame, 32.32 fixed point
+
 	std::array<uint8, OPL_CHANNELS> m_KeyOnBlock;
 	std::array<CHANNELINDEX, OPL_CHANNELS> m_OPLtoChan;
 	std::array<uint8, MAX_CHANNELS> m_ChanToOPL;
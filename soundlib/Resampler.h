@@ -15,14 +15,16 @@
 #include "WindowedFIR.h"
 #include "Mixer.h"
 #include "MixerSettings.h"
+#include "Snd_defs.h"
 
 
 OPENMPT_NAMESPACE_BEGIN
 
 
-#ifdef LIBOPENMPT_BUILD
+#if defined(LIBOPENMPT_BUILD) && !defined(MPT_INTMIXER)
 // All these optimizations are not applicable to the tracker
 // because cutoff and firtype are configurable there.
+// With the integer mixer, the tables for the default settings are pre-computed at compile time instead.
 
 // Cache resampler tables across resampler object creation.
 // A C++11-style function-static singleton is holding the cached values.
@@ -34,7 +36,7 @@ OPENMPT_NAMESPACE_BEGIN
 // This is only really useful with MPT_RESAMPLER_TABLES_CACHED.
 #define MPT_RESAMPLER_TABLES_CACHED_ONSTARTUP
 
-#endif // LIBOPENMPT_BUILD
+#endif // LIBOPENMPT_BUILD && !MPT_INTMIXER
 
 
 #define SINC_WIDTH       8
@@ -60,17 +62,19 @@ public:
 	double gdWFIRCutoff;
 	uint8 gbWFIRType;
 	bool emulateAmiga;
+	bool samplePyramids;	// Render voices played far above the sample's native rate from band-limited, decimated copies of the sample data
 public:
 	MPT_CONSTEXPR11_FUN CResamplerSettings()
 		: SrcMode(Resampling::Default())
 		, gdWFIRCutoff(0.97)
 		, gbWFIRType(WFIR_KAISER4T)
 		, emulateAmiga(false)
+		, samplePyramids(false)
 	{
 	}
 	bool operator == (const CResamplerSettings &cmp) const
 	{
-		return SrcMode == cmp.SrcMode && gdWFIRCutoff == cmp.gdWFIRCutoff && gbWFIRType == cmp.gbWFIRType && emulateAmiga == cmp.emulateAmiga;
+		return SrcMode == cmp.SrcMode && gdWFIRCutoff == cmp.gdWFIRCutoff && gbWFIRType == cmp.gbWFIRType && emulateAmiga == cmp.emulateAmiga && samplePyramids == cmp.samplePyramids;
 	}
 	bool operator != (const CResamplerSettings &cmp) const { return !(*this == cmp); }
 };
@@ -83,6 +87,12 @@ public:
 	CWindowedFIR m_WindowedFIR;
 	static const int16 FastSincTable[256 * 4];
 
+#ifdef MPT_INTMIXER
+	// These do not depend on any settings and are pre-computed, see ResamplerTables.h
+	static const SINC_TYPE gKaiserSinc[SINC_PHASES * 8];     // Upsampling
+	static const SINC_TYPE gDownsample13x[SINC_PHASES * 8];  // Downsample 1.333x
+	static const SINC_TYPE gDownsample2x[SINC_PHASES * 8];   // Downsample 2x
+#else
 #ifdef MODPLUG_TRACKER
 	static bool StaticTablesInitialized;
 	#define RESAMPLER_TABLE static
@@ -95,12 +105,11 @@ public:
 	RESAMPLER_TABLE SINC_TYPE gDownsample13x[SINC_PHASES * 8];  // Downsample 1.333x
 	RESAMPLER_TABLE SINC_TYPE gDownsample2x[SINC_PHASES * 8];   // Downsample 2x
 
-#ifndef MPT_INTMIXER
 	RESAMPLER_TABLE mixsample_t FastSincTablef[256 * 4];	// Cubic spline LUT
 	RESAMPLER_TABLE mixsample_t LinearTablef[256];		// Linear interpolation LUT
-#endif // !defined(MPT_INTMIXER)
 
 #undef RESAMPLER_TABLE
+#endif // MPT_INTMIXER
 
 private:
 	CResamplerSettings m_OldSettings;
@@ -127,6 +136,8 @@ public:
 	{
 		InitializeTablesFromScratch(false);
 	}
+	// Compute the contents of gKaiserSinc, gDownsample13x and gDownsample2x
+	static void ComputeSincTables(SINC_TYPE *kaiserSinc, SINC_TYPE *downsample13x, SINC_TYPE *downsample2x);
 private:
 	void InitFloatmixerTables();
 	void InitializeTablesFromScratch(bool force=false);
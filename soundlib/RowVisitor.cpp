@@ -42,6 +42,17 @@ RowVisitor& RowVisitor::operator=(RowVisitor &&other)
 }
 
 
+RowVisitor& RowVisitor::operator=(const RowVisitor &other)
+{
+	MPT_ASSERT(&m_sndFile == &other.m_sndFile);
+	m_visitedRows = other.m_visitedRows;
+	m_visitOrder = other.m_visitOrder;
+	m_currentOrder = other.m_currentOrder;
+	m_sequence = other.m_sequence;
+	return *this;
+}
+
+
 const ModSequence &RowVisitor::Order() const
 {
 	if(m_sequence >= m_sndFile.Order.GetNumSequences())
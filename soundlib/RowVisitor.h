@@ -34,7 +34,10 @@ protected:
 
 public:
 	RowVisitor(const CSoundFile &sf, SEQUENCEINDEX sequence = SEQUENCEINDEX_INVALID);
+	RowVisitor(const RowVisitor &other) = default;
 	RowVisitor& operator=(RowVisitor &&other);
+	// Copies the complete visited row state of another RowVisitor of the same module
+	RowVisitor& operator=(const RowVisitor &other);
 
 	// Resize / Clear the row vector.
 	// If reset is true, the vector is not only resized to the required dimensions, but also completely cleared (i.e. all visited rows are unset).
@@ -129,7 +129,8 @@ size_t SampleIO::ReadSample(ModSample &sample, FileReader &file) const
 		if(file.ReadArray(compressionTable))
 		{
 			size_t readLength = (sample.nLength + 1) / 2;
-			LimitMax(readLength, file.BytesLeft());
+			// The pinned view is already limited to the available data. Unlike BytesLeft(), this does not require the length of the whole file.
+			LimitMax(readLength, fileSize - std::min(static_cast<FileReader::off_t>(sizeof(compressionTable)), fileSize));
 
 			const uint8 *inBuf = mpt::byte_cast<const uint8*>(sourceBuf) + sizeof(compressionTable);
 			int8 *outBuf = sample.sample8();
@@ -839,7 +840,11 @@ size_t SampleIO::ReadSample(ModSample &sample, FileReader &file) const
 		MPT_ASSERT_NOTREACHED();
 	}
 
-	MPT_ASSERT(filePosition + bytesRead <= file.GetLength());
+#ifdef MPT_BUILD_DEBUG
+	// CanRead() instead of GetLength() avoids reading all of an unseekable stream
+	file.Seek(filePosition);
+	MPT_ASSERT(file.CanRead(bytesRead));
+#endif
 	file.Seek(filePosition + bytesRead);
 	return bytesRead;
 }
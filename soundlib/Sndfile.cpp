@@ -34,6 +34,7 @@
 #include "../common/FileReader.h"
 #include "Container.h"
 #include "OPL.h"
+#include "SampleIO.h"
 
 #ifndef NO_ARCHIVE_SUPPORT
 #include "../unarchiver/unarchiver.h"
@@ -43,6 +44,18 @@
 OPENMPT_NAMESPACE_BEGIN
 
 
+// Location of sample data that is read after the module has been loaded (progressive loading)
+struct PendingSampleData
+{
+	FileReader file;
+	FileReader::off_t offset;
+	SampleIO sampleIO;
+	SmpLength encodedLength;  // Sample length that determines the size of the data in the file
+	SAMPLEINDEX sample;
+	FlagSet<CSoundFile::DeferSampleFlags> flags;
+};
+
+
 bool SettingCacheCompleteFileBeforeLoading()
 {
 	#ifdef MODPLUG_TRACKER
@@ -81,6 +94,7 @@ CSoundFile::CSoundFile() :
 	m_NoteNames(NoteNamesSharp),
 #endif
 	m_pModSpecs(&ModSpecs::itEx),
+	m_MixVoices(MAX_CHANNELS),
 	m_nType(MOD_TYPE_NONE),
 	Patterns(*this),
 #ifdef MODPLUG_TRACKER
@@ -266,6 +280,162 @@ static constexpr FileFormatLoader ModuleFormatLoaders[] =
 #undef MPT_DECLARE_FORMAT
 
 
+using ProbeFunc = decltype(CSoundFile::ProbeFileHeaderXM);
+
+static constexpr ProbeFunc *ContainerProbers[] =
+{
+	CSoundFile::ProbeFileHeaderMMCMP,
+	CSoundFile::ProbeFileHeaderPP20,
+	CSoundFile::ProbeFileHeaderUMX,
+	CSoundFile::ProbeFileHeaderXPK,
+};
+
+MPT_STATIC_ASSERT(mpt::size(ContainerProbers) + mpt::size(ModuleFormatLoaders) <= 64);
+
+
+// Magic bytes at fixed offsets which a format's prober requires to be present.
+// If a prober is listed here and none of its signatures match, it can only fail.
+// Formats without reliable magic bytes (STM, MOD, C67, M15, ...) are not listed and always probed.
+// Only the first 8 bytes of each signature are compared, so that each check is a single 64-bit compare.
+struct ProbeSignature
+{
+	ProbeFunc *prober;
+	uint16 offset;
+	uint8 length;
+	const char *magic;
+};
+
+static constexpr ProbeSignature ProbeSignatures[] =
+{
+	{ CSoundFile::ProbeFileHeaderMMCMP, 0, 8, "ziRCONia" },
+	{ CSoundFile::ProbeFileHeaderPP20, 0, 4, "PP20" },
+	{ CSoundFile::ProbeFileHeaderUMX, 0, 4, "\xC1\x83\x2A\x9E" },
+	{ CSoundFile::ProbeFileHeaderXPK, 0, 4, "XPKF" },
+	{ CSoundFile::ProbeFileHeaderXM, 0, 8, "Extended" },
+	{ CSoundFile::ProbeFileHeaderIT, 0, 4, "IMPM" },
+	{ CSoundFile::ProbeFileHeaderIT, 0, 4, "tpm." },
+	{ CSoundFile::ProbeFileHeaderS3M, 0x2C, 4, "SCRM" },
+	{ CSoundFile::ProbeFileHeaderMED, 0, 3, "MMD" },
+	{ CSoundFile::ProbeFileHeaderMTM, 0, 3, "MTM" },
+	{ CSoundFile::ProbeFileHeaderMDL, 0, 4, "DMDL" },
+	{ CSoundFile::ProbeFileHeaderDBM, 0, 4, "DBM0" },
+	{ CSoundFile::ProbeFileHeaderFAR, 0, 4, "FAR\xFE" },
+	{ CSoundFile::ProbeFileHeaderAMS, 0, 7, "Extreme" },
+	{ CSoundFile::ProbeFileHeaderAMS2, 0, 7, "AMShdr\x1A" },
+	{ CSoundFile::ProbeFileHeaderOKT, 0, 8, "OKTASONG" },
+	{ CSoundFile::ProbeFileHeaderPTM, 0x2C, 4, "PTMF" },
+	{ CSoundFile::ProbeFileHeaderULT, 0, 8, "MAS_UTra" },
+	{ CSoundFile::ProbeFileHeaderDMF, 0, 4, "DDMF" },
+	{ CSoundFile::ProbeFileHeaderDSM, 0, 4, "RIFF" },
+	{ CSoundFile::ProbeFileHeaderDSM, 0, 4, "DSMF" },
+	{ CSoundFile::ProbeFileHeaderAMF_Asylum, 0, 8, "ASYLUM M" },
+	{ CSoundFile::ProbeFileHeaderAMF_DSMI, 0, 3, "AMF" },
+	{ CSoundFile::ProbeFileHeaderPSM, 0, 4, "PSM " },
+	{ CSoundFile::ProbeFileHeaderPSM, 0, 4, "QUP$" },
+	{ CSoundFile::ProbeFileHeaderPSM16, 0, 4, "PSM\xFE" },
+	{ CSoundFile::ProbeFileHeaderMT2, 0, 4, "MT20" },
+	{ CSoundFile::ProbeFileHeaderITP, 0, 4, "pti." },
+	{ CSoundFile::ProbeFileHeaderGDM, 0, 4, "GDM\xFE" },
+	{ CSoundFile::ProbeFileHeaderIMF, 0x3C, 4, "IM10" },
+	{ CSoundFile::ProbeFileHeaderDIGI, 0, 8, "DIGI Boo" },
+	{ CSoundFile::ProbeFileHeaderDTM, 0, 4, "D.T." },
+	{ CSoundFile::ProbeFileHeaderPLM, 0, 4, "PLM\x1A" },
+	{ CSoundFile::ProbeFileHeaderAM, 0, 4, "RIFF" },
+	{ CSoundFile::ProbeFileHeaderJ2B, 0, 4, "MUSE" },
+	{ CSoundFile::ProbeFileHeaderPT36, 0, 4, "FORM" },
+	{ CSoundFile::ProbeFileHeaderSFX, 0x3C, 4, "SONG" },
+	{ CSoundFile::ProbeFileHeaderSFX, 0x7C, 4, "SO31" },
+	{ CSoundFile::ProbeFileHeaderSTP, 0, 4, "STP3" },
+	{ CSoundFile::ProbeFileHeaderICE, 1464, 4, "MTN\0" },
+	{ CSoundFile::ProbeFileHeaderICE, 1464, 4, "IT10" },
+	{ CSoundFile::ProbeFileHeader669, 0, 2, "if" },
+	{ CSoundFile::ProbeFileHeader669, 0, 2, "JN" },
+	{ CSoundFile::ProbeFileHeaderMO3, 0, 3, "MO3" },
+};
+
+
+static constexpr std::size_t GetProbeSignatureAreaSize()
+{
+	std::size_t size = 0;
+	for(const auto &signature : ProbeSignatures)
+	{
+		size = std::max(size, signature.offset + sizeof(uint64));
+	}
+	return size;
+}
+
+MPT_STATIC_ASSERT(GetProbeSignatureAreaSize() <= PROBE_RECOMMENDED_SIZE);
+
+
+// Position of a prober in the probing order, containers first.
+static std::size_t GetProberIndex(ProbeFunc *prober)
+{
+	std::size_t index = 0;
+	for(auto containerProber : ContainerProbers)
+	{
+		if(containerProber == prober)
+			return index;
+		index++;
+	}
+	for(const auto &format : ModuleFormatLoaders)
+	{
+		if(format.prober == prober)
+			return index;
+		index++;
+	}
+	return index;
+}
+
+
+// Returns a bit mask of all probers (indexed like GetProberIndex) which may succeed on the given data.
+static uint64 GetProbeCandidates(mpt::span<const mpt::byte> data)
+{
+	struct SignatureWord
+	{
+		uint64 word;
+		uint64 mask;
+		uint64 proberBit;
+		std::size_t offset;
+	};
+	struct SignatureWords
+	{
+		std::vector<SignatureWord> signatures;
+		uint64 listedProbers = 0;
+	};
+	static const SignatureWords signatureWords = []()
+	{
+		SignatureWords result;
+		for(const auto &signature : ProbeSignatures)
+		{
+			const std::size_t index = GetProberIndex(signature.prober);
+			if(index >= 64)
+				continue;
+			SignatureWord word{ 0, 0, uint64(1) << index, signature.offset };
+			const std::size_t length = std::min(std::size_t(signature.length), sizeof(uint64));
+			std::memcpy(&word.word, signature.magic, length);
+			std::memset(&word.mask, 0xFF, length);
+			result.signatures.push_back(word);
+			result.listedProbers |= word.proberBit;
+		}
+		return result;
+	}();
+
+	// Zero-padding short files can only cause false positives, which are harmless here.
+	mpt::byte header[GetProbeSignatureAreaSize()] = {};
+	std::memcpy(header, data.data(), std::min(data.size(), sizeof(header)));
+
+	uint64 candidates = ~signatureWords.listedProbers;
+	for(const auto &signature : signatureWords.signatures)
+	{
+		uint64 word;
+		std::memcpy(&word, header + signature.offset, sizeof(word));
+		if(((word ^ signature.word) & signature.mask) == 0)
+			candidates |= signature.proberBit;
+	}
+	return candidates;
+}
+
+
 CSoundFile::ProbeResult CSoundFile::ProbeAdditionalSize(MemoryFileReader &file, const uint64 *pfilesize, uint64 minimumAdditionalSize)
 {
 	const uint64 availableFileSize = file.GetLength();
@@ -321,22 +491,27 @@ CSoundFile::ProbeResult CSoundFile::Probe(ProbeFlags flags, mpt::span<const mpt:
 		throw std::invalid_argument("");
 	}
 	MemoryFileReader file(data);
-	if(flags & ProbeContainers)
-	{
-		MPT_DO_PROBE(result, ProbeFileHeaderMMCMP(file, pfilesize));
-		MPT_DO_PROBE(result, ProbeFileHeaderPP20(file, pfilesize));
-		MPT_DO_PROBE(result, ProbeFileHeaderUMX(file, pfilesize));
-		MPT_DO_PROBE(result, ProbeFileHeaderXPK(file, pfilesize));
+	// A prober whose signatures do not match fails as soon as it could read its header. All of these headers fit into
+	// ProbeRecommendedSize, and if we already got the whole file, wanting more data ends up as failure anyway.
+	// In both cases, skipping such probers does not change the result.
+	const bool useSignatures = !(flags & ProbeAllFormats) && ((pfilesize && (*pfilesize <= data.size())) || (data.size() >= ProbeRecommendedSize));
+	const uint64 candidates = useSignatures ? GetProbeCandidates(data) : ~uint64(0);
+	std::size_t proberIndex = 0;
+	for(auto prober : ContainerProbers)
+	{
+		if((flags & ProbeContainers) && (candidates & (uint64(1) << proberIndex)))
+		{
+			MPT_DO_PROBE(result, prober(file, pfilesize));
+		}
+		proberIndex++;
 	}
-	if(flags & ProbeModules)
+	for(const auto &format : ModuleFormatLoaders)
 	{
-		for(const auto &format : ModuleFormatLoaders)
+		if((flags & ProbeModules) && format.prober != nullptr && (candidates & (uint64(1) << proberIndex)))
 		{
-			if(format.prober != nullptr)
-			{
-				MPT_DO_PROBE(result, format.prober(file, pfilesize));
-			}
+			MPT_DO_PROBE(result, format.prober(file, pfilesize));
 		}
+		proberIndex++;
 	}
 	if(pfilesize)
 	{
@@ -428,6 +603,7 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 			bool loaderSuccess = false;
 			for(const auto &format : ModuleFormatLoaders)
 			{
+				m_pendingSampleData.clear();
 				loaderSuccess = (this->*(format.loader))(file, loadFlags);
 				if(loaderSuccess)
 					break;
@@ -437,7 +613,10 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 			{
 				m_nType = MOD_TYPE_NONE;
 				m_ContainerType = MOD_CONTAINERTYPE_NONE;
+				m_pendingSampleData.clear();
 			}
+			// Pending sample data is consumed from the back
+			std::stable_sort(m_pendingSampleData.begin(), m_pendingSampleData.end(), [](const PendingSampleData &l, const PendingSampleData &r) { return l.offset > r.offset; });
 			if(loadFlags == onlyVerifyHeader)
 			{
 				return loaderSuccess;
@@ -481,9 +660,21 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 	}
 
 	// Checking samples, load external samples
+	std::vector<bool> samplePending(m_nSamples + 1, false);
+	for(const auto &pending : m_pendingSampleData)
+	{
+		if(pending.sample <= m_nSamples)
+			samplePending[pending.sample] = true;
+	}
 	for(SAMPLEINDEX nSmp = 1; nSmp <= m_nSamples; nSmp++)
 	{
 		ModSample &sample = Samples[nSmp];
+		if(samplePending[nSmp])
+		{
+			// Sample data arrives later, see ReadPendingSampleData()
+			if(sample.nGlobalVol > 64) sample.nGlobalVol = 64;
+			continue;
+		}
 
 #ifdef MPT_EXTERNAL_SAMPLES
 		if(SampleHasPath(nSmp))
@@ -672,8 +863,67 @@ bool CSoundFile::Create(FileReader file, ModLoadingFlags loadFlags)
 }
 
 
+void CSoundFile::DeferSampleData(SAMPLEINDEX smp, const SampleIO &sampleIO, const FileReader &file, uint64 offset, FlagSet<DeferSampleFlags> flags)
+{
+	MPT_ASSERT(smp > 0 && smp <= GetNumSamples());
+	m_pendingSampleData.push_back({ file, mpt::saturate_cast<FileReader::off_t>(offset), sampleIO, Samples[smp].nLength, smp, flags });
+}
+
+
+std::size_t CSoundFile::ReadPendingSampleData(std::size_t minBytes)
+{
+	std::size_t bytesRead = 0;
+	while(!m_pendingSampleData.empty() && bytesRead < minBytes)
+	{
+		PendingSampleData pending = std::move(m_pendingSampleData.back());
+		m_pendingSampleData.pop_back();
+		ModSample &sample = Samples[pending.sample];
+		const bool isMODSample = pending.flags[deferMODSample];
+		bool seekOk = pending.file.Seek(pending.offset);
+		if(!seekOk && isMODSample)
+		{
+			// Like when reading all MOD samples at once, samples beyond the end of the file are read from there and keep their length.
+			// As the stream has ended, its length is known now.
+			seekOk = pending.file.Seek(pending.file.GetLength());
+		}
+		if(seekOk)
+		{
+			if(isMODSample && pending.file.ReadMagic("ADPCM"))
+			{
+				// Compressed sample data is smaller, so the data of the following samples starts earlier than assumed.
+				pending.sampleIO = SampleIO(SampleIO::_8bit, SampleIO::mono, SampleIO::littleEndian, SampleIO::ADPCM);
+				const FileReader::off_t uncompressedSize = SampleIO(SampleIO::_8bit, SampleIO::mono, SampleIO::littleEndian, SampleIO::signedPCM).CalculateEncodedSize(pending.encodedLength);
+				const FileReader::off_t compressedSize = 5 + pending.sampleIO.CalculateEncodedSize(pending.encodedLength);
+				for(auto &next : m_pendingSampleData)
+				{
+					if(next.flags[deferMODSample] && next.offset > pending.offset)
+						next.offset -= uncompressedSize - compressedSize;
+				}
+			}
+			bytesRead += pending.sampleIO.ReadSample(sample, pending.file);
+		}
+		if(sample.HasSampleData())
+		{
+			sample.PrecomputeLoops(*this, false);
+		} else
+		{
+			// Truncated file. Voices referencing this sample simply stay silent.
+			sample.nLength = 0;
+			sample.nLoopStart = 0;
+			sample.nLoopEnd = 0;
+			sample.nSustainStart = 0;
+			sample.nSustainEnd = 0;
+			sample.uFlags.reset(CHN_LOOP | CHN_PINGPONGLOOP | CHN_SUSTAINLOOP | CHN_PINGPONGSUSTAIN);
+		}
+	}
+	return bytesRead;
+}
+
+
 bool CSoundFile::Destroy()
 {
+	m_pendingSampleData.clear();
+
 	for(auto &chn : m_PlayState.Chn)
 	{
 		chn.pModInstrument = nullptr;
@@ -693,6 +943,7 @@ bool CSoundFile::Destroy()
 	{
 		smp.FreeSample();
 	}
+	m_SamplePyramids.clear();
 	for(auto &ins : Instruments)
 	{
 		delete ins;
@@ -758,6 +1009,133 @@ double CSoundFile::GetCurrentBPM() const
 }
 
 
+CSoundFile::PlayStateSnapshot::PlayStateSnapshot(const CSoundFile &sndFile)
+	: globalState(sndFile.m_PlayState)
+	, songFlags(sndFile.m_SongFlags & SONG_PLAY_FLAGS)
+	, prng(sndFile.m_PRNG)
+	, visitedSongRows(sndFile.visitedSongRows)
+	, dryLOfsVol(sndFile.gnDryLOfsVol)
+	, dryROfsVol(sndFile.gnDryROfsVol)
+	, sequence(sndFile.Order.GetCurrentSequenceIndex())
+{
+	const PlayState &playState = sndFile.m_PlayState;
+	mixChannels.assign(std::begin(playState.ChnMix), std::begin(playState.ChnMix) + sndFile.m_nMixChannels);
+	// Background channels that are neither playing nor mixed are reset on restore, they are picked up again by GetNNAChannel without looking at any of their other state.
+	std::bitset<MAX_CHANNELS> isMixed;
+	for(auto chn : mixChannels)
+	{
+		isMixed.set(chn);
+	}
+	for(CHANNELINDEX chn = 0; chn < MAX_CHANNELS; chn++)
+	{
+		const ModChannel &channel = playState.Chn[chn];
+		if(chn < sndFile.GetNumChannels() || channel.nLength || channel.HasMIDIOutput() || isMixed[chn])
+		{
+			channels.emplace_back(chn, channel);
+		}
+	}
+#ifndef NO_PLUGINS
+	pluginParameters.resize(MAX_MIXPLUGINS);
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		IMixPlugin *plugin = sndFile.m_MixPlugins[plug].pMixPlugin;
+		if(plugin != nullptr)
+		{
+			const PlugParamIndex numParams = plugin->GetNumParameters();
+			pluginParameters[plug].resize(numParams);
+			for(PlugParamIndex param = 0; param < numParams; param++)
+			{
+				pluginParameters[plug][param] = plugin->GetParameter(param);
+			}
+		}
+	}
+#endif // NO_PLUGINS
+}
+
+
+void CSoundFile::RestorePlayState(const PlayStateSnapshot &snapshot)
+{
+	static_cast<GlobalPlayState &>(m_PlayState) = snapshot.globalState;
+	if(snapshot.sequence != Order.GetCurrentSequenceIndex())
+	{
+		Order.SetSequence(snapshot.sequence);
+	}
+
+	// Channels that were not stored in the snapshot only need to be stopped if they have become active since.
+	const auto stopChannels = [this](CHANNELINDEX first, CHANNELINDEX last)
+	{
+		for(CHANNELINDEX chn = first; chn < last; chn++)
+		{
+			ModChannel &channel = m_PlayState.Chn[chn];
+			if(channel.nLength || channel.HasMIDIOutput())
+			{
+				channel = ModChannel();
+			}
+		}
+	};
+	CHANNELINDEX chn = 0;
+	for(const auto &channel : snapshot.channels)
+	{
+		stopChannels(chn, channel.first);
+		m_PlayState.Chn[channel.first] = channel.second;
+		chn = channel.first + 1;
+	}
+	stopChannels(chn, MAX_CHANNELS);
+	std::copy(snapshot.mixChannels.begin(), snapshot.mixChannels.end(), std::begin(m_PlayState.ChnMix));
+	m_nMixChannels = static_cast<CHANNELINDEX>(snapshot.mixChannels.size());
+
+	m_SongFlags.reset(SONG_PLAY_FLAGS);
+	m_SongFlags.set(snapshot.songFlags);
+	m_PRNG = snapshot.prng;
+	visitedSongRows = snapshot.visitedSongRows;
+	gnDryLOfsVol = snapshot.dryLOfsVol;
+	gnDryROfsVol = snapshot.dryROfsVol;
+	// The stem click removal state is not part of the snapshot
+	std::fill(m_StemOfsVol.begin(), m_StemOfsVol.end(), 0);
+
+	// Like the master DSP effects, the reverb is not part of the snapshot. Start from silence instead of continuing with what was rendered after the snapshot was taken.
+#ifndef NO_REVERB
+	m_Reverb.Initialize(true, m_MixerSettings.gdwMixingFreq);
+#endif
+#ifndef NO_DSP
+	m_Surround.Initialize(true, m_MixerSettings.gdwMixingFreq);
+	m_MegaBass.Initialize(true, m_MixerSettings.gdwMixingFreq);
+	m_BitCrush.Initialize(true, m_MixerSettings.gdwMixingFreq);
+#endif
+#ifndef NO_EQ
+	m_EQ.Initialize(true, m_MixerSettings.gdwMixingFreq);
+#endif
+#ifndef NO_AGC
+	m_AGC.Initialize(true, m_MixerSettings.gdwMixingFreq);
+#endif
+
+	// The OPL emulator state cannot be copied, so OPL notes have to be triggered again, just like after seeking.
+	// This also discards emulator output that is still buffered for sample rate conversion, as it belongs to the previous position.
+	if(m_opl != nullptr)
+	{
+		m_opl->Reset();
+	}
+
+#ifndef NO_PLUGINS
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		IMixPlugin *plugin = m_MixPlugins[plug].pMixPlugin;
+		if(plugin != nullptr && plug < snapshot.pluginParameters.size())
+		{
+			const auto &params = snapshot.pluginParameters[plug];
+			const PlugParamIndex numParams = std::min(plugin->GetNumParameters(), static_cast<PlugParamIndex>(params.size()));
+			plugin->BeginSetProgram();
+			for(PlugParamIndex param = 0; param < numParams; param++)
+			{
+				plugin->SetParameter(param, params[param]);
+			}
+			plugin->EndSetProgram();
+		}
+	}
+#endif // NO_PLUGINS
+}
+
+
 void CSoundFile::ResetPlayPos()
 {
 	for(CHANNELINDEX i = 0; i < MAX_CHANNELS; i++)
@@ -1843,6 +2221,55 @@ void CSoundFile::PrecomputeSampleLoops(bool updateChannels)
 }
 
 
+const SamplePyramid *CSoundFile::GetSamplePyramid(const ModSample &sample) const
+{
+	if(&sample < std::begin(Samples) || &sample >= std::end(Samples))
+		return nullptr;
+	const std::size_t index = &sample - std::begin(Samples);
+	if(index >= m_SamplePyramids.size() || !m_SamplePyramids[index].IsValidFor(sample))
+		return nullptr;
+	return &m_SamplePyramids[index];
+}
+
+
+void CSoundFile::InvalidateSamplePyramid(const ModSample &sample)
+{
+	if(&sample < std::begin(Samples) || &sample >= std::end(Samples))
+		return;
+	const std::size_t index = &sample - std::begin(Samples);
+	if(index < m_SamplePyramids.size())
+	{
+		m_SamplePyramids[index].generation++;
+		m_SamplePyramids[index].Reset();
+	}
+	if(m_Resampler.m_Settings.samplePyramids && sample.HasSampleData())
+	{
+		if(index >= m_SamplePyramids.size())
+			m_SamplePyramids.resize(index + 1);
+		m_SamplePyramids[index].Build(sample);
+	}
+}
+
+
+void CSoundFile::UpdateSamplePyramids()
+{
+	if(!m_Resampler.m_Settings.samplePyramids)
+	{
+		m_SamplePyramids.clear();
+		m_SamplePyramids.shrink_to_fit();
+		return;
+	}
+	if(m_SamplePyramids.size() < static_cast<std::size_t>(GetNumSamples()) + 1)
+		m_SamplePyramids.resize(GetNumSamples() + 1);
+	for(SAMPLEINDEX smp = 1; smp <= GetNumSamples(); smp++)
+	{
+		const ModSample &sample = Samples[smp];
+		if(sample.HasSampleData() && !m_SamplePyramids[smp].IsValidFor(sample))
+			m_SamplePyramids[smp].Build(sample);
+	}
+}
+
+
 #ifdef MPT_EXTERNAL_SAMPLES
 // Load external waveform, but keep sample properties like frequency, panning, etc...
 // Returns true if the file could be loaded.
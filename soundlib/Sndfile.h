@@ -16,6 +16,7 @@
 #include "SoundFilePlayConfig.h"
 #include "MixerSettings.h"
 #include "../common/misc_util.h"
+#include "../common/mptAlloc.h"
 #include "../common/mptRandom.h"
 #include "../common/version.h"
 #include <vector>
@@ -48,6 +49,7 @@
 #include "ModInstrument.h"
 #include "ModChannel.h"
 #include "plugins/PluginStructs.h"
+#include "plugins/PluginGraph.h"
 #include "RowVisitor.h"
 #include "Message.h"
 #include "pattern.h"
@@ -63,6 +65,10 @@ OPENMPT_NAMESPACE_BEGIN
 bool SettingCacheCompleteFileBeforeLoading();
 
 
+class SampleIO;
+struct PendingSampleData;
+
+
 // -----------------------------------------------------------------------------
 // MODULAR ModInstrument FIELD ACCESS : body content in InstrumentExtensions.cpp
 // -----------------------------------------------------------------------------
@@ -264,6 +270,10 @@ protected:
 public:
 	virtual void DataCallback(MixSampleInt *MixSoundBuffer, std::size_t channels, std::size_t countChunk) = 0;
 	virtual void DataCallback(MixSampleFloat *MixSoundBuffer, std::size_t channels, std::size_t countChunk) = 0;
+	// Only called if stem rendering is enabled, right before DataCallback.
+	// StemMixBuffers contains one interleaved stereo buffer per pattern channel.
+	virtual void StemDataCallback(MixSampleInt * const *StemMixBuffers, std::size_t numStems, std::size_t countChunk) { MPT_UNREFERENCED_PARAMETER(StemMixBuffers); MPT_UNREFERENCED_PARAMETER(numStems); MPT_UNREFERENCED_PARAMETER(countChunk); }
+	virtual void StemDataCallback(MixSampleFloat * const *StemMixBuffers, std::size_t numStems, std::size_t countChunk) { MPT_UNREFERENCED_PARAMETER(StemMixBuffers); MPT_UNREFERENCED_PARAMETER(numStems); MPT_UNREFERENCED_PARAMETER(countChunk); }
 };
 
 
@@ -372,6 +382,14 @@ private:
 	mixsample_t gnDryLOfsVol = 0;
 	mixsample_t gnDryROfsVol = 0;
 	mixsample_t MixInputBuffer[NUMMIXINPUTBUFFERS][MIXBUFFERSIZE];
+	// Compact render state of the voices being mixed (parallel to m_PlayState.ChnMix)
+	mpt::aligned_buffer<MixVoice, 64> m_MixVoices;
+	// Per-channel stem mix buffers (MIXBUFFERSIZE * 2 samples each) and their click removal offsets, empty if stem rendering is disabled
+	std::vector<mixsample_t> m_StemMixBuffer;
+	std::vector<mixsample_t *> m_StemMixBuffers;
+	std::vector<mixsample_t> m_StemOfsVol;
+	// Sample data that has not been read yet, sorted by descending file offset
+	std::vector<PendingSampleData> m_pendingSampleData;
 
 public:
 	MixerSettings m_MixerSettings;
@@ -413,6 +431,21 @@ public:
 private:
 	CHANNELINDEX m_nMixStat;
 public:
+	// Number of voice frames rendered by each of the mixer's code paths, for profiling
+	struct MixerStatistics
+	{
+		uint64 rampFrames = 0;	// Single-voice mix functions with volume ramping
+		uint64 noRampFrames = 0;	// Single-voice mix functions without volume ramping
+		uint64 multiVoiceFrames = 0;	// Multi-voice mix functions
+	};
+	MixerStatistics m_MixerStatistics;
+	// Optimized mixer code paths, which can be switched off to compare their output with the straightforward implementation
+	struct MixerPaths
+	{
+		bool fusedMasterBus = true;	// Apply global volume, stereo separation and front/rear interleaving in a single pass if no DSP effects are enabled
+		bool deferPostRampTails = true;	// Mix the rest of the chunk after a voice's volume ramp together with other voices (integer mixer only)
+	};
+	MixerPaths m_MixerPaths;
 	ROWINDEX m_nDefaultRowsPerBeat, m_nDefaultRowsPerMeasure;	// default rows per beat and measure for this module
 	TempoMode m_nTempoMode = tempoModeClassic;
 
@@ -474,7 +507,8 @@ protected:
 	MixLevels m_nMixLevels;
 
 public:
-	struct PlayState
+	// Playback state that does not belong to any specific channel
+	struct GlobalPlayState
 	{
 		friend class CSoundFile;
 	protected:
@@ -482,6 +516,11 @@ public:
 		double m_dBufferDiff;
 	public:
 		samplecount_t m_lTotalSampleCount = 0;
+#ifndef MODPLUG_TRACKER
+		// Remaining samples of the current tick. libopenmpt scales them when it changes the mixing rate in the middle of a tick.
+		samplecount_t GetBufferCount() const { return m_nBufferCount; }
+		void SetBufferCount(samplecount_t count) { m_nBufferCount = count; }
+#endif // !MODPLUG_TRACKER
 
 	public:
 		uint32 m_nTickCount;
@@ -512,7 +551,10 @@ public:
 
 	public:
 		bool m_bPositionChanged = true; // Report to plugins that we jumped around in the module
+	};
 
+	struct PlayState : public GlobalPlayState
+	{
 	public:
 		CHANNELINDEX ChnMix[MAX_CHANNELS]; // Channels to be mixed
 		ModChannel Chn[MAX_CHANNELS];      // Mixing channels... First m_nChannels channels are master channels (i.e. they are never NNA channels)!
@@ -526,6 +568,28 @@ public:
 
 	PlayState m_PlayState;
 
+	// Copy of the playback state in which only the channels that are in use are stored, see SavePlayState and RestorePlayState.
+	// Channels reference sample and instrument data, so a snapshot can only be restored to the CSoundFile object it was taken from.
+	struct PlayStateSnapshot
+	{
+		GlobalPlayState globalState;
+		std::vector<std::pair<CHANNELINDEX, ModChannel>> channels; // All pattern channels and background channels that are still playing
+		std::vector<CHANNELINDEX> mixChannels;
+		FlagSet<SongFlags> songFlags; // Only SONG_PLAY_FLAGS
+		mpt::fast_prng prng;
+		RowVisitor visitedSongRows;
+		mixsample_t dryLOfsVol, dryROfsVol;
+		SEQUENCEINDEX sequence;
+#ifndef NO_PLUGINS
+		std::vector<std::vector<PlugParamValue>> pluginParameters;
+#endif // NO_PLUGINS
+
+		explicit PlayStateSnapshot(const CSoundFile &sndFile);
+	};
+
+	PlayStateSnapshot SavePlayState() const { return PlayStateSnapshot(*this); }
+	void RestorePlayState(const PlayStateSnapshot &snapshot);
+
 protected:
 	// For handling backwards jumps and stuff to prevent infinite loops when counting the mod length or rendering to wav.
 	RowVisitor visitedSongRows;
@@ -540,6 +604,14 @@ public:
 
 	std::unique_ptr<OPL> m_opl;
 
+	std::vector<SamplePyramid> m_SamplePyramids;	// Decimated sample data for high-pitch playback, indexed by sample number. Only kept while enabled in the resampler settings.
+
+protected:
+#ifndef NO_PLUGINS
+	PluginGraph m_PluginGraph;	// Plugin chains that are independent of each other
+	std::unique_ptr<PluginWorkerPool> m_PluginWorkers;	// Only present if independent plugin chains are processed concurrently
+#endif // NO_PLUGINS
+
 public:
 #ifdef LIBOPENMPT_BUILD
 #ifndef NO_PLUGINS
@@ -602,6 +674,8 @@ public:
 		loadPluginInstance = 0x08, // If unset, plugins are not instanciated.
 		skipContainer      = 0x10,
 		skipModules        = 0x20,
+		deferSampleData    = 0x40, // If set along with loadSampleData, loaders that support it only remember where sample data is located. It is read later by ReadPendingSampleData().
+		loadMetadataOnly   = 0x80, // If set along with loadPatternData, loaders that support it (IT, MPTM, XM, S3M, MOD) create all patterns and determine the channel count, but do not decode the pattern contents. Unlike onlyVerifyHeader, the module is fully set up.
 
 		// Shortcuts
 		loadCompleteModule = loadSampleData | loadPatternData | loadPluginData | loadPluginInstance,
@@ -617,6 +691,7 @@ public:
 	{
 		ProbeModules    = 0x1,
 		ProbeContainers = 0x2,
+		ProbeAllFormats = 0x4, // Invoke all probers instead of ruling out formats by their magic bytes first (slower, for verifying the magic bytes table)
 
 		ProbeFlagsDefault = ProbeModules | ProbeContainers,
 		ProbeFlagsNone = 0
@@ -647,6 +722,16 @@ public:
 	bool Destroy();
 	Enum<MODTYPE> GetType() const noexcept { return m_nType; }
 
+	// Progressive loading: Remember where the data of a sample is located instead of reading it right away (used by loaders if deferSampleData is set)
+	enum DeferSampleFlags
+	{
+		deferMODSample = 0x01,  // ProTracker MOD sample: It may be prefixed with "ADPCM", which is only known once its data is reached, and it keeps its length if it lies beyond the end of the file.
+	};
+	void DeferSampleData(SAMPLEINDEX smp, const SampleIO &sampleIO, const FileReader &file, uint64 offset, FlagSet<DeferSampleFlags> flags = FlagSet<DeferSampleFlags>());
+	// Read deferred sample data in file order until at least minBytes have been consumed or no sample data is pending anymore. Returns the number of bytes read.
+	std::size_t ReadPendingSampleData(std::size_t minBytes);
+	bool HasPendingSampleData() const noexcept { return !m_pendingSampleData.empty(); }
+
 	MODCONTAINERTYPE GetContainerType() const noexcept { return m_ContainerType; }
 
 	// rough heuristic, could be improved
@@ -866,6 +951,11 @@ public:
 	void ResetChannels();
 	samplecount_t Read(samplecount_t count, IAudioReadTarget &target) { AudioSourceNone source; return Read(count, target, source); }
 	samplecount_t Read(samplecount_t count, IAudioReadTarget &target, IAudioSource &source);
+	// If enabled, all voices of a pattern channel (including NNA voices) are mixed into a separate stereo stem instead of the master mix.
+	// Reverb, surround, plugins, OPL and DSP effects are not applied to stems. Plugin and OPL output, the reverb tail and
+	// voices without a pattern channel are only mixed into the master mix, which the stems read target discards.
+	void SetStemRendering(bool enable);
+	bool IsStemRendering() const { return !m_StemMixBuffers.empty(); }
 private:
 	void CreateStereoMix(int count);
 public:
@@ -873,6 +963,9 @@ public:
 private:
 	void ProcessDSP(uint32 countChunk);
 	void ProcessPlugins(uint32 nCount);
+#ifndef NO_PLUGINS
+	void ProcessPluginChain(PluginGraph::Chain &chain, const std::bitset<MAX_MIXPLUGINS> &hasPluginInput, uint32 nCount, bool positionChanged);
+#endif // NO_PLUGINS
 	void ProcessInputChannels(IAudioSource &source, std::size_t countChunk);
 public:
 	samplecount_t GetTotalSampleCount() const { return m_PlayState.m_lTotalSampleCount; }
@@ -881,10 +974,21 @@ public:
 
 	void PrecomputeSampleLoops(bool updateChannels = false);
 
+	// Get the decimated copies of a sample's data. Returns nullptr if they are not available or out of date.
+	// They are never built here, as this is called from the mixer.
+	const SamplePyramid *GetSamplePyramid(const ModSample &sample) const;
+	// Discard the decimated copies of a sample's data after it has been modified, and rebuild them if they are enabled.
+	void InvalidateSamplePyramid(const ModSample &sample);
+	// Build the decimated copies of all samples that are missing or out of date if they are enabled, or free them otherwise.
+	void UpdateSamplePyramids();
+
 public:
 	// Mixer Config
 	void SetMixerSettings(const MixerSettings &mixersettings);
 	void SetResamplerSettings(const CResamplerSettings &resamplersettings);
+	// Number of worker threads that process independent plugin chains concurrently (0 = process all plugins on the mixing thread)
+	void SetNumPluginThreads(uint32 numThreads);
+	uint32 GetNumPluginThreads() const;
 	void InitPlayer(bool bReset=false);
 	void SetDspEffects(uint32 DSPMask);
 	uint32 GetSampleRate() const { return m_MixerSettings.gdwMixingFreq; }
@@ -1120,8 +1224,11 @@ public:
 
 	void ProcessGlobalVolume(long countChunk);
 	void ProcessStereoSeparation(long countChunk);
+	void ProcessMasterBus(uint32 countChunk);
 
 private:
+	int32 UpdateGlobalVolumeRamp();
+	void ProcessStemsGlobalVolume(long countChunk, int32 step);
 	PLUGINDEX GetChannelPlugin(CHANNELINDEX nChn, PluginMutePriority respectMutes) const;
 	PLUGINDEX GetActiveInstrumentPlugin(CHANNELINDEX, PluginMutePriority respectMutes) const;
 	IMixPlugin *GetChannelInstrumentPlugin(CHANNELINDEX chn) const;
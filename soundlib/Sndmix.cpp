@@ -79,6 +79,31 @@ void CSoundFile::SetResamplerSettings(const CResamplerSettings &resamplersetting
 	m_Resampler.m_Settings = resamplersettings;
 	m_Resampler.UpdateTables();
 	InitAmigaResampler();
+	UpdateSamplePyramids();
+}
+
+
+void CSoundFile::SetNumPluginThreads(uint32 numThreads)
+{
+#ifndef NO_PLUGINS
+	if(numThreads == GetNumPluginThreads())
+		return;
+	m_PluginWorkers.reset();
+	if(numThreads > 0)
+		m_PluginWorkers = std::make_unique<PluginWorkerPool>(numThreads);
+#else
+	MPT_UNREFERENCED_PARAMETER(numThreads);
+#endif // NO_PLUGINS
+}
+
+
+uint32 CSoundFile::GetNumPluginThreads() const
+{
+#ifndef NO_PLUGINS
+	return m_PluginWorkers ? m_PluginWorkers->GetNumThreads() : 0;
+#else
+	return 0;
+#endif // NO_PLUGINS
 }
 
 
@@ -89,6 +114,7 @@ void CSoundFile::InitPlayer(bool bReset)
 		ResetMixStat();
 		gnDryLOfsVol = 0;
 		gnDryROfsVol = 0;
+		std::fill(m_StemOfsVol.begin(), m_StemOfsVol.end(), 0);
 		InitAmigaResampler();
 	}
 	m_Resampler.UpdateTables();
@@ -140,28 +166,38 @@ bool CSoundFile::FadeSong(uint32 msec)
 }
 
 
-// Apply stereo separation factor on an interleaved stereo/quad stream.
-// count = Number of stereo sample pairs to process
+// Mid/side stereo separation matrix
 // separation = -256...256 (negative values = swap L/R, 0 = mono, 128 = normal)
-static void ApplyStereoSeparation(mixsample_t *mixBuf, std::size_t count, int32 separation)
+struct StereoSeparationMatrix
 {
 #ifdef MPT_INTMIXER
-	const mixsample_t factor_num = separation; // 128 =^= 1.0f
-	const mixsample_t factor_den = MixerSettings::StereoSeparationScale; // 128
-	const mixsample_t normalize_den = 2; // mid/side pre/post normalization
-	const mixsample_t mid_den = normalize_den;
-	const mixsample_t side_num = factor_num;
-	const mixsample_t side_den = factor_den * normalize_den;
+	mixsample_t mid_den;
+	mixsample_t side_num;
+	mixsample_t side_den;
 #else
-	const float normalize_factor = 0.5f; // cumulative mid/side normalization factor (1/sqrt(2))*(1/sqrt(2))
-	const float factor = static_cast<float>(separation) / static_cast<float>(MixerSettings::StereoSeparationScale); // sep / 128
-	const float mid_factor = normalize_factor;
-	const float side_factor = factor * normalize_factor;
+	float mid_factor;
+	float side_factor;
 #endif
-	for(std::size_t i = 0; i < count; i++)
+
+	explicit StereoSeparationMatrix(int32 separation)
+	{
+#ifdef MPT_INTMIXER
+		const mixsample_t factor_num = separation; // 128 =^= 1.0f
+		const mixsample_t factor_den = MixerSettings::StereoSeparationScale; // 128
+		const mixsample_t normalize_den = 2; // mid/side pre/post normalization
+		mid_den = normalize_den;
+		side_num = factor_num;
+		side_den = factor_den * normalize_den;
+#else
+		const float normalize_factor = 0.5f; // cumulative mid/side normalization factor (1/sqrt(2))*(1/sqrt(2))
+		const float factor = static_cast<float>(separation) / static_cast<float>(MixerSettings::StereoSeparationScale); // sep / 128
+		mid_factor = normalize_factor;
+		side_factor = factor * normalize_factor;
+#endif
+	}
+
+	MPT_FORCEINLINE void operator()(mixsample_t &l, mixsample_t &r) const
 	{
-		mixsample_t l = mixBuf[0];
-		mixsample_t r = mixBuf[1];
 		mixsample_t m = l + r;
 		mixsample_t s = l - r;
 #ifdef MPT_INTMIXER
@@ -173,8 +209,19 @@ static void ApplyStereoSeparation(mixsample_t *mixBuf, std::size_t count, int32
 #endif
 		l = m + s;
 		r = m - s;
-		mixBuf[0] = l;
-		mixBuf[1] = r;
+	}
+};
+
+
+// Apply stereo separation factor on an interleaved stereo/quad stream.
+// count = Number of stereo sample pairs to process
+// separation = -256...256 (negative values = swap L/R, 0 = mono, 128 = normal)
+static void ApplyStereoSeparation(mixsample_t *mixBuf, std::size_t count, int32 separation)
+{
+	const StereoSeparationMatrix matrix(separation);
+	for(std::size_t i = 0; i < count; i++)
+	{
+		matrix(mixBuf[0], mixBuf[1]);
 		mixBuf += 2;
 	}
 }
@@ -316,29 +363,37 @@ CSoundFile::samplecount_t CSoundFile::Read(samplecount_t count, IAudioReadTarget
 			ProcessPlugins(countChunk);
 		}
 
-		if(m_MixerSettings.gnChannels == 1)
+		if(!m_MixerSettings.DSPMask && m_MixerPaths.fusedMasterBus)
 		{
-			MonoFromStereo(MixSoundBuffer, countChunk);
-		}
-
-		if(m_PlayConfig.getGlobalVolumeAppliesToMaster())
+			ProcessMasterBus(countChunk);
+		} else
 		{
-			ProcessGlobalVolume(countChunk);
-		}
+			if(m_MixerSettings.gnChannels == 1)
+			{
+				MonoFromStereo(MixSoundBuffer, countChunk);
+			}
 
-		if(m_MixerSettings.m_nStereoSeparation != MixerSettings::StereoSeparationScale)
-		{
-			ProcessStereoSeparation(countChunk);
-		}
+			if(m_PlayConfig.getGlobalVolumeAppliesToMaster())
+			{
+				ProcessGlobalVolume(countChunk);
+			}
+
+			if(m_MixerSettings.m_nStereoSeparation != MixerSettings::StereoSeparationScale)
+			{
+				ProcessStereoSeparation(countChunk);
+			}
 
-		if(m_MixerSettings.DSPMask)
-		{
 			ProcessDSP(countChunk);
+
+			if(m_MixerSettings.gnChannels == 4)
+			{
+				InterleaveFrontRear(MixSoundBuffer, MixRearBuffer, countChunk);
+			}
 		}
 
-		if(m_MixerSettings.gnChannels == 4)
+		if(!m_StemMixBuffers.empty())
 		{
-			InterleaveFrontRear(MixSoundBuffer, MixRearBuffer, countChunk);
+			target.StemDataCallback(m_StemMixBuffers.data(), m_StemMixBuffers.size(), countChunk);
 		}
 
 		target.DataCallback(MixSoundBuffer, m_MixerSettings.gnChannels, countChunk);
@@ -2628,9 +2683,74 @@ MPT_FORCEINLINE void ApplyGlobalVolumeWithRamping(int32 *SoundBuffer, int32 *Rea
 }
 
 
-void CSoundFile::ProcessGlobalVolume(long lCount)
+// Single pass equivalent of ApplyGlobalVolumeWithRamping, ApplyStereoSeparation and InterleaveFrontRear.
+// A mono mix must already have been downmixed with MonoFromStereo. The ramped global volume of each frame is computed directly from its position, so that frames can be processed in any order.
+template<int channels, bool applySeparation>
+static void ApplyMasterBus(mixsample_t *SoundBuffer, const mixsample_t *RearBuffer, uint32 count, int32 globalVolume, int32 step, int32 &samplesToGlobalVolRampDest, int32 &highResRampingGlobalVolume, const StereoSeparationMatrix &separation)
 {
+	using GlobalVolumeScale = std::integral_constant<int32, MAX_GLOBAL_VOLUME>;
+	using RampedGlobalVolumeScale = std::integral_constant<int32, (MAX_GLOBAL_VOLUME << VOLUMERAMPPRECISION)>;
+	const uint32 rampFrames = std::min(count, static_cast<uint32>(std::max(samplesToGlobalVolRampDest, int32(0))));
+	const int32 rampStart = highResRampingGlobalVolume;
+
+	// volumeScale is passed as an integral constant, so that the divisions in muldiv are not done at runtime
+	const auto processFrame = [&](uint32 i, int32 volume, auto volumeScale)
+	{
+		MPT_CONSTANT_IF(channels == 1)
+		{
+			SoundBuffer[i] = Util::muldiv(SoundBuffer[i], volume, volumeScale);
+			return;
+		}
+		mixsample_t l = Util::muldiv(SoundBuffer[i * 2], volume, volumeScale);
+		mixsample_t r = Util::muldiv(SoundBuffer[i * 2 + 1], volume, volumeScale);
+		MPT_CONSTANT_IF(applySeparation) separation(l, r);
+		MPT_CONSTANT_IF(channels == 4)
+		{
+			mixsample_t rl = Util::muldiv(RearBuffer[i * 2], volume, volumeScale);
+			mixsample_t rr = Util::muldiv(RearBuffer[i * 2 + 1], volume, volumeScale);
+			MPT_CONSTANT_IF(applySeparation) separation(rl, rr);
+			SoundBuffer[i * 4 + 0] = l;
+			SoundBuffer[i * 4 + 1] = r;
+			SoundBuffer[i * 4 + 2] = rl;
+			SoundBuffer[i * 4 + 3] = rr;
+		} else
+		{
+			SoundBuffer[i * 2 + 0] = l;
+			SoundBuffer[i * 2 + 1] = r;
+		}
+	};
+
+	MPT_CONSTANT_IF(channels == 4)
+	{
+		// Process backwards as the interleaved output is written back into the front buffer
+		for(uint32 i = count; i-- > rampFrames; )
+			processFrame(i, globalVolume, GlobalVolumeScale());
+		for(uint32 i = rampFrames; i-- > 0; )
+			processFrame(i, rampStart + step * static_cast<int32>(i + 1), RampedGlobalVolumeScale());
+	} else
+	{
+		for(uint32 i = 0; i < rampFrames; i++)
+			processFrame(i, rampStart + step * static_cast<int32>(i + 1), RampedGlobalVolumeScale());
+		// Unity gain on a mono or stereo mix without separation leaves the samples unchanged
+		const bool isIdentity = (channels <= 2 && !applySeparation && globalVolume == static_cast<int32>(MAX_GLOBAL_VOLUME));
+		if(!isIdentity)
+		{
+			for(uint32 i = rampFrames; i < count; i++)
+				processFrame(i, globalVolume, GlobalVolumeScale());
+		}
+	}
+
+	samplesToGlobalVolRampDest -= rampFrames;
+	if(rampFrames < count)
+		highResRampingGlobalVolume = globalVolume << VOLUMERAMPPRECISION;
+	else
+		highResRampingGlobalVolume = rampStart + step * static_cast<int32>(rampFrames);
+}
+
 
+// Updates the global volume ramping destination and returns the ramping step for the next chunk.
+int32 CSoundFile::UpdateGlobalVolumeRamp()
+{
 	// should we ramp?
 	if(IsGlobalVolumeUnset())
 	{
@@ -2675,6 +2795,27 @@ void CSoundFile::ProcessGlobalVolume(long lCount)
 			}
 		}
 	}
+	return step;
+}
+
+
+// Stems are processed with their own copy of the ramping state, so that all of them ramp in sync with the master mix
+void CSoundFile::ProcessStemsGlobalVolume(long lCount, int32 step)
+{
+	for(auto stemBuffer : m_StemMixBuffers)
+	{
+		int32 samplesToGlobalVolRampDest = m_PlayState.m_nSamplesToGlobalVolRampDest;
+		int32 highResRampingGlobalVolume = m_PlayState.m_lHighResRampingGlobalVolume;
+		ApplyGlobalVolumeWithRamping<2>(stemBuffer, nullptr, lCount, m_PlayState.m_nGlobalVolume, step, samplesToGlobalVolRampDest, highResRampingGlobalVolume);
+	}
+}
+
+
+void CSoundFile::ProcessGlobalVolume(long lCount)
+{
+	const int32 step = UpdateGlobalVolumeRamp();
+
+	ProcessStemsGlobalVolume(lCount, step);
 
 	// apply volume and ramping
 	if(m_MixerSettings.gnChannels == 1)
@@ -2694,7 +2835,60 @@ void CSoundFile::ProcessGlobalVolume(long lCount)
 void CSoundFile::ProcessStereoSeparation(long countChunk)
 {
 	ApplyStereoSeparation(MixSoundBuffer, MixRearBuffer, m_MixerSettings.gnChannels, countChunk, m_MixerSettings.m_nStereoSeparation);
+	for(auto stemBuffer : m_StemMixBuffers)
+	{
+		ApplyStereoSeparation(stemBuffer, countChunk, m_MixerSettings.m_nStereoSeparation);
+	}
 }
 
 
+
+// Applies mono downmix, global volume, stereo separation and front/rear interleaving to the master mix in a single pass (two for mono output).
+// Only valid if no DSP effects have to be applied between these steps.
+void CSoundFile::ProcessMasterBus(uint32 countChunk)
+{
+	const bool applySeparation = m_MixerSettings.m_nStereoSeparation != MixerSettings::StereoSeparationScale;
+	const StereoSeparationMatrix separation(m_MixerSettings.m_nStereoSeparation);
+
+	// Without global volume on the master bus, unity gain is applied, which leaves the samples unchanged
+	int32 globalVolume = MAX_GLOBAL_VOLUME, step = 0, samplesToGlobalVolRampDest = 0, highResRampingGlobalVolume = MAX_GLOBAL_VOLUME << VOLUMERAMPPRECISION;
+	int32 *pSamplesToGlobalVolRampDest = &samplesToGlobalVolRampDest, *pHighResRampingGlobalVolume = &highResRampingGlobalVolume;
+	if(m_PlayConfig.getGlobalVolumeAppliesToMaster())
+	{
+		step = UpdateGlobalVolumeRamp();
+		ProcessStemsGlobalVolume(countChunk, step);
+		globalVolume = m_PlayState.m_nGlobalVolume;
+		pSamplesToGlobalVolRampDest = &m_PlayState.m_nSamplesToGlobalVolRampDest;
+		pHighResRampingGlobalVolume = &m_PlayState.m_lHighResRampingGlobalVolume;
+	}
+	if(applySeparation)
+	{
+		for(auto stemBuffer : m_StemMixBuffers)
+		{
+			ApplyStereoSeparation(stemBuffer, countChunk, m_MixerSettings.m_nStereoSeparation);
+		}
+	}
+
+	switch(m_MixerSettings.gnChannels)
+	{
+	case 1:
+		// Use the same downmix as the unfused path, its rounding differs between the integer mixer implementations
+		MonoFromStereo(MixSoundBuffer, countChunk);
+		ApplyMasterBus<1, false>(MixSoundBuffer, MixRearBuffer, countChunk, globalVolume, step, *pSamplesToGlobalVolRampDest, *pHighResRampingGlobalVolume, separation);
+		break;
+	case 2:
+		if(applySeparation)
+			ApplyMasterBus<2, true>(MixSoundBuffer, MixRearBuffer, countChunk, globalVolume, step, *pSamplesToGlobalVolRampDest, *pHighResRampingGlobalVolume, separation);
+		else
+			ApplyMasterBus<2, false>(MixSoundBuffer, MixRearBuffer, countChunk, globalVolume, step, *pSamplesToGlobalVolRampDest, *pHighResRampingGlobalVolume, separation);
+		break;
+	case 4:
+		if(applySeparation)
+			ApplyMasterBus<4, true>(MixSoundBuffer, MixRearBuffer, countChunk, globalVolume, step, *pSamplesToGlobalVolRampDest, *pHighResRampingGlobalVolume, separation);
+		else
+			ApplyMasterBus<4, false>(MixSoundBuffer, MixRearBuffer, countChunk, globalVolume, step, *pSamplesToGlobalVolRampDest, *pHighResRampingGlobalVolume, separation);
+		break;
+	}
+}
+
 OPENMPT_NAMESPACE_END
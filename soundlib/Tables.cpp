@@ -15,6 +15,7 @@
 
 #include "Resampler.h"
 #include "WindowedFIR.h"
+#include "ResamplerTables.h"
 #include <cmath>
 
 
@@ -752,15 +753,21 @@ static void getsinc(SINC_TYPE *psinc, double beta, double lowpass_factor)
 }
 
 
-#ifdef MODPLUG_TRACKER
+void CResampler::ComputeSincTables(SINC_TYPE *kaiserSinc, SINC_TYPE *downsample13x, SINC_TYPE *downsample2x)
+{
+	getsinc(kaiserSinc, 9.6377, 0.97);
+	getsinc(downsample13x, 8.5, 0.5);
+	getsinc(downsample2x, 2.7625, 0.425);
+}
+
+
+#if defined(MODPLUG_TRACKER) && !defined(MPT_INTMIXER)
 bool CResampler::StaticTablesInitialized = false;
 SINC_TYPE CResampler::gKaiserSinc[SINC_PHASES*8];     // Upsampling
 SINC_TYPE CResampler::gDownsample13x[SINC_PHASES*8];	// Downsample 1.333x
 SINC_TYPE CResampler::gDownsample2x[SINC_PHASES*8];		// Downsample 2x
-#ifndef MPT_INTMIXER
 mixsample_t CResampler::FastSincTablef[256 * 4];		// Cubic spline LUT
-#endif // !defined(MPT_INTMIXER)
-#endif // MODPLUG_TRACKER
+#endif // MODPLUG_TRACKER && !MPT_INTMIXER
 
 
 void CResampler::InitFloatmixerTables()
@@ -784,6 +791,7 @@ void CResampler::InitFloatmixerTables()
 void CResampler::InitializeTablesFromScratch(bool force)
 {
 
+#ifndef MPT_INTMIXER
 	bool initParameterIndependentTables = false;
 	if(force)
 	{
@@ -800,14 +808,13 @@ void CResampler::InitializeTablesFromScratch(bool force)
 	{
 		InitFloatmixerTables();
 
-		getsinc(gKaiserSinc, 9.6377, 0.97);
-		getsinc(gDownsample13x, 8.5, 0.5);
-		getsinc(gDownsample2x, 2.7625, 0.425);
+		ComputeSincTables(gKaiserSinc, gDownsample13x, gDownsample2x);
 
 		#ifdef MODPLUG_TRACKER
 			StaticTablesInitialized = true;
 		#endif // MODPLUG_TRACKER
 	}
+#endif // !MPT_INTMIXER
 
 	if((m_OldSettings == m_Settings) && !force)
 	{
@@ -837,7 +844,7 @@ void CResampler::InitializeTablesFromCache()
 	std::copy(s_CachedResampler.gKaiserSinc, s_CachedResampler.gKaiserSinc + SINC_PHASES*8, gKaiserSinc);
 	std::copy(s_CachedResampler.gDownsample13x, s_CachedResampler.gDownsample13x + SINC_PHASES*8, gDownsample13x);
 	std::copy(s_CachedResampler.gDownsample2x, s_CachedResampler.gDownsample2x + SINC_PHASES*8, gDownsample2x);
-	std::copy(s_CachedResampler.m_WindowedFIR.lut, s_CachedResampler.m_WindowedFIR.lut + WFIR_LUTLEN*WFIR_WIDTH, m_WindowedFIR.lut);
+	m_WindowedFIR = s_CachedResampler.m_WindowedFIR;
 }
 
 #endif // MPT_RESAMPLER_TABLES_CACHED
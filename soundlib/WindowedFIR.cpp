@@ -10,6 +10,7 @@
 
 
 #include "stdafx.h"
+#include "Resampler.h"
 #include "WindowedFIR.h"
 #include <math.h>
 
@@ -70,7 +71,7 @@ double CWindowedFIR::coef( int _PCnr, double _POfs, double _PCut, int _PWidth, i
 	return (_LWc*_LSi);
 }
 
-void CWindowedFIR::InitTable(double WFIRCutoff, uint8 WFIRType)
+void CWindowedFIR::ComputeTable(WFIR_TYPE *lut, double WFIRCutoff, uint8 WFIRType)
 {
 	int _LPcl;
 	double _LPcllen	= (double)(1L<<WFIR_FRACBITS);	// number of precalculated lines for 0..1 (-1..0)
@@ -99,4 +100,19 @@ void CWindowedFIR::InitTable(double WFIRCutoff, uint8 WFIRType)
 }
 
 
+void CWindowedFIR::InitTable(double WFIRCutoff, uint8 WFIRType)
+{
+#ifdef MPT_INTMIXER
+	const CResamplerSettings defaultSettings;
+	if(WFIRCutoff == defaultSettings.gdWFIRCutoff && WFIRType == defaultSettings.gbWFIRType)
+	{
+		lutCustom.clear();
+		return;
+	}
+#endif // MPT_INTMIXER
+	lutCustom.resize(WFIR_LUTLEN * WFIR_WIDTH);
+	ComputeTable(lutCustom.data(), WFIRCutoff, WFIRType);
+}
+
+
 OPENMPT_NAMESPACE_END
@@ -15,6 +15,8 @@
 
 #include "Mixer.h"
 
+#include <vector>
+
 OPENMPT_NAMESPACE_BEGIN
 
 /*
@@ -75,10 +77,22 @@ enum WFIRType
 class CWindowedFIR
 {
 private:	
-	double coef(int,double,double,int,int);
+	static double coef(int,double,double,int,int);
+#ifdef MPT_INTMIXER
+	static const WFIR_TYPE lutDefault[WFIR_LUTLEN*WFIR_WIDTH];	// Pre-computed for the default cutoff and window type, see ResamplerTables.h
+#endif // MPT_INTMIXER
+	std::vector<WFIR_TYPE> lutCustom;	// Computed at runtime for any other settings
 public:
+	static void ComputeTable(WFIR_TYPE *lut, double WFIRCutoff, uint8 WFIRType);
 	void InitTable(double WFIRCutoff, uint8 WFIRType);
-	WFIR_TYPE lut[WFIR_LUTLEN*WFIR_WIDTH];
+	const WFIR_TYPE *GetLUT() const noexcept
+	{
+#ifdef MPT_INTMIXER
+		if(lutCustom.empty())
+			return lutDefault;
+#endif // MPT_INTMIXER
+		return lutCustom.data();
+	}
 };
 
 OPENMPT_NAMESPACE_END
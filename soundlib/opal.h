@@ -1,6 +1,7 @@
 // This is the Opal OPL3 emulator from Reality Adlib Tracker v2.0a (http://www.3eality.com/productions/reality-adlib-tracker).
 // It was released by Shayde/Reality into the public domain.
 // Minor modifications to silence some warnings and fix a bug in the envelope generator have been applied.
+// A function for generating blocks of samples at the native sample rate has been added.
 
 /*
 
@@ -20,6 +21,7 @@
 
 
 
+#include <cstddef>
 #include <cstdint>
 
 
@@ -173,6 +175,7 @@ class Opal {
         void                SetSampleRate(int sample_rate);
         void                Port(uint16_t reg_num, uint8_t val);
         void                Sample(int16_t *left, int16_t *right);
+        void                SampleNative(int16_t *buffer, size_t frames);
 
     protected:
         void                Init(int sample_rate);
@@ -566,6 +569,20 @@ void Opal::Sample(int16_t *left, int16_t *right) {
 
 
 
+//==================================================================================================
+// Generate a block of samples at the OPL3 sample rate, bypassing the sample rate conversion of
+// Sample().  The samples are written to the buffer as interleaved left/right pairs.
+//==================================================================================================
+void Opal::SampleNative(int16_t *buffer, size_t frames) {
+
+    while (frames--) {
+        Output(buffer[0], buffer[1]);
+        buffer += 2;
+    }
+}
+
+
+
 //==================================================================================================
 // Produce final output from the chip.  This is at the OPL3 sample-rate.
 //==================================================================================================
@@ -25,6 +25,7 @@ IMixPlugin* DigiBoosterEcho::Create(VSTPluginLib &factory, CSoundFile &sndFile,
 DigiBoosterEcho::DigiBoosterEcho(VSTPluginLib &factory, CSoundFile &sndFile, SNDMIXPLUGIN *mixStruct)
 	: IMixPlugin(factory, sndFile, mixStruct)
 	, m_bufferSize(0)
+	, m_bufferMask(0)
 	, m_writePos(0)
 	, m_sampleRate(sndFile.GetSampleRate())
 	, m_chunk(PluginChunk::Default())
@@ -40,12 +41,12 @@ void DigiBoosterEcho::Process(float *pOutL, float *pOutR, uint32 numFrames)
 		return;
 	const float *srcL = m_mixBuffer.GetInputBuffer(0), *srcR = m_mixBuffer.GetInputBuffer(1);
 	float *outL = m_mixBuffer.GetOutputBuffer(0), *outR = m_mixBuffer.GetOutputBuffer(1);
+	// A delay time of 0 reads the oldest sample in the delay line
+	const uint32 delayTime = m_delayTime ? m_delayTime : m_bufferSize;
 
 	for(uint32 i = numFrames; i != 0; i--)
 	{
-		int readPos = m_writePos - m_delayTime;
-		if(readPos < 0)
-			readPos += m_bufferSize;
+		const uint32 readPos = (m_writePos - delayTime) & m_bufferMask;
 
 		float l = *srcL++, r = *srcR++;
 		float lDelay = m_delayLine[readPos * 2], rDelay = m_delayLine[readPos * 2 + 1];
@@ -69,9 +70,7 @@ void DigiBoosterEcho::Process(float *pOutL, float *pOutR, uint32 numFrames)
 
 		m_delayLine[m_writePos * 2] = al;
 		m_delayLine[m_writePos * 2 + 1] = ar;
-		m_writePos++;
-		if(m_writePos == m_bufferSize)
-			m_writePos = 0;
+		m_writePos = (m_writePos + 1) & m_bufferMask;
 
 		// Output samples now
 		*outL++ = (l * m_NMix + lDelay * m_PMix);
@@ -110,6 +109,16 @@ void DigiBoosterEcho::RestoreAllParameters(int32 program)
 }
 
 
+uint32 DigiBoosterEcho::GetTailSize() const
+{
+	if(!m_bufferSize)
+		return InfiniteTail;
+	// A delay time of 0 reads the oldest sample in the delay line
+	const uint32 delayTime = m_delayTime ? m_delayTime : m_bufferSize;
+	return GetDecayTailSize(delayTime, delayTime, m_chunk.param[kEchoFeedback] / 256.0);
+}
+
+
 PlugParamValue DigiBoosterEcho::GetParameter(PlugParamIndex index)
 {
 	if(index < kEchoNumParameters)
@@ -142,9 +151,10 @@ void DigiBoosterEcho::Resume()
 void DigiBoosterEcho::PositionChanged()
 {
 	m_bufferSize = (m_sampleRate >> 1) + (m_sampleRate >> 6);
+	m_bufferMask = mpt::ceil2(m_bufferSize) - 1;
 	try
 	{
-		m_delayLine.assign(m_bufferSize * 2, 0);
+		m_delayLine.assign((m_bufferMask + 1) * 2, 0);
 	} MPT_EXCEPTION_CATCH_OUT_OF_MEMORY(e)
 	{
 		MPT_EXCEPTION_DELETE_OUT_OF_MEMORY(e);
@@ -52,6 +52,7 @@ public:
 protected:
 	std::vector<float> m_delayLine;	// Echo delay line
 	uint32 m_bufferSize;			// Delay line length in frames
+	uint32 m_bufferMask;			// Delay line storage is rounded up to a power of two
 	uint32 m_writePos;				// Current write position in the delay line
 	uint32 m_delayTime;				// In frames
 	uint32 m_sampleRate;
@@ -75,6 +76,7 @@ public:
 	int32 GetVersion() const override { return 0; }
 	void Idle() override { }
 	uint32 GetLatency() const override { return 0; }
+	uint32 GetTailSize() const override;
 
 	void Process(float *pOutL, float *pOutR, uint32 numFrames) override;
 
@@ -95,6 +97,7 @@ public:
 	bool IsInstrument() const override { return false; }
 	bool CanRecieveMidiEvents() override { return false; }
 	bool ShouldProcessSilence() override { return true; }
+	bool CanProcessConcurrently() const override { return true; }
 
 #ifdef MODPLUG_TRACKER
 	CString GetDefaultEffectName() override { return _T("Echo"); }
@@ -206,6 +206,18 @@ double IMixPlugin::GetOutputLatency() const
 }
 
 
+uint32 IMixPlugin::GetDecayTailSize(double initialDelay, double periodLength, double gainPerPeriod)
+{
+	gainPerPeriod = std::abs(gainPerPeriod);
+	if(gainPerPeriod >= 1.0)
+		return InfiniteTail;
+	double tailSize = initialDelay;
+	if(gainPerPeriod > 0.0)
+		tailSize += periodLength * std::log(1e-6) / std::log(gainPerPeriod);
+	return std::min(mpt::saturate_cast<uint32>(std::ceil(tailSize)), InfiniteTail - 1);
+}
+
+
 void IMixPlugin::ProcessMixOps(float * MPT_RESTRICT pOutL, float * MPT_RESTRICT pOutR, float * MPT_RESTRICT leftPlugOutput, float * MPT_RESTRICT rightPlugOutput, uint32 numFrames)
 {
 /*	float *leftPlugOutput;
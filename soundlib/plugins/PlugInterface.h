@@ -108,6 +108,10 @@ public:
 	// Returns the next instance of the same plugin
 	inline IMixPlugin *GetNextInstance() const { return m_pNext; }
 
+	// Number of samples until a signal that first appears after initialDelay samples and is then
+	// attenuated by gainPerPeriod every periodLength samples has decayed to silence (-120 dB)
+	static uint32 GetDecayTailSize(double initialDelay, double periodLength, double gainPerPeriod);
+
 	void SetDryRatio(uint32 param);
 	bool IsBypassed() const;
 	void RecalculateGain();
@@ -121,6 +125,11 @@ public:
 	virtual void Idle() = 0;
 	// Plugin latency in samples
 	virtual uint32 GetLatency() const = 0;
+	// Plugin tail in samples, i.e. how long the output can remain audible after the input has become silent.
+	// The plugin is suspended once its input has been silent for that long and its output is silent, even if auto-suspend is disabled.
+	// Plugins with time-dependent state (e.g. LFOs) must return InfiniteTail so that they are never suspended early.
+	static constexpr uint32 InfiniteTail = uint32_max;
+	virtual uint32 GetTailSize() const { return InfiniteTail; }
 
 	virtual int32 GetNumPrograms() const = 0;
 	virtual int32 GetCurrentProgram() = 0;
@@ -165,6 +174,9 @@ public:
 	// If false is returned, mixing this plugin can be skipped if its input are currently completely silent.
 	virtual bool ShouldProcessSilence() = 0;
 	virtual void ResetSilence() { m_MixState.ResetSilence(); }
+	// Return true if Process() only touches this plugin's own state and buffers (and reads the CSoundFile),
+	// so that it can run on a worker thread while unrelated plugins are processed.
+	virtual bool CanProcessConcurrently() const { return false; }
 
 	size_t GetOutputPlugList(std::vector<IMixPlugin *> &list);
 	size_t GetInputPlugList(std::vector<IMixPlugin *> &list);
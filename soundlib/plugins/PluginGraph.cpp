@@ -0,0 +1,205 @@
+/*
+ * PluginGraph.cpp
+ * ---------------
+ * Purpose: Routing analysis of the mix plugin slots, for processing independent plugin chains on worker threads.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+
+#ifndef NO_PLUGINS
+#include "PluginGraph.h"
+#include "PlugInterface.h"
+#include "../Mixer.h"
+#include <system_error>
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+PluginGraph::PluginGraph()
+{
+	m_chainIndex.fill(PLUGINDEX_INVALID);
+}
+
+
+// Plugin that receives the output of the given plugin, or PLUGINDEX_INVALID if it writes to the master mix (see CSoundFile::ProcessPlugins)
+static PLUGINDEX GetOutputSlot(const SNDMIXPLUGIN (&plugins)[MAX_MIXPLUGINS], PLUGINDEX plug)
+{
+	const PLUGINDEX output = plugins[plug].GetOutputPlugin();
+	if(plugins[plug].IsOutputToMaster() || output <= plug || output >= MAX_MIXPLUGINS || plugins[output].pMixPlugin == nullptr)
+		return PLUGINDEX_INVALID;
+	return output;
+}
+
+
+void PluginGraph::Update(const SNDMIXPLUGIN (&plugins)[MAX_MIXPLUGINS])
+{
+	bool changed = false;
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		const SNDMIXPLUGIN &plugin = plugins[plug];
+		SlotKey key;
+		key.plugin = plugin.pMixPlugin;
+		if(key.plugin != nullptr)
+		{
+			key.pluginId1 = plugin.Info.dwPluginId1;
+			key.pluginId2 = plugin.Info.dwPluginId2;
+			key.outputRouting = plugin.Info.dwOutputRouting;
+			key.routingFlags = plugin.Info.routingFlags & (SNDMIXPLUGININFO::irApplyToMaster | SNDMIXPLUGININFO::irAutoSuspend);
+			key.mixMode = plugin.GetMixMode();
+			key.active = plugin.pMixPlugin->m_MixState.pMixBuffer != nullptr && plugin.pMixPlugin->m_mixBuffer.Ok();
+			const PLUGINDEX output = GetOutputSlot(plugins, plug);
+			key.outputActive = output != PLUGINDEX_INVALID && plugins[output].pMixPlugin->m_mixBuffer.Ok();
+		}
+		if(key != m_key[plug])
+		{
+			m_key[plug] = key;
+			changed = true;
+		}
+	}
+	if(changed)
+	{
+		Rebuild(plugins);
+	}
+}
+
+
+void PluginGraph::Rebuild(const SNDMIXPLUGIN (&plugins)[MAX_MIXPLUGINS])
+{
+	m_chains.clear();
+	m_chainIndex.fill(PLUGINDEX_INVALID);
+
+	// Outputs always go to later slots, so walking backwards visits the last plugin of each tree before the plugins feeding it.
+	std::array<PLUGINDEX, MAX_MIXPLUGINS> lastPlugin;
+	std::array<bool, MAX_MIXPLUGINS> independent;
+	lastPlugin.fill(PLUGINDEX_INVALID);
+	independent.fill(false);
+	for(PLUGINDEX plug = MAX_MIXPLUGINS; plug-- > 0; )
+	{
+		const SNDMIXPLUGIN &plugin = plugins[plug];
+		if(plugin.pMixPlugin == nullptr)
+			continue;
+		const bool canRun = m_key[plug].active && !plugin.IsMasterEffect() && plugin.pMixPlugin->CanProcessConcurrently();
+		const PLUGINDEX output = GetOutputSlot(plugins, plug);
+		if(output == PLUGINDEX_INVALID)
+		{
+			// Last plugin of a tree. It must only add to the master mix (the "middle subtract" mix mode reads it),
+			// and auto-suspension of plugins with an infinite tail looks at the master mix, too.
+			lastPlugin[plug] = plug;
+			independent[plug] = canRun && plugin.GetMixMode() != 4 && !plugin.IsAutoSuspendable();
+		} else
+		{
+			// A plugin writing into an inactive plugin's input buffer would not be processed as part of a chain
+			lastPlugin[plug] = lastPlugin[output];
+			if(!canRun || !m_key[plug].outputActive || !m_key[output].active)
+				independent[lastPlugin[plug]] = false;
+		}
+	}
+
+	// Collect the chains in slot order
+	std::array<PLUGINDEX, MAX_MIXPLUGINS> chainOfTree;
+	chainOfTree.fill(PLUGINDEX_INVALID);
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		if(lastPlugin[plug] == plug && independent[plug])
+		{
+			chainOfTree[plug] = static_cast<PLUGINDEX>(m_chains.size());
+			m_chains.emplace_back();
+		}
+	}
+	for(PLUGINDEX plug = 0; plug < MAX_MIXPLUGINS; plug++)
+	{
+		if(lastPlugin[plug] == PLUGINDEX_INVALID || chainOfTree[lastPlugin[plug]] == PLUGINDEX_INVALID)
+			continue;
+		m_chainIndex[plug] = chainOfTree[lastPlugin[plug]];
+		m_chains[m_chainIndex[plug]].plugins.push_back(plug);
+	}
+
+	if(m_chains.size() < 2)
+	{
+		m_chains.clear();
+		m_chainIndex.fill(PLUGINDEX_INVALID);
+	}
+	for(auto &chain : m_chains)
+	{
+		chain.output.assign(MIXBUFFERSIZE * 2, 0.0f);
+	}
+}
+
+
+PluginWorkerPool::PluginWorkerPool(uint32 numThreads)
+{
+	try
+	{
+		for(uint32 i = 0; i < numThreads; i++)
+		{
+			m_threads.emplace_back(&PluginWorkerPool::WorkerThread, this);
+		}
+	} catch(const std::system_error &)
+	{
+		// Work with the threads that could be started. Without any, Run() processes all jobs on the calling thread.
+	}
+}
+
+
+PluginWorkerPool::~PluginWorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_workAvailable.notify_all();
+	for(auto &thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+
+void PluginWorkerPool::Run(uint32 numJobs, const std::function<void(uint32)> &job)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_job = &job;
+	m_numJobs = numJobs;
+	m_nextJob = 0;
+	m_jobsDone = 0;
+	m_workAvailable.notify_all();
+	while(m_nextJob < m_numJobs)
+	{
+		const uint32 index = m_nextJob++;
+		lock.unlock();
+		job(index);
+		lock.lock();
+		m_jobsDone++;
+	}
+	m_workDone.wait(lock, [this] { return m_jobsDone == m_numJobs; });
+	m_job = nullptr;
+	m_numJobs = 0;
+	m_nextJob = 0;
+}
+
+
+void PluginWorkerPool::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(true)
+	{
+		m_workAvailable.wait(lock, [this] { return m_shutdown || m_nextJob < m_numJobs; });
+		if(m_shutdown)
+			return;
+		const uint32 index = m_nextJob++;
+		lock.unlock();
+		(*m_job)(index);
+		lock.lock();
+		if(++m_jobsDone == m_numJobs)
+			m_workDone.notify_all();
+	}
+}
+
+
+OPENMPT_NAMESPACE_END
+
+#endif // NO_PLUGINS
@@ -0,0 +1,115 @@
+/*
+ * PluginGraph.h
+ * -------------
+ * Purpose: Routing analysis of the mix plugin slots, for processing independent plugin chains on worker threads.
+ * Notes  : (currently none)
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#pragma once
+
+#include "BuildSettings.h"
+
+#include "PluginStructs.h"
+
+#ifndef NO_PLUGINS
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif // NO_PLUGINS
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+#ifndef NO_PLUGINS
+
+// Every plugin has at most one output, which is always a plugin in a later slot, so the output routing forms a forest.
+// Each tree ends in a plugin that writes to the master mix. A tree (chain) can be processed independently of all other
+// plugins if it contains no master effects and only plugins that can process concurrently, and if its last plugin adds
+// its output to the master mix without looking at it. The last plugin then writes into a private buffer, which is added
+// to the master mix when the regular processing reaches its slot, so the result does not depend on the thread timing.
+class PluginGraph
+{
+public:
+	struct Chain
+	{
+		std::vector<PLUGINDEX> plugins;  // In slot order. The last plugin writes to the master mix.
+		std::vector<float> output;       // Output of the last plugin: MIXBUFFERSIZE left samples, followed by MIXBUFFERSIZE right samples
+		bool hasOutput = false;          // The last plugin has written to output in the current chunk
+	};
+
+	PluginGraph();
+
+	// Rebuild the graph if the plugin setup or routing has changed since the last call.
+	void Update(const SNDMIXPLUGIN (&plugins)[MAX_MIXPLUGINS]);
+
+	// Chains that can be processed concurrently. Empty if there are fewer than two, as there is nothing to gain then.
+	std::vector<Chain> &GetChains() { return m_chains; }
+	// Index into GetChains() of the chain containing the given plugin, or PLUGINDEX_INVALID if it has to be processed on the mixing thread.
+	PLUGINDEX GetChainIndex(PLUGINDEX plug) const { return m_chainIndex[plug]; }
+
+protected:
+	// Everything about a plugin slot that the graph depends on
+	struct SlotKey
+	{
+		const IMixPlugin *plugin = nullptr;
+		int32 pluginId1 = 0, pluginId2 = 0;
+		uint32 outputRouting = 0;
+		uint8 routingFlags = 0;
+		uint8 mixMode = 0;
+		bool active = false;
+		bool outputActive = false;
+
+		bool operator==(const SlotKey &other) const
+		{
+			return plugin == other.plugin && pluginId1 == other.pluginId1 && pluginId2 == other.pluginId2
+				&& outputRouting == other.outputRouting && routingFlags == other.routingFlags && mixMode == other.mixMode
+				&& active == other.active && outputActive == other.outputActive;
+		}
+		bool operator!=(const SlotKey &other) const { return !(*this == other); }
+	};
+
+	void Rebuild(const SNDMIXPLUGIN (&plugins)[MAX_MIXPLUGINS]);
+
+	std::array<SlotKey, MAX_MIXPLUGINS> m_key;
+	std::array<PLUGINDEX, MAX_MIXPLUGINS> m_chainIndex;
+	std::vector<Chain> m_chains;
+};
+
+
+// Worker threads that process the independent plugin chains of each mix chunk
+class PluginWorkerPool
+{
+public:
+	explicit PluginWorkerPool(uint32 numThreads);
+	~PluginWorkerPool();
+
+	uint32 GetNumThreads() const { return static_cast<uint32>(m_threads.size()); }
+
+	// Call job(i) for every i < numJobs, spread over the worker threads and the calling thread. Returns once all jobs are done.
+	void Run(uint32 numJobs, const std::function<void(uint32)> &job);
+
+protected:
+	void WorkerThread();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_workAvailable;
+	std::condition_variable m_workDone;
+	const std::function<void(uint32)> *m_job = nullptr;
+	uint32 m_numJobs = 0;
+	uint32 m_nextJob = 0;
+	uint32 m_jobsDone = 0;
+	bool m_shutdown = false;
+};
+
+#endif // NO_PLUGINS
+
+
+OPENMPT_NAMESPACE_END
@@ -44,13 +44,10 @@ Chorus::Chorus(VSTPluginLib &factory, CSoundFile &sndFile, SNDMIXPLUGIN *mixStru
 }
 
 
-// Integer part of buffer position
-int32 Chorus::GetBufferIntOffset(int32 fpOffset) const
+// Integer part of buffer position, relative to the current write position
+uint32 Chorus::GetBufferIntOffset(int32 fpOffset) const
 {
-	if(fpOffset < 0)
-		fpOffset += m_bufSize * 4096;
-	MPT_ASSERT(fpOffset >= 0);
-	return (fpOffset / 4096) % m_bufSize;
+	return (m_bufPos + static_cast<uint32>(mpt::rshift_signed(fpOffset, 12))) & (m_bufSize - 1);
 }
 
 
@@ -72,9 +69,7 @@ void Chorus::Process(float *pOutL, float *pOutR, uint32 numFrames)
 		const float leftIn = *(in[0])++;
 		const float rightIn = *(in[1])++;
 
-		int32 readOffset = GetBufferIntOffset(m_bufPos + m_delayOffset);
-		int32 writeOffset = GetBufferIntOffset(m_bufPos);
-		m_buffer[writeOffset] = (m_buffer[readOffset] * feedback) + (rightIn + leftIn) * 0.5f;
+		m_buffer[m_bufPos] = (m_buffer[GetBufferIntOffset(m_delayOffset)] * feedback) + (rightIn + leftIn) * 0.5f;
 
 		float waveMin;
 		float waveMax;
@@ -96,14 +91,14 @@ void Chorus::Process(float *pOutL, float *pOutR, uint32 numFrames)
 			waveMax = m_waveShapeMax;
 		}
 
-		float left1 = m_buffer[GetBufferIntOffset(m_bufPos + m_delayL1)];
-		float left2 = m_buffer[GetBufferIntOffset(m_bufPos + m_delayL2)];
+		float left1 = m_buffer[GetBufferIntOffset(m_delayL1)];
+		float left2 = m_buffer[GetBufferIntOffset(m_delayL2)];
 		float fracPos = (m_delayL1 & 0xFFF) * (1.0f / 4096.0f);
 		float leftOut = (left2 - left1) * fracPos + left1;
 		*(out[0])++ = leftIn + (leftOut - leftIn) * wetDryMix;
 
-		float right1 = m_buffer[GetBufferIntOffset(m_bufPos + m_delayR1)];
-		float right2 = m_buffer[GetBufferIntOffset(m_bufPos + m_delayR2)];
+		float right1 = m_buffer[GetBufferIntOffset(m_delayR1)];
+		float right2 = m_buffer[GetBufferIntOffset(m_delayR2)];
 		fracPos = (m_delayR1 & 0xFFF) * (1.0f / 4096.0f);
 		float rightOut = (right2 - right1) * fracPos + right1;
 		*(out[1])++ = rightIn + (rightOut - rightIn) * wetDryMix;
@@ -115,9 +110,7 @@ void Chorus::Process(float *pOutL, float *pOutR, uint32 numFrames)
 		m_delayR1 = m_delayOffset + (phase < 2 ? -1 : 1) * static_cast<int32>(((phase % 2u) ? waveMax : waveMin) * m_depthDelay);
 		m_delayR2 = m_delayR1 + 4096;
 
-		if(m_bufPos <= 0)
-			m_bufPos += m_bufSize * 4096;
-		m_bufPos -= 4096;
+		m_bufPos = (m_bufPos - 1) & (m_bufSize - 1);
 	}
 
 	ProcessMixOps(pOutL, pOutR, m_mixBuffer.GetOutputBuffer(0), m_mixBuffer.GetOutputBuffer(1), numFrames);
@@ -164,7 +157,7 @@ void Chorus::Resume()
 
 void Chorus::PositionChanged()
 {
-	m_bufSize = Util::muldiv(m_SndFile.GetSampleRate(), 3840, 1000);
+	m_bufSize = mpt::ceil2(Util::muldiv_unsigned(m_SndFile.GetSampleRate(), 3840, 1000));
 	try
 	{
 		m_buffer.assign(m_bufSize, 0.0f);
@@ -46,7 +46,7 @@ protected:
 
 	// State
 	std::vector<float> m_buffer;
-	int32 m_bufPos, m_bufSize;
+	uint32 m_bufPos, m_bufSize;	// Write position in samples, buffer size (power of two)
 
 	int32 m_delayL1, m_delayL2, m_delayR1, m_delayR2;
 
@@ -78,6 +78,7 @@ public:
 	bool IsInstrument() const override { return false; }
 	bool CanRecieveMidiEvents() override { return false; }
 	bool ShouldProcessSilence() override { return true; }
+	bool CanProcessConcurrently() const override { return true; }
 
 #ifdef MODPLUG_TRACKER
 	CString GetDefaultEffectName() override { return _T("Chorus"); }
@@ -100,7 +101,7 @@ public:
 	int GetNumOutputChannels() const override { return 2; }
 
 protected:
-	int32 GetBufferIntOffset(int32 fpOffset) const;
+	uint32 GetBufferIntOffset(int32 fpOffset) const;
 
 	virtual float WetDryMix() const { return m_param[kChorusWetDryMix]; }
 	virtual bool IsTriangle() const { return m_param[kChorusWaveShape] < 1; }
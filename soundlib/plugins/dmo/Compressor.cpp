@@ -105,6 +105,16 @@ void Compressor::Process(float *pOutL, float *pOutR, uint32 numFrames)
 }
 
 
+uint32 Compressor::GetTailSize() const
+{
+	if(!m_bufSize)
+		return InfiniteTail;
+	// Output is silent once the predelay buffer has been flushed, but the gain envelope also needs to be fully released
+	// so that it is in the same state as without suspension once new input arrives. Release time is the time to decay by 20 dB.
+	return GetDecayTailSize(m_bufSize, ReleaseTime() * m_SndFile.GetSampleRate() / 1000.0, 0.1);
+}
+
+
 PlugParamValue Compressor::GetParameter(PlugParamIndex index)
 {
 	if(index < kCompNumParameters)
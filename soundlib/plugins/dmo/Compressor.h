@@ -55,6 +55,7 @@ public:
 	int32 GetVersion() const override { return 0; }
 	void Idle() override { }
 	uint32 GetLatency() const override { return 0; }
+	uint32 GetTailSize() const override;
 
 	void Process(float *pOutL, float *pOutR, uint32 numFrames) override;
 
@@ -74,6 +75,7 @@ public:
 	bool IsInstrument() const override { return false; }
 	bool CanRecieveMidiEvents() override { return false; }
 	bool ShouldProcessSilence() override { return true; }
+	bool CanProcessConcurrently() const override { return true; }
 
 #ifdef MODPLUG_TRACKER
 	CString GetDefaultEffectName() override { return _T("Compressor"); }
@@ -31,6 +31,7 @@ IMixPlugin* Echo::Create(VSTPluginLib &factory, CSoundFile &sndFile, SNDMIXPLUGI
 Echo::Echo(VSTPluginLib &factory, CSoundFile &sndFile, SNDMIXPLUGIN *mixStruct)
 	: IMixPlugin(factory, sndFile, mixStruct)
 	, m_bufferSize(0)
+	, m_bufferMask(0)
 	, m_writePos(0)
 	, m_sampleRate(sndFile.GetSampleRate())
 	, m_initialFeedback(0.0f)
@@ -53,15 +54,23 @@ void Echo::Process(float *pOutL, float *pOutR, uint32 numFrames)
 	const float wetMix = m_param[kEchoWetDry], dryMix = 1 - wetMix;
 	const float *in[2] = { m_mixBuffer.GetInputBuffer(0), m_mixBuffer.GetInputBuffer(1) };
 	float *out[2] = { m_mixBuffer.GetOutputBuffer(0), m_mixBuffer.GetOutputBuffer(1) };
+	// Emulate the wrap-around of a delay line that is exactly m_bufferSize frames long:
+	// A delay of 0 yields the oldest frame, unless the current frame has already been written by the other channel.
+	uint32 delayTime[2];
+	for(uint8 channel = 0; channel < 2; channel++)
+	{
+		const uint8 readChannel = (m_crossEcho ? (1 - channel) : channel);
+		delayTime[channel] = m_delayTime[readChannel] % m_bufferSize;
+		if(delayTime[channel] == 0 && readChannel >= channel)
+			delayTime[channel] = m_bufferSize;
+	}
 
 	for(uint32 i = numFrames; i != 0; i--)
 	{
 		for(uint8 channel = 0; channel < 2; channel++)
 		{
 			const uint8 readChannel = (m_crossEcho ? (1 - channel) : channel);
-			int readPos = m_writePos - m_delayTime[readChannel];
-			if(readPos < 0)
-				readPos += m_bufferSize;
+			const uint32 readPos = (m_writePos - delayTime[channel]) & m_bufferMask;
 
 			float chnInput = *(in[channel])++;
 			float chnDelay = m_delayLine[readPos * 2 + readChannel];
@@ -78,15 +87,25 @@ void Echo::Process(float *pOutL, float *pOutR, uint32 numFrames)
 			// Output samples now
 			*(out[channel])++ = (chnInput * dryMix + chnDelay * wetMix);
 		}
-		m_writePos++;
-		if(m_writePos == m_bufferSize)
-			m_writePos = 0;
+		m_writePos = (m_writePos + 1) & m_bufferMask;
 	}
 
 	ProcessMixOps(pOutL, pOutR, m_mixBuffer.GetOutputBuffer(0), m_mixBuffer.GetOutputBuffer(1), numFrames);
 }
 
 
+uint32 Echo::GetTailSize() const
+{
+	if(!m_bufferSize)
+		return InfiniteTail;
+	// A delay time of 0 reads the oldest sample in the delay line
+	uint32 delayTime = std::max(m_delayTime[0], m_delayTime[1]);
+	if(delayTime == 0)
+		delayTime = m_bufferSize;
+	return GetDecayTailSize(delayTime, delayTime, m_param[kEchoFeedback]);
+}
+
+
 PlugParamValue Echo::GetParameter(PlugParamIndex index)
 {
 	if(index < kEchoNumParameters)
@@ -122,9 +141,10 @@ void Echo::Resume()
 void Echo::PositionChanged()
 {
 	m_bufferSize = m_sampleRate * 2u;
+	m_bufferMask = mpt::ceil2(m_bufferSize) - 1;
 	try
 	{
-		m_delayLine.assign(m_bufferSize * 2, 0);
+		m_delayLine.assign((m_bufferMask + 1) * 2, 0);
 	} MPT_EXCEPTION_CATCH_OUT_OF_MEMORY(e)
 	{
 		MPT_EXCEPTION_DELETE_OUT_OF_MEMORY(e);
@@ -28,46 +28,58 @@ namespace DMO
 void I3DL2Reverb::DelayLine::Init(int32 ms, int32 padding, uint32 sampleRate, int32 delayTap)
 {
 	m_length = Util::muldiv(sampleRate, ms, 1000) + padding;
+	const uint32 size = mpt::ceil2(static_cast<uint32>(m_length));
+	m_mask = size - 1;
 	m_position = 0;
+	m_delay = 0;
+	m_written = false;
 	SetDelayTap(delayTap);
-	assign(m_length, 0.0f);
+	assign(size, 0.0f);
 }
 
 
 void I3DL2Reverb::DelayLine::SetDelayTap(int32 delayTap)
 {
 	if(m_length > 0)
-		m_delayPosition = (delayTap + m_position + m_length) % m_length;
+		m_delay = mpt::wrapping_modulo(delayTap, m_length);
 }
 
 
 void I3DL2Reverb::DelayLine::Advance()
 {
-	if(--m_position < 0)
-		m_position += m_length;
-	if(--m_delayPosition < 0)
-		m_delayPosition += m_length;
+	m_position = (m_position - 1) & m_mask;
+	m_written = false;
 }
 
 
 MPT_FORCEINLINE void I3DL2Reverb::DelayLine::Set(float value)
 {
-	at(m_position) = value;
+	(*this)[m_position] = value;
+	m_written = true;
+}
+
+
+// Read the sample that was written the given number of samples ago.
+// As in a delay line that is exactly m_length samples long, a delay of 0 yields the current sample if it has already been written, and the oldest sample otherwise.
+MPT_FORCEINLINE float I3DL2Reverb::DelayLine::Read(uint32 delay) const
+{
+	if(delay == 0 && !m_written)
+		delay = m_length;
+	return (*this)[(m_position + delay) & m_mask];
 }
 
 
 float I3DL2Reverb::DelayLine::Get(int32 offset) const
 {
-	offset = (offset + m_position) % m_length;
-	if(offset < 0)
-		offset += m_length;
-	return at(offset);
+	if(static_cast<uint32>(offset) >= static_cast<uint32>(m_length))
+		offset = mpt::wrapping_modulo(offset, m_length);
+	return Read(offset);
 }
 
 
 MPT_FORCEINLINE float I3DL2Reverb::DelayLine::Get() const
 {
-	return at(m_delayPosition);
+	return Read(m_delay);
 }
 
 
@@ -332,6 +344,15 @@ void I3DL2Reverb::SetCurrentProgram(int32 program)
 }
 
 
+uint32 I3DL2Reverb::GetTailSize() const
+{
+	// Decay time is the time it takes to decay by 60 dB; high frequencies may decay up to twice as slowly.
+	// Add some extra time for the early reflections and the longest delay lines.
+	const double sampleRate = m_SndFile.GetSampleRate();
+	return GetDecayTailSize((ReflectionsDelay() + ReverbDelay() + 0.5) * sampleRate, DecayTime() * std::max(1.0f, DecayHFRatio()) * sampleRate, 0.001);
+}
+
+
 PlugParamValue I3DL2Reverb::GetParameter(PlugParamIndex index)
 {
 	if(index < kI3DL2ReverbNumParameters)
@@ -48,11 +48,16 @@ protected:
 		kFullSampleRate = 0x02,
 	};
 
+	// Delay line with power-of-two storage, so that positions can be wrapped by masking.
 	class DelayLine : private std::vector<float>
 	{
-		int32 m_length;
-		int32 m_position;
-		int32 m_delayPosition;
+		int32 m_length;		// Logical length of the delay line
+		uint32 m_mask;
+		uint32 m_position;
+		uint32 m_delay;		// Read delay for Get(), in [0, m_length)
+		bool m_written;		// Set() has been called since the last Advance()
+
+		float Read(uint32 delay) const;
 
 	public:
 		void Init(int32 ms, int32 padding, uint32 sampleRate, int32 delayTap = 0);
@@ -99,6 +104,7 @@ public:
 	int32 GetVersion() const override { return 0; }
 	void Idle() override { }
 	uint32 GetLatency() const override { return 0; }
+	uint32 GetTailSize() const override;
 
 	void Process(float *pOutL, float *pOutR, uint32 numFrames) override;
 
@@ -118,6 +124,7 @@ public:
 	bool IsInstrument() const override { return false; }
 	bool CanRecieveMidiEvents() override { return false; }
 	bool ShouldProcessSilence() override { return true; }
+	bool CanProcessConcurrently() const override { return true; }
 
 #ifdef MODPLUG_TRACKER
 	CString GetDefaultEffectName() override { return _T("I3DL2Reverb"); }
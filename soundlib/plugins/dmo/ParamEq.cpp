@@ -76,6 +76,20 @@ void ParamEq::Process(float *pOutL, float *pOutR, uint32 numFrames)
 }
 
 
+uint32 ParamEq::GetTailSize() const
+{
+	// The impulse response decays with the magnitude of the filter's poles, i.e. the roots of z^2 + a1 * z + a2
+	const double a1 = a1DIVa0, a2 = a2DIVa0;
+	const double discriminant = a1 * a1 - 4.0 * a2;
+	double poleRadius;
+	if(discriminant < 0.0)
+		poleRadius = std::sqrt(a2);
+	else
+		poleRadius = std::max(std::abs(-a1 + std::sqrt(discriminant)), std::abs(-a1 - std::sqrt(discriminant))) * 0.5;
+	return GetDecayTailSize(0, 1, poleRadius);
+}
+
+
 PlugParamValue ParamEq::GetParameter(PlugParamIndex index)
 {
 	if(index < kEqNumParameters)
@@ -120,6 +120,13 @@ void WavesReverb::Process(float *pOutL, float *pOutR, uint32 numFrames)
 }
 
 
+uint32 WavesReverb::GetTailSize() const
+{
+	// Reverb time is the time it takes to decay by 60 dB; the comb and allpass buffers add up to 6144 samples of delay
+	return GetDecayTailSize(4096 + 2 * 1024, ReverbTime() * m_SndFile.GetSampleRate() / 1000.0, 0.001);
+}
+
+
 PlugParamValue WavesReverb::GetParameter(PlugParamIndex index)
 {
 	if(index < kDistNumParameters)
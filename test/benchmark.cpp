@@ -0,0 +1,584 @@
+/*
+ * benchmark.cpp
+ * -------------
+ * Purpose: Micro benchmarks for performance-sensitive parts of the player.
+ * Notes  : Run with "libopenmpt_test --benchmark [module files...]" or "make bench". Numbers are only comparable on the same machine.
+ * Authors: OpenMPT Devs
+ * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.
+ */
+
+
+#include "stdafx.h"
+#include "test.h"
+
+
+#if defined(ENABLE_TESTS) && defined(LIBOPENMPT_BUILD)
+
+
+#include "../common/mptRandom.h"
+#include "../common/mptFileIO.h"
+#include "../sounddsp/Reverb.h"
+#include "../soundlib/AudioReadTarget.h"
+#include "../soundlib/MixFuncTable.h"
+#include "../soundlib/ModChannel.h"
+#include "../soundlib/Resampler.h"
+#include "../soundlib/Sndfile.h"
+#ifndef NO_PLUGINS
+#include "../soundlib/plugins/PlugInterface.h"
+#include "../soundlib/plugins/PluginManager.h"
+#endif // NO_PLUGINS
+#include "../libopenmpt/libopenmpt.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+
+namespace Test {
+
+
+#ifndef NO_REVERB
+
+// Average time spent in CReverb::Process for one mix chunk (MIXBUFFERSIZE frames) of constant noise input
+static double BenchmarkReverbChunk(uint32 sampleRate, uint32 reverbType, bool halfRate, bool floatProcessing)
+{
+	constexpr uint32 chunkSize = MIXBUFFERSIZE;
+	const uint32 numChunks = sampleRate * 10 / chunkSize;	// 10 seconds of audio
+
+	auto reverb = std::make_unique<CReverb>();
+	reverb->m_Settings.m_nReverbType = reverbType;
+	reverb->m_Settings.m_halfRate = halfRate;
+	reverb->m_Settings.m_floatProcessing = floatProcessing;
+	reverb->Initialize(true, sampleRate);
+
+	mpt::fast_prng prng(0x12345678u);
+	std::uniform_int_distribution<int32> noise(-(1 << 24), (1 << 24));
+	std::vector<MixSampleInt> dry(chunkSize * 2);
+	std::vector<MixSampleInt> input(chunkSize * 2);
+	for(auto &s : input)
+	{
+		s = noise(prng);
+	}
+
+	std::chrono::steady_clock::duration elapsed{};
+	for(uint32 chunk = 0; chunk < numChunks; chunk++)
+	{
+		std::fill(dry.begin(), dry.end(), 0);
+		MixSampleInt *send = reverb->GetReverbSendBuffer(chunkSize);
+		for(uint32 i = 0; i < chunkSize * 2; i++)
+		{
+			send[i] += input[i];
+		}
+		const auto start = std::chrono::steady_clock::now();
+		reverb->Process(dry.data(), chunkSize);
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+	return std::chrono::duration<double, std::micro>(elapsed).count() / numChunks;
+}
+
+
+static void BenchmarkReverb()
+{
+	std::cout << "Reverb: average cost per " << MIXBUFFERSIZE << "-frame chunk (microseconds, all presets)" << std::endl;
+	std::cout << std::setw(8) << "rate" << std::setw(12) << "int" << std::setw(12) << "int/2" << std::setw(12) << "float" << std::setw(12) << "float/2" << std::endl;
+	for(uint32 sampleRate : { 48000u, 96000u, 192000u })
+	{
+		std::cout << std::setw(8) << sampleRate;
+		for(bool floatProcessing : { false, true })
+		{
+			for(bool halfRate : { false, true })
+			{
+				double total = 0.0;
+				for(uint32 type = 0; type < NUM_REVERBTYPES; type++)
+				{
+					total += BenchmarkReverbChunk(sampleRate, type, halfRate, floatProcessing);
+				}
+				std::cout << std::setw(12) << std::fixed << std::setprecision(2) << (total / NUM_REVERBTYPES);
+			}
+		}
+		std::cout << std::endl;
+	}
+}
+
+#endif // NO_REVERB
+
+
+// Average time for converting one stereo mix chunk (MIXBUFFERSIZE frames) of float noise to interleaved output,
+// either through AudioReadTargetGainBuffer or through the generic conversion loop.
+template<typename Tsample>
+static double BenchmarkOutputConversionChunk(DitherMode ditherMode, float gain, bool generic)
+{
+	constexpr uint32 chunkSize = MIXBUFFERSIZE;
+	constexpr uint32 numChunks = 20000;
+
+	mpt::fast_prng prng(0x12345678u);
+	std::uniform_real_distribution<float> noise(-1.2f, 1.2f);
+	std::vector<MixSampleFloat> input(chunkSize * 2), mix(chunkSize * 2);
+	for(auto &s : input)
+	{
+		s = noise(prng);
+	}
+	std::vector<Tsample> output(chunkSize * 2);
+	Dither dither(mpt::global_prng());
+	dither.SetMode(ditherMode);
+
+	std::chrono::steady_clock::duration elapsed{};
+	for(uint32 chunk = 0; chunk < numChunks; chunk++)
+	{
+		mix = input;
+		audio_buffer_interleaved<Tsample> outBuf(output.data(), 2, chunkSize);
+		const auto start = std::chrono::steady_clock::now();
+		if(generic)
+		{
+			dither.WithDither(
+				[&](auto &ditherInstance)
+				{
+					ConvertBufferMixFloatToBuffer<false>(outBuf, audio_buffer_interleaved<MixSampleFloat>(mix.data(), 2, chunkSize), ditherInstance, 2, chunkSize, GainFloat{gain});
+				}
+			);
+		} else
+		{
+			AudioReadTargetGainBuffer<audio_buffer_interleaved<Tsample>> target(outBuf, dither, gain);
+			target.DataCallback(mix.data(), 2, chunkSize);
+		}
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+	return std::chrono::duration<double, std::micro>(elapsed).count() / numChunks;
+}
+
+
+static void BenchmarkOutputConversion()
+{
+	std::cout << "Output conversion: average cost per " << MIXBUFFERSIZE << "-frame stereo chunk (microseconds, gain 0.5)" << std::endl;
+	std::cout << std::setw(16) << "format" << std::setw(12) << "generic" << std::setw(12) << "output" << std::endl;
+	const auto print = [](const char *name, double generic, double output)
+	{
+		std::cout << std::setw(16) << name << std::setw(12) << std::fixed << std::setprecision(2) << generic << std::setw(12) << output << std::endl;
+	};
+	print("int16", BenchmarkOutputConversionChunk<int16>(DitherNone, 0.5f, true), BenchmarkOutputConversionChunk<int16>(DitherNone, 0.5f, false));
+	print("int16 dithered", BenchmarkOutputConversionChunk<int16>(DitherModPlug, 0.5f, true), BenchmarkOutputConversionChunk<int16>(DitherModPlug, 0.5f, false));
+	print("float", BenchmarkOutputConversionChunk<float>(DitherNone, 0.5f, true), BenchmarkOutputConversionChunk<float>(DitherNone, 0.5f, false));
+}
+
+
+#ifndef NO_PLUGINS
+
+// Average time spent in the plugin's Process function for one mix chunk (MIXBUFFERSIZE frames) of constant noise input
+static double BenchmarkPluginChunk(int32 pluginId1, int32 pluginId2, uint32 sampleRate, const std::vector<std::pair<PlugParamIndex, PlugParamValue>> &parameters)
+{
+	constexpr uint32 chunkSize = MIXBUFFERSIZE;
+	const uint32 numChunks = sampleRate * 10 / chunkSize;	// 10 seconds of audio
+
+	auto sndFile = std::make_unique<CSoundFile>();
+	MixerSettings mixerSettings = sndFile->m_MixerSettings;
+	mixerSettings.gdwMixingFreq = sampleRate;
+	mixerSettings.gnChannels = 2;
+	sndFile->SetMixerSettings(mixerSettings);
+	SNDMIXPLUGIN &plugin = sndFile->m_MixPlugins[0];
+	plugin.Info.dwPluginId1 = pluginId1;
+	plugin.Info.dwPluginId2 = pluginId2;
+	if(!CreateMixPluginProc(plugin, *sndFile) || plugin.pMixPlugin == nullptr)
+		return 0.0;
+	IMixPlugin *mixPlug = plugin.pMixPlugin;
+	for(const auto &param : parameters)
+	{
+		mixPlug->SetParameter(param.first, param.second);
+	}
+	mixPlug->Resume();
+
+	mpt::fast_prng prng(0x12345678u);
+	std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+	std::vector<float> input(chunkSize * 2);
+	for(auto &s : input)
+	{
+		s = noise(prng);
+	}
+	std::vector<float> outL(chunkSize), outR(chunkSize);
+
+	std::chrono::steady_clock::duration elapsed{};
+	for(uint32 chunk = 0; chunk < numChunks; chunk++)
+	{
+		std::copy(input.begin(), input.begin() + chunkSize, mixPlug->m_mixBuffer.GetInputBuffer(0));
+		std::copy(input.begin() + chunkSize, input.end(), mixPlug->m_mixBuffer.GetInputBuffer(1));
+		std::fill(outL.begin(), outL.end(), 0.0f);
+		std::fill(outR.begin(), outR.end(), 0.0f);
+		const auto start = std::chrono::steady_clock::now();
+		mixPlug->Process(outL.data(), outR.data(), chunkSize);
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+	return std::chrono::duration<double, std::micro>(elapsed).count() / numChunks;
+}
+
+
+// Plugins with delay lines
+static void BenchmarkPlugins()
+{
+	const struct
+	{
+		const char *name;
+		int32 pluginId1, pluginId2;
+		std::vector<std::pair<PlugParamIndex, PlugParamValue>> parameters;
+	} plugins[] =
+	{
+		{ "Echo", kDmoMagic, int32(0xEF3E932C), { } },
+		{ "DigiBooster Echo", int32(0x304D4244), int32(0x6F686345), { } },  // "DBM0", "Echo"
+		{ "Chorus", kDmoMagic, int32(0xEFE6629C), { } },
+		{ "Flanger", kDmoMagic, int32(0xEFCA3D92), { } },
+		{ "I3DL2Reverb LQ", kDmoMagic, int32(0xEF985E71), { { 12, 0.0f } } },
+		{ "I3DL2Reverb HQ+", kDmoMagic, int32(0xEF985E71), { { 12, 1.0f } } },
+	};
+	std::cout << "Plugins: average cost per " << MIXBUFFERSIZE << "-frame chunk (microseconds)" << std::endl;
+	std::cout << std::setw(20) << std::left << "plugin" << std::right << std::setw(12) << "48000" << std::setw(12) << "96000" << std::endl;
+	for(const auto &plugin : plugins)
+	{
+		std::cout << std::setw(20) << std::left << plugin.name << std::right;
+		for(uint32 sampleRate : { 48000u, 96000u })
+		{
+			std::cout << std::setw(12) << std::fixed << std::setprecision(2) << BenchmarkPluginChunk(plugin.pluginId1, plugin.pluginId2, sampleRate, plugin.parameters);
+		}
+		std::cout << std::endl;
+	}
+}
+
+#endif // NO_PLUGINS
+
+
+// Voice state as the mixer sees it, laid out like the old mixer did: the hot fields at the start of a full ModChannel.
+struct StridedMixVoice
+{
+	MixVoice voice;
+	char padding[sizeof(ModChannel) - sizeof(MixVoice)];
+};
+
+
+// Average cost of mixing one voice for one chunk, in nanoseconds.
+// layout 0: voices mixed in place, one ModChannel apart (old mixer)
+// layout 1: voices gathered from ModChannel into a compact array and scattered back for every chunk (CreateStereoMix)
+// layout 2: voices kept in a compact array for the whole run (no per-chunk synchronisation)
+static double BenchmarkVoiceLayoutChunk(int layout, uint32 numVoices, uint32 chunkSize, const std::vector<int16> &sample, const CResampler &resampler)
+{
+	const SmpLength safeEnd = static_cast<SmpLength>(sample.size() - 2 * chunkSize - 16);
+	const uint32 numChunks = std::max(uint32(1), (1u << 25) / (numVoices * chunkSize));
+
+	std::vector<ModChannel> channels(numVoices);
+	std::vector<StridedMixVoice> strided(numVoices);
+	mpt::aligned_buffer<MixVoice, 64> compact(numVoices);
+	mpt::fast_prng prng(0x4D495856u);
+	for(uint32 v = 0; v < numVoices; v++)
+	{
+		MixVoice voice{};
+		voice.position = SamplePosition(std::uniform_int_distribution<int32>(8, safeEnd - 1)(prng), 0);
+		voice.increment = SamplePosition::FromDouble(0.5 + 1.5 * v / numVoices);
+		voice.pCurrentSample = sample.data();
+		voice.nLength = static_cast<SmpLength>(sample.size());
+		voice.leftVol = voice.rightVol = 1 << 11;
+		voice.resamplingMode = SRCMODE_SINC8;
+		channels[v].SetMixVoice(voice);
+		strided[v].voice = voice;
+		compact[v] = voice;
+	}
+
+	const MixFuncInterface mixFunc = MixFuncTable::Functions[MixFuncTable::ndx16Bit | MixFuncTable::ndxFIRFilter];
+	std::vector<mixsample_t> mixBuffer(chunkSize * 2);
+	const auto mixVoice = [&](MixVoice &voice)
+	{
+		mixFunc(voice, resampler, mixBuffer.data(), chunkSize);
+		if(voice.position.GetUInt() >= safeEnd)
+			voice.position = SamplePosition(8, 0);
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	for(uint32 chunk = 0; chunk < numChunks; chunk++)
+	{
+		std::fill(mixBuffer.begin(), mixBuffer.end(), 0);
+		for(uint32 v = 0; v < numVoices; v++)
+		{
+			if(layout == 0)
+			{
+				mixVoice(strided[v].voice);
+			} else if(layout == 1)
+			{
+				channels[v].GetMixVoice(compact[v]);
+				mixVoice(compact[v]);
+				channels[v].SetMixVoice(compact[v]);
+			} else
+			{
+				mixVoice(compact[v]);
+			}
+		}
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::nano>(elapsed).count() / (double(numChunks) * numVoices);
+}
+
+
+static void BenchmarkVoiceLayout()
+{
+	std::cout << "Mixer voice layout: average cost per voice and chunk, 16-bit mono, FIR interpolation (nanoseconds)" << std::endl;
+	std::cout << std::setw(8) << "voices" << std::setw(8) << "frames" << std::setw(12) << "strided" << std::setw(12) << "gathered" << std::setw(12) << "compact" << std::endl;
+
+	mpt::fast_prng prng(0x12345678u);
+	std::vector<int16> sample(1 << 16);
+	for(auto &s : sample)
+	{
+		s = static_cast<int16>(std::uniform_int_distribution<int>(-32768, 32767)(prng));
+	}
+	auto resampler = std::make_unique<CResampler>();
+
+	for(uint32 numVoices : { 32u, 256u })
+	{
+		for(uint32 chunkSize : { 16u, 64u, uint32(MIXBUFFERSIZE) })
+		{
+			// Best of several interleaved runs, so that clock changes and scheduling noise hit all layouts alike
+			double best[3] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+			for(int run = 0; run < 5; run++)
+			{
+				for(int layout = 0; layout < 3; layout++)
+				{
+					best[layout] = std::min(best[layout], BenchmarkVoiceLayoutChunk(layout, numVoices, chunkSize, sample, *resampler));
+				}
+			}
+			std::cout << std::setw(8) << numVoices << std::setw(8) << chunkSize;
+			for(double time : best)
+			{
+				std::cout << std::setw(12) << std::fixed << std::setprecision(1) << time;
+			}
+			std::cout << std::endl;
+		}
+	}
+}
+
+
+static void WriteLE16(std::vector<char> &out, uint16 value)
+{
+	out.push_back(static_cast<char>(value & 0xFF));
+	out.push_back(static_cast<char>(value >> 8));
+}
+
+
+static void WriteLE32(std::vector<char> &out, uint32 value)
+{
+	WriteLE16(out, static_cast<uint16>(value & 0xFFFF));
+	WriteLE16(out, static_cast<uint16>(value >> 16));
+}
+
+
+// Impulse Tracker module with many large, densely filled patterns and no samples
+static std::vector<char> CreateBenchmarkIT(uint32 seed, uint16 numPatterns, uint16 numRows, uint8 numChannels)
+{
+	mpt::fast_prng prng(seed);
+	const auto random = [&prng](int low, int high) { return std::uniform_int_distribution<int>(low, high)(prng); };
+
+	std::vector<std::vector<char>> patterns(numPatterns);
+	for(auto &pattern : patterns)
+	{
+		for(uint16 row = 0; row < numRows; row++)
+		{
+			for(uint8 chn = 0; chn < numChannels; chn++)
+			{
+				if(random(0, 9) >= 6)
+					continue;
+				const uint8 mask = static_cast<uint8>(random(1, 15));
+				pattern.push_back(static_cast<char>((chn + 1) | 0x80));
+				pattern.push_back(static_cast<char>(mask));
+				if(mask & 1) pattern.push_back(static_cast<char>(random(0, 119)));
+				if(mask & 2) pattern.push_back(static_cast<char>(random(0, 1)));
+				if(mask & 4) pattern.push_back(static_cast<char>(random(0, 64)));
+				if(mask & 8)
+				{
+					pattern.push_back(static_cast<char>(random(1, 26)));
+					pattern.push_back(static_cast<char>(random(0, 255)));
+				}
+			}
+			pattern.push_back(0);
+		}
+	}
+
+	const uint16 numOrders = numPatterns + 1;
+	std::vector<char> it = { 'I', 'M', 'P', 'M', 'b', 'e', 'n', 'c', 'h' };
+	it.resize(30, 0);
+	for(uint16 value : { uint16(0x1004), numOrders, uint16(0), uint16(0), numPatterns, uint16(0x0214), uint16(0x0214), uint16(1), uint16(0) })
+		WriteLE16(it, value);
+	for(uint8 value : { 128, 48, 6, 125, 128, 0 })
+		it.push_back(static_cast<char>(value));
+	WriteLE16(it, 0);
+	WriteLE32(it, 0);
+	WriteLE32(it, 0);
+	it.insert(it.end(), 64, 32);	// Channel panning
+	it.insert(it.end(), 64, 64);	// Channel volume
+	for(uint16 pat = 0; pat < numPatterns; pat++)
+		it.push_back(static_cast<char>(pat));
+	it.push_back(static_cast<char>(0xFF));
+
+	uint32 offset = static_cast<uint32>(it.size() + 4 * numPatterns);
+	for(const auto &pattern : patterns)
+	{
+		WriteLE32(it, offset);
+		offset += static_cast<uint32>(8 + pattern.size());
+	}
+	for(const auto &pattern : patterns)
+	{
+		WriteLE16(it, static_cast<uint16>(pattern.size()));
+		WriteLE16(it, numRows);
+		WriteLE32(it, 0);
+		it.insert(it.end(), pattern.begin(), pattern.end());
+	}
+	return it;
+}
+
+
+// FastTracker 2 module with many large, densely filled patterns and no instruments
+static std::vector<char> CreateBenchmarkXM(uint32 seed, uint16 numPatterns, uint16 numRows, uint8 numChannels)
+{
+	mpt::fast_prng prng(seed);
+	const auto random = [&prng](int low, int high) { return std::uniform_int_distribution<int>(low, high)(prng); };
+
+	const std::string magic = "Extended Module: bench               \x1A" "FastTracker v2.00   ";
+	std::vector<char> xm(magic.begin(), magic.end());
+	WriteLE16(xm, 0x0104);
+	WriteLE32(xm, 276);
+	for(uint16 value : { numPatterns, uint16(0), uint16(numChannels), numPatterns, uint16(0), uint16(1), uint16(6), uint16(125) })
+		WriteLE16(xm, value);
+	for(uint16 ord = 0; ord < 256; ord++)
+		xm.push_back(static_cast<char>(ord < numPatterns ? ord : 0));
+
+	std::vector<char> pattern;
+	for(uint16 pat = 0; pat < numPatterns; pat++)
+	{
+		pattern.clear();
+		for(uint32 cell = 0; cell < uint32(numRows) * numChannels; cell++)
+		{
+			if(random(0, 1))
+			{
+				pattern.push_back(static_cast<char>(0x80));
+				continue;
+			}
+			const uint8 flags = static_cast<uint8>(0x80 | random(1, 31));
+			pattern.push_back(static_cast<char>(flags));
+			if(flags & 1) pattern.push_back(static_cast<char>(random(1, 96)));
+			if(flags & 2) pattern.push_back(static_cast<char>(random(0, 1)));
+			if(flags & 4) pattern.push_back(static_cast<char>(random(0x10, 0x50)));
+			if(flags & 8) pattern.push_back(static_cast<char>(random(0, 15)));
+			if(flags & 16) pattern.push_back(static_cast<char>(random(0, 255)));
+		}
+		WriteLE32(xm, 9);
+		xm.push_back(0);
+		WriteLE16(xm, numRows);
+		WriteLE16(xm, static_cast<uint16>(pattern.size()));
+		xm.insert(xm.end(), pattern.begin(), pattern.end());
+	}
+	return xm;
+}
+
+
+// Best time of several runs for loading a module from memory and through std::istream, in milliseconds
+static void BenchmarkLoadModule(const std::vector<char> &data, double &fromMemory, double &fromStream)
+{
+	const std::map<std::string, std::string> ctls = { { "load.skip_subsongs_init", "1" } };
+	std::ostringstream log;
+	const std::string str(data.begin(), data.end());
+	fromMemory = fromStream = std::numeric_limits<double>::max();
+	for(int run = 0; run < 7; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		{
+			openmpt::module module(data, log, ctls);
+		}
+		fromMemory = std::min(fromMemory, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		std::istringstream stream(str);
+		start = std::chrono::steady_clock::now();
+		{
+			openmpt::module module(stream, log, ctls);
+		}
+		fromStream = std::min(fromStream, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+}
+
+
+static void PrintLoadTimes(const std::string &name, const std::vector<std::vector<char>> &corpus)
+{
+	double totalMemory = 0.0, totalStream = 0.0;
+	for(const auto &data : corpus)
+	{
+		double fromMemory = 0.0, fromStream = 0.0;
+		BenchmarkLoadModule(data, fromMemory, fromStream);
+		totalMemory += fromMemory;
+		totalStream += fromStream;
+	}
+	std::cout << std::setw(40) << std::left << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << totalMemory << std::setw(12) << totalStream << std::endl;
+}
+
+
+static void BenchmarkLoading(const std::vector<mpt::PathString> &files)
+{
+	std::cout << "Loading: best of 7 runs without subsong initialisation (milliseconds)" << std::endl;
+	std::cout << std::setw(40) << std::left << "module" << std::right << std::setw(12) << "memory" << std::setw(12) << "stream" << std::endl;
+
+	std::vector<std::vector<char>> corpus;
+	for(uint32 seed = 1; seed <= 4; seed++)
+		corpus.push_back(CreateBenchmarkIT(seed, 200, 128, 64));
+	PrintLoadTimes("4 x IT, 200 patterns x 128 rows x 64 ch", corpus);
+	corpus.clear();
+	for(uint32 seed = 1; seed <= 4; seed++)
+		corpus.push_back(CreateBenchmarkXM(seed, 200, 128, 32));
+	PrintLoadTimes("4 x XM, 200 patterns x 128 rows x 32 ch", corpus);
+
+	for(const auto &filename : files)
+	{
+		mpt::ifstream f(filename, std::ios::binary);
+		std::vector<char> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+		try
+		{
+			PrintLoadTimes(filename.ToUTF8(), { data });
+		} catch(const openmpt::exception &)
+		{
+			std::cout << std::setw(40) << std::left << filename.ToUTF8() << std::right << "  cannot be loaded" << std::endl;
+		}
+	}
+}
+
+
+void DoBenchmarks(const std::vector<mpt::PathString> &files)
+{
+#ifndef NO_REVERB
+	BenchmarkReverb();
+#endif // NO_REVERB
+	BenchmarkOutputConversion();
+#ifndef NO_PLUGINS
+	BenchmarkPlugins();
+#endif // NO_PLUGINS
+	BenchmarkVoiceLayout();
+	BenchmarkLoading(files);
+}
+
+
+} // namespace Test
+
+
+OPENMPT_NAMESPACE_END
+
+
+#else // !(ENABLE_TESTS && LIBOPENMPT_BUILD)
+
+
+OPENMPT_NAMESPACE_BEGIN
+
+namespace Test {
+
+void DoBenchmarks(const std::vector<mpt::PathString> &)
+{
+	return;
+}
+
+} // namespace Test
+
+OPENMPT_NAMESPACE_END
+
+
+#endif
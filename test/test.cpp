@@ -32,6 +32,13 @@
 #include "../soundlib/ITCompression.h"
 #include "../soundlib/tuningcollection.h"
 #include "../soundlib/tuning.h"
+#include "../soundlib/MixFuncTable.h"
+#include "../soundlib/MixerLoops.h"
+#include "../soundlib/Resampler.h"
+#include "../soundlib/OPL.h"
+#include "../soundlib/AudioReadTarget.h"
+#include "../sounddsp/Reverb.h"
+#include "../sounddsp/EQ.h"
 #include "../soundbase/Dither.h"
 #ifdef MODPLUG_TRACKER
 #include "../mptrack/Mptrack.h"
@@ -44,17 +51,23 @@
 #include "../common/mptFileIO.h"
 #ifdef LIBOPENMPT_BUILD
 #include "../libopenmpt/libopenmpt_version.h"
+#include "../libopenmpt/libopenmpt.hpp"
+#include "../libopenmpt/libopenmpt_ext_impl.hpp"
 #endif // LIBOPENMPT_BUILD
 #ifndef NO_PLUGINS
 #include "../soundlib/plugins/PlugInterface.h"
+#include "../soundlib/plugins/PluginManager.h"
+#include "../soundlib/plugins/dmo/Echo.h"
 #endif
 #include <sstream>
 #include <limits>
 #ifdef LIBOPENMPT_BUILD
+#include <iomanip>
 #include <iostream>
 #endif // LIBOPENMPT_BUILD
 #include <istream>
 #include <ostream>
+#include <random>
 #include <stdexcept>
 #if MPT_COMPILER_MSVC
 #include <tchar.h>
@@ -106,6 +119,29 @@ static MPT_NOINLINE void TestSettings();
 static MPT_NOINLINE void TestStringIO();
 static MPT_NOINLINE void TestMIDIEvents();
 static MPT_NOINLINE void TestSampleConversion();
+static MPT_NOINLINE void TestResamplerTables();
+static MPT_NOINLINE void TestMultiVoiceMixing();
+static MPT_NOINLINE void TestProgressiveLoading();
+static MPT_NOINLINE void TestMetadataOnlyLoading();
+static MPT_NOINLINE void TestProbeSignatures();
+static MPT_NOINLINE void TestPluginAutoSuspend();
+static MPT_NOINLINE void TestReverbModes();
+static MPT_NOINLINE void TestMixerLoops();
+static MPT_NOINLINE void TestReadAdd();
+static MPT_NOINLINE void TestPatternWindow();
+static MPT_NOINLINE void TestPatternData();
+static MPT_NOINLINE void TestStems();
+static MPT_NOINLINE void TestMixSampleRate();
+static MPT_NOINLINE void TestRestorePlaybackState();
+static MPT_NOINLINE void TestRenderPool();
+static MPT_NOINLINE void TestSamplePyramids();
+static MPT_NOINLINE void TestOPLResampler();
+static MPT_NOINLINE void TestPluginGraph();
+static MPT_NOINLINE void TestPluginDelayLines();
+static MPT_NOINLINE void TestEQCascade();
+static MPT_NOINLINE void TestOutputGain();
+static MPT_NOINLINE void TestMasterBus();
+static MPT_NOINLINE void TestMixerStatistics();
 static MPT_NOINLINE void TestITCompression();
 static MPT_NOINLINE void TestTunings();
 static MPT_NOINLINE void TestPCnoteSerialization();
@@ -206,6 +242,29 @@ void DoTests()
 	DO_TEST(TestStringIO);
 	DO_TEST(TestMIDIEvents);
 	DO_TEST(TestSampleConversion);
+	DO_TEST(TestResamplerTables);
+	DO_TEST(TestMultiVoiceMixing);
+	DO_TEST(TestProgressiveLoading);
+	DO_TEST(TestMetadataOnlyLoading);
+	DO_TEST(TestProbeSignatures);
+	DO_TEST(TestPluginAutoSuspend);
+	DO_TEST(TestReverbModes);
+	DO_TEST(TestMixerLoops);
+	DO_TEST(TestReadAdd);
+	DO_TEST(TestPatternWindow);
+	DO_TEST(TestPatternData);
+	DO_TEST(TestStems);
+	DO_TEST(TestMixSampleRate);
+	DO_TEST(TestRestorePlaybackState);
+	DO_TEST(TestRenderPool);
+	DO_TEST(TestSamplePyramids);
+	DO_TEST(TestOPLResampler);
+	DO_TEST(TestPluginGraph);
+	DO_TEST(TestPluginDelayLines);
+	DO_TEST(TestEQCascade);
+	DO_TEST(TestOutputGain);
+	DO_TEST(TestMasterBus);
+	DO_TEST(TestMixerStatistics);
 	DO_TEST(TestITCompression);
 	DO_TEST(TestTunings);
 
@@ -4903,6 +4962,2006 @@ static MPT_NOINLINE void TestSampleConversion()
 }
 
 
+#ifdef MPT_INTMIXER
+static void WriteResamplerTable(std::ostream &output, const char *declaration, const int16 *table, std::size_t size)
+{
+	output << declaration << " =\n{\n";
+	for(std::size_t i = 0; i < size; i += 16)
+	{
+		for(std::size_t j = i; j < std::min(size, i + 16); j++)
+		{
+			if(j != i)
+				output << ' ';
+			output << std::setw(5) << table[j] << ',';
+		}
+		output << '\n';
+	}
+	output << "};\n\n";
+}
+#endif // MPT_INTMIXER
+
+
+bool GenerateResamplerTables(std::ostream &output)
+{
+#ifdef MPT_INTMIXER
+	std::vector<SINC_TYPE> kaiserSinc(SINC_PHASES * 8), downsample13x(SINC_PHASES * 8), downsample2x(SINC_PHASES * 8);
+	CResampler::ComputeSincTables(kaiserSinc.data(), downsample13x.data(), downsample2x.data());
+	const CResamplerSettings defaultSettings;
+	std::vector<WFIR_TYPE> lut(WFIR_LUTLEN * WFIR_WIDTH);
+	CWindowedFIR::ComputeTable(lut.data(), defaultSettings.gdWFIRCutoff, defaultSettings.gbWFIRType);
+
+	output.imbue(std::locale::classic());
+	output <<
+		"/*\n"
+		" * ResamplerTables.h\n"
+		" * -----------------\n"
+		" * Purpose: Pre-computed polyphase sinc tables and windowed FIR table for the default resampler settings.\n"
+		" * Notes  : Generated with \"libopenmpt_test --generate-resampler-tables\", do not edit by hand.\n"
+		" *          The test suite verifies that these tables match CResampler::ComputeSincTables and CWindowedFIR::ComputeTable.\n"
+		" *          Only to be included by Tables.cpp.\n"
+		" * Authors: OpenMPT Devs\n"
+		" * The OpenMPT source code is released under the BSD license. Read LICENSE for more details.\n"
+		" */\n"
+		"\n\n"
+		"#pragma once\n"
+		"\n"
+		"#include \"BuildSettings.h\"\n"
+		"\n"
+		"#include \"Resampler.h\"\n"
+		"#include \"WindowedFIR.h\"\n"
+		"\n\n"
+		"OPENMPT_NAMESPACE_BEGIN\n"
+		"\n\n"
+		"#ifdef MPT_INTMIXER\n"
+		"\n\n";
+	WriteResamplerTable(output, "const SINC_TYPE CResampler::gKaiserSinc[SINC_PHASES * 8]", kaiserSinc.data(), kaiserSinc.size());
+	WriteResamplerTable(output, "const SINC_TYPE CResampler::gDownsample13x[SINC_PHASES * 8]", downsample13x.data(), downsample13x.size());
+	WriteResamplerTable(output, "const SINC_TYPE CResampler::gDownsample2x[SINC_PHASES * 8]", downsample2x.data(), downsample2x.size());
+	WriteResamplerTable(output, "const WFIR_TYPE CWindowedFIR::lutDefault[WFIR_LUTLEN * WFIR_WIDTH]", lut.data(), lut.size());
+	output <<
+		"\n"
+		"#endif // MPT_INTMIXER\n"
+		"\n\n"
+		"OPENMPT_NAMESPACE_END\n";
+	return true;
+#else
+	MPT_UNREFERENCED_PARAMETER(output);
+	return false;
+#endif // MPT_INTMIXER
+}
+
+
+static MPT_NOINLINE void TestResamplerTables()
+{
+#ifdef MPT_INTMIXER
+	// The pre-computed tables must match the output of the table generators exactly.
+	// If they do not, regenerate soundlib/ResamplerTables.h with "libopenmpt_test --generate-resampler-tables".
+	std::vector<SINC_TYPE> kaiserSinc(SINC_PHASES * 8), downsample13x(SINC_PHASES * 8), downsample2x(SINC_PHASES * 8);
+	CResampler::ComputeSincTables(kaiserSinc.data(), downsample13x.data(), downsample2x.data());
+	VERIFY_EQUAL_NONCONT(std::equal(kaiserSinc.begin(), kaiserSinc.end(), CResampler::gKaiserSinc), true);
+	VERIFY_EQUAL_NONCONT(std::equal(downsample13x.begin(), downsample13x.end(), CResampler::gDownsample13x), true);
+	VERIFY_EQUAL_NONCONT(std::equal(downsample2x.begin(), downsample2x.end(), CResampler::gDownsample2x), true);
+
+	const CResamplerSettings defaultSettings;
+	CWindowedFIR defaultFIR;
+	defaultFIR.InitTable(defaultSettings.gdWFIRCutoff, defaultSettings.gbWFIRType);
+	std::vector<WFIR_TYPE> lut(WFIR_LUTLEN * WFIR_WIDTH);
+	CWindowedFIR::ComputeTable(lut.data(), defaultSettings.gdWFIRCutoff, defaultSettings.gbWFIRType);
+	VERIFY_EQUAL_NONCONT(std::equal(lut.begin(), lut.end(), defaultFIR.GetLUT()), true);
+
+	// Other settings are still computed at runtime
+	CWindowedFIR customFIR;
+	customFIR.InitTable(0.8, WFIR_HANN);
+	CWindowedFIR::ComputeTable(lut.data(), 0.8, WFIR_HANN);
+	VERIFY_EQUAL_NONCONT(std::equal(lut.begin(), lut.end(), customFIR.GetLUT()), true);
+#endif // MPT_INTMIXER
+}
+
+
+#ifdef MPT_INTMIXER
+
+// Render voices one by one the way CSoundFile::CreateStereoMix does, including the contribution to the last sampling point.
+static void MixVoicesSeparately(MixVoice *voices, const MixVoiceLane *lanes, MixFuncInterface mixFunc, const CResampler &resampler, mixsample_t *buffer, uint32 count)
+{
+	mixsample_t *bufferEnd = buffer + count * 2;
+	for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+	{
+		MixVoice &chn = voices[v];
+		chn.position = lanes[v].position;
+		chn.pCurrentSample = lanes[v].sample;
+		chn.nROfs = -*(bufferEnd - 2);
+		chn.nLOfs = -*(bufferEnd - 1);
+		mixFunc(chn, resampler, buffer, count);
+		chn.nROfs += *(bufferEnd - 2);
+		chn.nLOfs += *(bufferEnd - 1);
+	}
+}
+
+#endif // MPT_INTMIXER
+
+
+static MPT_NOINLINE void TestMultiVoiceMixing()
+{
+#ifdef MPT_INTMIXER
+	// Mixing several voices at once must produce exactly the same output and voice state as mixing them one by one.
+	mpt::default_prng &prng = *s_PRNG;
+	const CResampler resampler;
+	const uint32 count = 500;
+	const SmpLength margin = 64, sampleLength = 2048;
+
+	std::vector<int16> sampleData[MIXVOICES_PER_BATCH];
+	for(auto &data : sampleData)
+	{
+		data.resize((sampleLength + 2 * margin) * 2);
+		for(auto &smp : data)
+		{
+			smp = mpt::random<int16>(prng);
+		}
+	}
+
+	const MixFuncTable::ResamplingIndex resamplingModes[] = { MixFuncTable::ndxNoInterpolation, MixFuncTable::ndxLinear, MixFuncTable::ndxFastSinc, MixFuncTable::ndxKaiser, MixFuncTable::ndxFIRFilter };
+	for(auto resampling : resamplingModes)
+	{
+		for(uint32 format = 0; format < 4; format++)
+		{
+			for(uint32 filter = 0; filter < 2; filter++)
+			{
+				const uint32 functionNdx = resampling | format | (filter ? MixFuncTable::ndxFilter : 0);
+				const MultiVoiceMixFuncInterface multiVoiceFunc = MixFuncTable::MultiVoiceFunctions[functionNdx];
+				VERIFY_EQUAL_NONCONT(multiVoiceFunc != nullptr, true);
+				if(multiVoiceFunc == nullptr)
+				{
+					continue;
+				}
+
+				MixVoice voices[MIXVOICES_PER_BATCH];
+				MixVoiceLane lanes[MIXVOICES_PER_BATCH];
+				for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+				{
+					MixVoice &chn = voices[v];
+					chn = MixVoice{};
+					chn.position = SamplePosition(0);
+					// Cover both upsampling and the downsampling tables of the polyphase resampler
+					chn.increment = SamplePosition::FromDouble(0.25 + mpt::random<uint8>(prng) / 80.0);
+					chn.leftVol = mpt::random<uint16, 12>(prng);
+					chn.rightVol = mpt::random<uint16, 12>(prng);
+					chn.nFilter_A0 = 1 << 22;
+					chn.nFilter_B0 = 1 << 23;
+					chn.nFilter_B1 = -(1 << 21);
+					chn.nFilter_HP = (v & 1) ? -1 : 0;
+					chn.nLength = sampleLength;
+					chn.resamplingMode = SRCMODE_LINEAR;
+					// Sample data of all formats is taken from the same buffer, the margin allows for the interpolation look-ahead and look-behind.
+					const int8 *start = reinterpret_cast<const int8 *>(sampleData[v].data());
+					const std::size_t bytesPerFrame = ((format & MixFuncTable::ndx16Bit) ? 2 : 1) * ((format & MixFuncTable::ndxStereo) ? 2 : 1);
+					lanes[v].voice = &chn;
+					lanes[v].sample = start + margin * bytesPerFrame;
+					lanes[v].position = SamplePosition(mpt::random<int32, 8>(prng), mpt::random<uint32>(prng));
+				}
+				MixVoice voicesSeparate[MIXVOICES_PER_BATCH];
+				MixVoiceLane lanesSeparate[MIXVOICES_PER_BATCH];
+				std::copy(std::begin(voices), std::end(voices), std::begin(voicesSeparate));
+				std::copy(std::begin(lanes), std::end(lanes), std::begin(lanesSeparate));
+
+				std::vector<mixsample_t> separate(count * 2), combined(count * 2);
+				for(std::size_t i = 0; i < separate.size(); i++)
+				{
+					separate[i] = combined[i] = mpt::random<int16>(prng);
+				}
+
+				MixVoicesSeparately(voicesSeparate, lanesSeparate, MixFuncTable::Functions[functionNdx], resampler, separate.data(), count);
+				multiVoiceFunc(lanes, resampler, combined.data(), count);
+
+				VERIFY_EQUAL_NONCONT(separate == combined, true);
+				for(int v = 0; v < MIXVOICES_PER_BATCH; v++)
+				{
+					VERIFY_EQUAL_NONCONT(voices[v].nROfs, voicesSeparate[v].nROfs);
+					VERIFY_EQUAL_NONCONT(voices[v].nLOfs, voicesSeparate[v].nLOfs);
+					VERIFY_EQUAL_NONCONT(std::memcmp(voices[v].nFilter_Y, voicesSeparate[v].nFilter_Y, sizeof(voices[v].nFilter_Y)), 0);
+				}
+
+				// Optimized kernels for unfiltered 16-bit mono voices
+				if(format == MixFuncTable::ndx16Bit && !filter && (resampling == MixFuncTable::ndxNoInterpolation || resampling == MixFuncTable::ndxLinear))
+				{
+					std::vector<mixsample_t> reference = separate;
+					combined = separate;
+					multiVoiceFunc(lanes, resampler, reference.data(), count);
+					if(MultiVoiceMix16Mono(lanes, resampling == MixFuncTable::ndxLinear, combined.data(), count))
+					{
+						VERIFY_EQUAL_NONCONT(combined == reference, true);
+					}
+				}
+			}
+		}
+	}
+#endif // MPT_INTMIXER
+}
+
+
+// Stream buffer that cannot seek and keeps track of how much of the data has been handed out
+class UnseekableStreamBuf : public std::streambuf
+{
+private:
+	std::vector<char> data;
+	std::size_t served = 0;
+public:
+	UnseekableStreamBuf(const std::vector<mpt::byte> &data_) : data(mpt::byte_cast<const char *>(data_.data()), mpt::byte_cast<const char *>(data_.data()) + data_.size()) { }
+	std::size_t GetServed() const { return served; }
+protected:
+	int_type underflow() override
+	{
+		if(served >= data.size())
+		{
+			return traits_type::eof();
+		}
+		const std::size_t chunk = std::min(std::size_t(512), data.size() - served);
+		setg(data.data() + served, data.data() + served, data.data() + served + chunk);
+		served += chunk;
+		return traits_type::to_int_type(*gptr());
+	}
+};
+
+
+// ProTracker module with uncompressed and ADPCM-compressed samples that are all triggered on the first row
+static std::vector<mpt::byte> CreateProgressiveTestMOD()
+{
+	struct SampleDesc { uint16 lengthWords; bool adpcm; };
+	const SampleDesc samples[] = { { 20000, false }, { 30000, true }, { 25000, false }, { 15000, true } };
+
+	mpt::default_prng &prng = *s_PRNG;
+	std::vector<mpt::byte> mod(1084, mpt::byte(0));
+	std::memcpy(mod.data(), "progressive", 11);
+	for(std::size_t smp = 0; smp < 4; smp++)
+	{
+		mpt::byte *header = mod.data() + 20 + smp * 30;
+		header[22] = mpt::byte(samples[smp].lengthWords >> 8);
+		header[23] = mpt::byte(samples[smp].lengthWords & 0xFF);
+		header[25] = mpt::byte(64);
+		// Sample 1 is looped
+		header[26] = mpt::byte(0x03); header[27] = mpt::byte(0xE8);
+		header[28] = mpt::byte(smp == 0 ? 0x13 : 0x00); header[29] = mpt::byte(smp == 0 ? 0x88 : 0x01);
+	}
+	mod[950] = mpt::byte(1);
+	mod[951] = mpt::byte(0x7F);
+	std::memcpy(mod.data() + 1080, "M.K.", 4);
+
+	std::vector<mpt::byte> pattern(64 * 4 * 4, mpt::byte(0));
+	for(uint8 chn = 0; chn < 4; chn++)
+	{
+		const uint16 period = 428;
+		pattern[chn * 4 + 0] = mpt::byte(period >> 8);
+		pattern[chn * 4 + 1] = mpt::byte(period & 0xFF);
+		pattern[chn * 4 + 2] = mpt::byte((chn + 1) << 4);
+	}
+	mod.insert(mod.end(), pattern.begin(), pattern.end());
+
+	for(const auto &sample : samples)
+	{
+		const std::size_t length = sample.lengthWords * 2u;
+		std::vector<mpt::byte> data;
+		if(sample.adpcm)
+		{
+			const int8 table[16] = { 0, 1, 2, 4, 8, 16, 32, 64, -1, -2, -4, -8, -16, -32, -64, -128 };
+			data.resize(5 + 16);
+			std::memcpy(data.data(), "ADPCM", 5);
+			std::memcpy(data.data() + 5, table, 16);
+			for(std::size_t i = 0; i < (length + 1) / 2; i++)
+			{
+				data.push_back(mpt::byte(mpt::random<uint8>(prng)));
+			}
+		} else
+		{
+			for(std::size_t i = 0; i < length; i++)
+			{
+				data.push_back(mpt::byte(mpt::random<uint8>(prng)));
+			}
+		}
+		mod.insert(mod.end(), data.begin(), data.end());
+	}
+	return mod;
+}
+
+
+// Load a module from an unseekable stream, reading all sample data progressively, and compare it to loading the whole file at once.
+static void CompareProgressiveLoading(const std::vector<mpt::byte> &data)
+{
+	CSoundFile reference;
+	VERIFY_EQUAL_NONCONT(reference.Create(FileReader(mpt::as_span(data)), CSoundFile::loadCompleteModule), true);
+
+	UnseekableStreamBuf streamBuf(data);
+	std::istream stream(&streamBuf);
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(make_FileReader(&stream), static_cast<CSoundFile::ModLoadingFlags>(CSoundFile::loadCompleteModule | CSoundFile::deferSampleData)), true);
+	while(sndFile.HasPendingSampleData())
+	{
+		sndFile.ReadPendingSampleData(4096);
+	}
+
+	VERIFY_EQUAL_NONCONT(sndFile.GetNumSamples(), reference.GetNumSamples());
+	for(SAMPLEINDEX smp = 1; smp <= reference.GetNumSamples(); smp++)
+	{
+		const ModSample &expected = reference.GetSample(smp), &actual = sndFile.GetSample(smp);
+		VERIFY_EQUAL_NONCONT(actual.nLength, expected.nLength);
+		VERIFY_EQUAL_NONCONT(actual.nLoopStart, expected.nLoopStart);
+		VERIFY_EQUAL_NONCONT(actual.nLoopEnd, expected.nLoopEnd);
+		VERIFY_EQUAL_NONCONT(actual.uFlags, expected.uFlags);
+		VERIFY_EQUAL_NONCONT(actual.HasSampleData(), expected.HasSampleData());
+		if(actual.HasSampleData() && expected.HasSampleData())
+		{
+			VERIFY_EQUAL_NONCONT(std::memcmp(actual.sampleb(), expected.sampleb(), expected.GetSampleSizeInBytes()), 0);
+		}
+	}
+}
+
+
+static MPT_NOINLINE void TestProgressiveLoading()
+{
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+
+	// Every sample is checked for ADPCM compression individually
+	CompareProgressiveLoading(mod);
+	// Truncated files: Samples beyond the end of the file keep their length, like when loading the whole file at once
+	CompareProgressiveLoading(std::vector<mpt::byte>(mod.begin(), mod.begin() + 1084 + 1024 + 40000 + 5 + 16 + 15000 + 20000));
+	CompareProgressiveLoading(std::vector<mpt::byte>(mod.begin(), mod.begin() + 1084 + 1024 + 30000));
+	CompareProgressiveLoading(std::vector<mpt::byte>(mod.begin(), mod.begin() + 1084 + 1024));
+
+#ifdef LIBOPENMPT_BUILD
+	// Playback starts before the stream has been read completely
+	{
+		UnseekableStreamBuf streamBuf(mod);
+		std::istream stream(&streamBuf);
+		std::ostringstream log;
+		openmpt::module module(stream, log, { { "load.progressive", "1" } });
+		VERIFY_EQUAL_NONCONT(streamBuf.GetServed() < mod.size() / 4, true);
+		std::vector<float> buffer(1024 * 2);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 1024, buffer.data()), 1024u);
+		VERIFY_EQUAL_NONCONT(streamBuf.GetServed() < mod.size(), true);
+
+		// Once all data has arrived, the module sounds the same as when loading it completely
+		while(module.read_interleaved_stereo(44100, 1024, buffer.data()) > 0)
+		{
+		}
+		VERIFY_EQUAL_NONCONT(streamBuf.GetServed(), mod.size());
+		openmpt::module reference(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+		module.set_position_seconds(0.0);
+		std::vector<float> expected(1024 * 2);
+		for(int i = 0; i < 20; i++)
+		{
+			VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 1024, buffer.data()), reference.read_interleaved_stereo(44100, 1024, expected.data()));
+			VERIFY_EQUAL_NONCONT(buffer == expected, true);
+		}
+	}
+#endif // LIBOPENMPT_BUILD
+}
+
+
+#if MPT_TEST_HAS_FILESYSTEM
+static std::vector<char> ReadTestFile(const mpt::PathString &extension)
+{
+	mpt::ifstream f(GetTestFilenameBase() + extension, std::ios::binary);
+	return std::vector<char>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+#endif
+
+
+static MPT_NOINLINE void TestMetadataOnlyLoading()
+{
+#if defined(LIBOPENMPT_BUILD) && MPT_TEST_HAS_FILESYSTEM
+	std::vector<std::vector<char>> files;
+	for(const auto &extension : { P_("mptm"), P_("xm"), P_("s3m") })
+	{
+		files.push_back(ReadTestFile(extension));
+	}
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	files.push_back(std::vector<char>(mpt::byte_cast<const char *>(mod.data()), mpt::byte_cast<const char *>(mod.data() + mod.size())));
+	for(const auto &data : files)
+	{
+		std::ostringstream log;
+		openmpt::module full(data, log);
+		openmpt::module metadata(data, log, { { "load.metadata_only", "1" } });
+
+		// Patterns are created without decoding their contents, so all counts are still known
+		VERIFY_EQUAL_NONCONT(metadata.get_num_patterns(), full.get_num_patterns());
+		VERIFY_EQUAL_NONCONT(metadata.get_num_channels(), full.get_num_channels());
+		for(std::int32_t pat = 0; pat < full.get_num_patterns(); pat++)
+		{
+			VERIFY_EQUAL_NONCONT(metadata.get_pattern_num_rows(pat), full.get_pattern_num_rows(pat));
+		}
+		VERIFY_EQUAL_NONCONT(metadata.get_pattern_names() == full.get_pattern_names(), true);
+		VERIFY_EQUAL_NONCONT(metadata.get_channel_names() == full.get_channel_names(), true);
+
+		// Song length scanning would require the pattern contents
+		bool durationUnavailable = false, subsongsUnavailable = false;
+		try
+		{
+			metadata.get_duration_seconds();
+		} catch(const openmpt::exception &)
+		{
+			durationUnavailable = true;
+		}
+		try
+		{
+			metadata.get_num_subsongs();
+		} catch(const openmpt::exception &)
+		{
+			subsongsUnavailable = true;
+		}
+		VERIFY_EQUAL_NONCONT(durationUnavailable, true);
+		VERIFY_EQUAL_NONCONT(subsongsUnavailable, true);
+
+		VERIFY_EQUAL_NONCONT(metadata.get_metadata_keys() == full.get_metadata_keys(), true);
+		for(const auto &key : full.get_metadata_keys())
+		{
+			if(key == "warnings")
+				continue;
+			VERIFY_EQUAL_NONCONT(metadata.get_metadata(key), full.get_metadata(key));
+		}
+		VERIFY_EQUAL_NONCONT(metadata.get_num_orders(), full.get_num_orders());
+		VERIFY_EQUAL_NONCONT(metadata.get_num_samples(), full.get_num_samples());
+		VERIFY_EQUAL_NONCONT(metadata.get_num_instruments(), full.get_num_instruments());
+		for(std::int32_t ord = 0; ord < full.get_num_orders(); ord++)
+		{
+			VERIFY_EQUAL_NONCONT(metadata.get_order_pattern(ord), full.get_order_pattern(ord));
+		}
+		VERIFY_EQUAL_NONCONT(metadata.get_sample_names() == full.get_sample_names(), true);
+		VERIFY_EQUAL_NONCONT(metadata.get_instrument_names() == full.get_instrument_names(), true);
+	}
+#endif
+}
+
+
+static void CompareProbeSignatures(const std::vector<mpt::byte> &file)
+{
+	// The data pointer passed to Probe must not be null, even for empty data
+	const std::vector<mpt::byte> data = file.empty() ? std::vector<mpt::byte>(1) : file;
+	const std::size_t sizes[] = { 0, 1, 4, 8, 48, 64, 100, 256, 1000, 1084, 1500, CSoundFile::ProbeRecommendedSize - 1, CSoundFile::ProbeRecommendedSize, CSoundFile::ProbeRecommendedSize + 1, file.size() };
+	const CSoundFile::ProbeFlags flags[] = { CSoundFile::ProbeModules, CSoundFile::ProbeContainers, CSoundFile::ProbeFlagsDefault };
+	for(auto size : sizes)
+	{
+		if(size > file.size())
+			continue;
+		const mpt::span<const mpt::byte> span(data.data(), size);
+		const uint64 fileSize = file.size();
+		for(auto flag : flags)
+		{
+			const CSoundFile::ProbeFlags allFormats = static_cast<CSoundFile::ProbeFlags>(flag | CSoundFile::ProbeAllFormats);
+			VERIFY_EQUAL_QUIET_NONCONT(CSoundFile::Probe(flag, span, &fileSize), CSoundFile::Probe(allFormats, span, &fileSize));
+			VERIFY_EQUAL_QUIET_NONCONT(CSoundFile::Probe(flag, span, nullptr), CSoundFile::Probe(allFormats, span, nullptr));
+		}
+	}
+}
+
+
+static MPT_NOINLINE void TestProbeSignatures()
+{
+	// Ruling out formats by their magic bytes must give the same result as invoking all probers
+	std::vector<std::vector<mpt::byte>> files;
+	files.push_back(CreateProgressiveTestMOD());
+#if MPT_TEST_HAS_FILESYSTEM
+	for(const auto &extension : { P_("mptm"), P_("xm"), P_("s3m") })
+	{
+		const std::vector<char> data = ReadTestFile(extension);
+		files.push_back(std::vector<mpt::byte>(mpt::byte_cast<const mpt::byte *>(data.data()), mpt::byte_cast<const mpt::byte *>(data.data() + data.size())));
+	}
+#endif
+	const std::size_t numModules = files.size();
+
+	mpt::default_prng &prng = *s_PRNG;
+	for(std::size_t i = 0; i < 16; i++)
+	{
+		std::vector<mpt::byte> noise(CSoundFile::ProbeRecommendedSize);
+		for(auto &b : noise)
+		{
+			b = mpt::byte_cast<mpt::byte>(mpt::random<uint8>(prng));
+		}
+		files.push_back(noise);
+		// Noise starting with a valid module header
+		const std::vector<mpt::byte> &module = files[i % numModules];
+		std::copy(module.begin(), module.begin() + std::min(module.size(), std::size_t(64)), noise.begin());
+		files.push_back(noise);
+	}
+	for(std::size_t i = 0; i < numModules; i++)
+	{
+		for(std::size_t j = 0; j < 64; j++)
+		{
+			// Damage a single byte in the header area
+			std::vector<mpt::byte> damaged = files[i];
+			const std::size_t offset = mpt::random<uint32>(prng) % std::min(damaged.size(), CSoundFile::ProbeRecommendedSize);
+			damaged[offset] = mpt::byte_cast<mpt::byte>(mpt::random<uint8>(prng));
+			files.push_back(damaged);
+		}
+	}
+
+	for(const auto &file : files)
+	{
+		CompareProbeSignatures(file);
+	}
+}
+
+
+#ifndef NO_PLUGINS
+// Echo plugin that counts the frames it has processed and can pretend to have an infinite tail
+class TestEcho : public DMO::Echo
+{
+public:
+	uint64 m_processedFrames = 0;
+	const bool m_infiniteTail;
+
+	TestEcho(VSTPluginLib &factory, CSoundFile &sndFile, SNDMIXPLUGIN *mixStruct, bool infiniteTail)
+		: Echo(factory, sndFile, mixStruct)
+		, m_infiniteTail(infiniteTail)
+	{ }
+
+	uint32 GetTailSize() const override { return m_infiniteTail ? InfiniteTail : Echo::GetTailSize(); }
+	void Process(float *pOutL, float *pOutR, uint32 numFrames) override
+	{
+		m_processedFrames += numFrames;
+		Echo::Process(pOutL, pOutR, numFrames);
+	}
+};
+
+
+// Put a TestEcho plugin into the given slot
+static TestEcho *CreateTestEcho(CSoundFile &sndFile, PLUGINDEX slot, bool autoSuspend, bool infiniteTail)
+{
+	SNDMIXPLUGIN &plugin = sndFile.m_MixPlugins[slot];
+	plugin.Info.dwPluginId1 = kDmoMagic;
+	plugin.Info.dwPluginId2 = 0xEF3E932C;  // Echo
+	plugin.SetAutoSuspend(autoSuspend);
+	VERIFY_EQUAL_NONCONT(CreateMixPluginProc(plugin, sndFile), true);
+	if(plugin.pMixPlugin == nullptr)
+		return nullptr;
+	VSTPluginLib &factory = plugin.pMixPlugin->GetPluginFactory();
+	plugin.pMixPlugin->Release();
+	TestEcho *echo = new TestEcho(factory, sndFile, &plugin, infiniteTail);
+	echo->SetParameter(1, 0.2f);   // Feedback: 20%
+	echo->SetParameter(2, 0.05f);  // Left delay: 100 ms
+	echo->SetParameter(3, 0.05f);  // Right delay: 100 ms
+	return echo;
+}
+
+
+// Render the generated test MOD with shortened, unlooped samples through an Echo master effect.
+static std::vector<float> RenderThroughEcho(const std::vector<mpt::byte> &mod, bool autoSuspend, bool infiniteTail, uint32 &tailSize, bool &suspended)
+{
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(FileReader(mpt::as_span(mod)), CSoundFile::loadCompleteModule), true);
+	for(SAMPLEINDEX smp = 1; smp <= sndFile.GetNumSamples(); smp++)
+	{
+		ModSample &sample = sndFile.GetSample(smp);
+		sample.nLength = std::min(sample.nLength, SmpLength(4000));
+		sample.uFlags.reset(CHN_LOOP);
+	}
+
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 44100;
+	mixerSettings.gnChannels = 2;
+	sndFile.SetMixerSettings(mixerSettings);
+
+	sndFile.m_MixPlugins[0].SetMasterEffect(true);
+	TestEcho *echo = CreateTestEcho(sndFile, 0, autoSuspend, infiniteTail);
+	if(echo == nullptr)
+		return {};
+
+	Dither dither(mpt::global_prng());
+	std::vector<float> output(44100 * 10 * 2);
+	AudioReadTargetBuffer<audio_buffer_interleaved<float>> target(audio_buffer_interleaved<float>(output.data(), 2, output.size() / 2), dither);
+	// Master effects only see silence if no channels have been mixed since the mix statistics were last reset, which the tracker does periodically.
+	std::size_t rendered = 0;
+	for(;;)
+	{
+		sndFile.ResetMixStat();
+		const std::size_t count = sndFile.Read(static_cast<CSoundFile::samplecount_t>(std::min(std::size_t(1024), output.size() / 2 - rendered)), target);
+		rendered += count;
+		if(count == 0)
+			break;
+	}
+	output.resize(rendered * 2);
+	// The tail size is only known once the plugin has been resumed for playback
+	tailSize = echo->Echo::GetTailSize();
+	suspended = (echo->m_MixState.dwFlags & SNDMIXPLUGINSTATE::psfSilenceBypass) != 0;
+	return output;
+}
+
+
+// Render silence through a plugin that receives its input from another plugin and return how many frames the plugin has processed
+static uint64 RenderSilentChain(bool autoSuspend, bool infiniteTail, uint32 numFrames, uint32 &tailSize)
+{
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(FileReader(mpt::as_span(mod)), CSoundFile::loadCompleteModule), true);
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 44100;
+	mixerSettings.gnChannels = 2;
+	sndFile.SetMixerSettings(mixerSettings);
+
+	// No channel is routed to the first plugin, so the Echo only ever receives silence
+	SNDMIXPLUGIN &source = sndFile.m_MixPlugins[0];
+	source.Info.dwPluginId1 = kDmoMagic;
+	source.Info.dwPluginId2 = 0x120CED89;  // ParamEq
+	source.SetOutputPlugin(1);
+	VERIFY_EQUAL_NONCONT(CreateMixPluginProc(source, sndFile), true);
+	TestEcho *echo = CreateTestEcho(sndFile, 1, autoSuspend, infiniteTail);
+	if(echo == nullptr)
+		return 0;
+
+	std::vector<float> output(numFrames * 2);
+	Dither dither(mpt::global_prng());
+	AudioReadTargetBuffer<audio_buffer_interleaved<float>> target(audio_buffer_interleaved<float>(output.data(), 2, numFrames), dither);
+	VERIFY_EQUAL_NONCONT(sndFile.Read(numFrames, target), numFrames);
+	tailSize = echo->Echo::GetTailSize();
+	return echo->m_processedFrames;
+}
+#endif // NO_PLUGINS
+
+
+static MPT_NOINLINE void TestPluginAutoSuspend()
+{
+#ifndef NO_PLUGINS
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	uint32 tailSize = 0;
+	bool suspended = false;
+	// Plugins without a known tail are never suspended unless auto-suspend is enabled
+	const std::vector<float> reference = RenderThroughEcho(mod, false, true, tailSize, suspended);
+	VERIFY_EQUAL_NONCONT(suspended, false);
+	VERIFY_EQUAL_NONCONT(tailSize > 4410u && tailSize < 44100u, true);
+
+	// Plugins with a finite tail are suspended whether auto-suspend is enabled or not
+	for(bool autoSuspend : { false, true })
+	{
+		const std::vector<float> output = RenderThroughEcho(mod, autoSuspend, false, tailSize, suspended);
+		VERIFY_EQUAL_NONCONT(suspended, true);
+		VERIFY_EQUAL_NONCONT(output.size(), reference.size());
+		VERIFY_EQUAL_NONCONT(output.size() > 44100u * 2u, true);
+		if(output.size() != reference.size())
+			return;
+
+		// Suspending the plugin once its tail has decayed must only remove signal below -120 dB of the peak level
+		float peak = 0.0f, maxDifference = 0.0f;
+		std::size_t firstDifference = reference.size();
+		for(std::size_t i = 0; i < reference.size(); i++)
+		{
+			peak = std::max(peak, std::abs(reference[i]));
+			maxDifference = std::max(maxDifference, std::abs(reference[i] - output[i]));
+			if(reference[i] != output[i] && firstDifference == reference.size())
+				firstDifference = i;
+		}
+		VERIFY_EQUAL_NONCONT(peak > 0.1f, true);
+		VERIFY_EQUAL_NONCONT(maxDifference <= peak * 1e-6f, true);
+		// The plugin has actually been suspended during playback, not only at the end
+		VERIFY_EQUAL_NONCONT(firstDifference > tailSize * 2u && firstDifference < reference.size(), true);
+	}
+
+	// A plugin that only receives silence from another plugin stops being processed once its tail has ended
+	const uint32 numFrames = 44100 * 6;
+	for(bool autoSuspend : { false, true })
+	{
+		const uint64 processed = RenderSilentChain(autoSuspend, false, numFrames, tailSize);
+		VERIFY_EQUAL_NONCONT(processed >= tailSize && processed < tailSize + MIXBUFFERSIZE, true);
+	}
+	// Without a known tail, it is processed all the time unless auto-suspend is enabled
+	VERIFY_EQUAL_NONCONT(RenderSilentChain(false, true, numFrames, tailSize), numFrames);
+#endif // NO_PLUGINS
+}
+
+
+#ifndef NO_REVERB
+
+// Renders noise followed by silence through the built-in reverb and returns the reverb's output
+static std::vector<MixSampleInt> RenderReverb(uint32 sampleRate, bool halfRate, bool floatProcessing)
+{
+	constexpr uint32 chunkSize = MIXBUFFERSIZE, numChunks = 256;
+	auto reverb = std::make_unique<CReverb>();
+	reverb->m_Settings.m_nReverbType = 0;
+	reverb->m_Settings.m_halfRate = halfRate;
+	reverb->m_Settings.m_floatProcessing = floatProcessing;
+	reverb->Initialize(true, sampleRate);
+
+	mpt::fast_prng prng(0x12345678u);
+	std::uniform_int_distribution<int32> noise(-(1 << 24), (1 << 24));
+	std::vector<MixSampleInt> output(chunkSize * numChunks * 2, 0);
+	for(uint32 chunk = 0; chunk < numChunks; chunk++)
+	{
+		if(chunk < numChunks / 4)
+		{
+			MixSampleInt *send = reverb->GetReverbSendBuffer(chunkSize);
+			for(uint32 i = 0; i < chunkSize * 2; i++)
+			{
+				send[i] += noise(prng);
+			}
+		}
+		reverb->Process(output.data() + chunk * chunkSize * 2, chunkSize);
+	}
+	return output;
+}
+
+
+// Ratio between the energy of the difference of both signals and the energy of the reference signal
+static double ReverbDifference(const std::vector<MixSampleInt> &reference, const std::vector<MixSampleInt> &output, std::size_t offset)
+{
+	double referenceEnergy = 0.0, differenceEnergy = 0.0;
+	for(std::size_t i = offset; i < reference.size(); i++)
+	{
+		referenceEnergy += static_cast<double>(reference[i]) * reference[i];
+		differenceEnergy += (static_cast<double>(output[i]) - reference[i]) * (static_cast<double>(output[i]) - reference[i]);
+	}
+	return referenceEnergy > 0.0 ? differenceEnergy / referenceEnergy : 1.0;
+}
+
+#endif // NO_REVERB
+
+
+static MPT_NOINLINE void TestReverbModes()
+{
+#ifndef NO_REVERB
+	for(uint32 sampleRate : { 44100u, 96000u })
+	{
+		for(bool halfRate : { false, true })
+		{
+			const std::vector<MixSampleInt> fixedPoint = RenderReverb(sampleRate, halfRate, false);
+			const std::vector<MixSampleInt> floatingPoint = RenderReverb(sampleRate, halfRate, true);
+			// Both implementations produce the same reverb, up to the rounding and saturation of the fixed-point code
+			VERIFY_EQUAL_NONCONT(ReverbDifference(fixedPoint, floatingPoint, 0) < 0.0001, true);
+			// ...including the tail after the input has stopped
+			const std::size_t tailStart = fixedPoint.size() / 4 + MIXBUFFERSIZE * 2;
+			VERIFY_EQUAL_NONCONT(ReverbDifference(fixedPoint, floatingPoint, tailStart) < 0.01, true);
+			VERIFY_EQUAL_NONCONT(std::any_of(floatingPoint.begin() + tailStart, floatingPoint.end(), [](MixSampleInt s) { return s != 0; }), true);
+		}
+	}
+
+#ifdef LIBOPENMPT_BUILD
+	{
+		const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+		std::ostringstream log;
+		openmpt::module module(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+		const std::vector<std::string> ctls = module.get_ctls();
+		VERIFY_EQUAL_NONCONT(std::count(ctls.begin(), ctls.end(), "render.reverb.half_rate"), 1);
+		VERIFY_EQUAL_NONCONT(std::count(ctls.begin(), ctls.end(), "render.reverb.float"), 1);
+		VERIFY_EQUAL_NONCONT(module.ctl_get("render.reverb.half_rate"), "0");
+		VERIFY_EQUAL_NONCONT(module.ctl_get("render.reverb.float"), "0");
+		module.ctl_set("render.reverb.half_rate", "1");
+		module.ctl_set("render.reverb.float", "1");
+		VERIFY_EQUAL_NONCONT(module.ctl_get("render.reverb.half_rate"), "1");
+		VERIFY_EQUAL_NONCONT(module.ctl_get("render.reverb.float"), "1");
+		std::vector<float> buffer(1024 * 2);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 1024, buffer.data()), 1024u);
+	}
+#endif // LIBOPENMPT_BUILD
+#endif // NO_REVERB
+}
+
+
+static MPT_NOINLINE void TestMixerLoops()
+{
+	// Lengths around the vector sizes exercise the remainder loops of the SIMD implementations
+	for(uint32 count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 15u, 17u, 63u, uint32(MIXBUFFERSIZE) })
+	{
+		std::vector<int32> mix(count * 2);
+		for(auto &s : mix)
+		{
+			// Values which can be converted to float and back without loss of precision
+			s = static_cast<int32>(mpt::random<uint32>(*s_PRNG) >> 8) - (1 << 23);
+		}
+		std::vector<float> left(count), right(count);
+		StereoMixToFloat(mix.data(), left.data(), right.data(), count, 1.0f / MIXING_SCALEF);
+		bool toFloatOK = true;
+		for(uint32 i = 0; i < count; i++)
+		{
+			toFloatOK &= (left[i] == mix[i * 2] * (1.0f / MIXING_SCALEF)) && (right[i] == mix[i * 2 + 1] * (1.0f / MIXING_SCALEF));
+		}
+		VERIFY_EQUAL_NONCONT(toFloatOK, true);
+
+		std::vector<int32> converted(count * 2);
+		FloatToStereoMix(left.data(), right.data(), converted.data(), count, MIXING_SCALEF);
+		VERIFY_EQUAL_NONCONT(converted == mix, true);
+
+#ifdef MPT_INTMIXER
+		std::vector<int32> mono = mix;
+		MonoFromStereo(mono.data(), count);
+		bool monoOK = true;
+		for(uint32 i = 0; i < count; i++)
+		{
+			const int32 sum = mix[i * 2] + mix[i * 2 + 1];
+#ifdef ENABLE_X86
+			// The inline assembly has always rounded down
+			monoOK &= (mono[i] == mpt::rshift_signed(sum, 1));
+#else
+			monoOK &= (mono[i] == sum / 2);
+#endif
+		}
+		VERIFY_EQUAL_NONCONT(monoOK, true);
+#endif // MPT_INTMIXER
+	}
+}
+
+
+static MPT_NOINLINE void TestReadAdd()
+{
+#ifdef LIBOPENMPT_BUILD
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	std::ostringstream log;
+	for(std::size_t channels : { 2, 4 })
+	{
+		openmpt::module reference(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+		openmpt::module module(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+		constexpr std::size_t frames = 1000;
+		constexpr float gain = 0.375f;
+		std::vector<float> expected(frames * channels), buffer(frames * channels);
+		for(int chunk = 0; chunk < 20; chunk++)
+		{
+			// The rendered audio is added to what is already in the buffer...
+			for(std::size_t i = 0; i < buffer.size(); i++)
+			{
+				buffer[i] = static_cast<float>(static_cast<int>((chunk * 7 + i) % 13) - 6) * 0.125f;
+			}
+			const std::vector<float> existing = buffer;
+			std::size_t count, countAdd;
+			if(channels == 2)
+			{
+				count = reference.read_interleaved_stereo(44100, frames, expected.data());
+				countAdd = module.read_interleaved_stereo_add(44100, frames, buffer.data(), gain);
+			} else
+			{
+				count = reference.read_interleaved_quad(44100, frames, expected.data());
+				countAdd = module.read_interleaved_quad_add(44100, frames, buffer.data(), gain);
+			}
+			VERIFY_EQUAL_NONCONT(countAdd, count);
+			// ...scaled by the given gain
+			float maxError = 0.0f, maxRendered = 0.0f;
+			for(std::size_t i = 0; i < count * channels; i++)
+			{
+				maxError = std::max(maxError, std::abs(buffer[i] - (existing[i] + expected[i] * gain)));
+				maxRendered = std::max(maxRendered, std::abs(expected[i]));
+			}
+			VERIFY_EQUAL_NONCONT(maxError < 1e-6f, true);
+			if(chunk > 0)
+			{
+				VERIFY_EQUAL_NONCONT(maxRendered > 0.0f, true);
+			}
+			// Frames beyond the returned count are not touched
+			VERIFY_EQUAL_NONCONT(std::equal(buffer.begin() + count * channels, buffer.end(), existing.begin() + count * channels), true);
+		}
+	}
+#endif // LIBOPENMPT_BUILD
+}
+
+
+
+#ifdef LIBOPENMPT_BUILD
+// Gives the test access to the CSoundFile behind a module, so that it can set up cases that cannot be loaded from a file.
+class TestModuleImpl : public openmpt::module_ext_impl
+{
+public:
+	TestModuleImpl(const std::vector<char> &data, std::ostream &log, const std::map<std::string, std::string> &ctls = std::map<std::string, std::string>())
+		: openmpt::module_ext_impl(data, std::make_unique<openmpt::std_ostream_log>(log), ctls)
+	{ }
+	CSoundFile &GetSoundFile() { return *m_sndFile; }
+};
+#endif // LIBOPENMPT_BUILD
+
+
+#if defined(LIBOPENMPT_BUILD) && MPT_TEST_HAS_FILESYSTEM
+
+
+// Every cell of format_pattern_window must match the per-cell getters.
+static void VerifyPatternWindow(const openmpt::module_impl &module)
+{
+	const int32 numChannels = module.get_num_channels();
+	// Also query two nonexistent patterns
+	for(int32 pat = -1; pat <= module.get_num_patterns(); pat++)
+	{
+		const int32 numRows = module.get_pattern_num_rows(pat);
+		const bool validPattern = numRows > 0;
+
+		// The window reaches beyond all four edges of the pattern
+		const int32 firstRow = -2, rows = numRows + 4;
+		const int32 firstChannel = -1, channels = numChannels + 2;
+		for(std::size_t width : { 0, 1, 3, 4, 6, 8, 9, 12, 13, 20 })
+		{
+			const std::size_t cellWidth = width ? width : 13;
+			std::vector<char> text(rows * channels * cellWidth, 'x'), high(rows * channels * cellWidth, 'x');
+			module.format_pattern_window(pat, firstRow, rows, firstChannel, channels, width, text.data(), high.data());
+			bool textOK = true, highOK = true;
+			for(int32 y = 0; y < rows; y++)
+			{
+				for(int32 x = 0; x < channels; x++)
+				{
+					const int32 row = firstRow + y, chn = firstChannel + x;
+					const std::size_t offset = (y * channels + x) * cellWidth;
+					const std::string cellText(text.data() + offset, cellWidth), cellHigh(high.data() + offset, cellWidth);
+					if(validPattern && row >= 0 && row < numRows && chn >= 0 && chn < numChannels)
+					{
+						textOK &= (cellText == module.format_pattern_row_channel(pat, row, chn, cellWidth, true));
+						highOK &= (cellHigh == module.highlight_pattern_row_channel(pat, row, chn, cellWidth, true));
+					} else
+					{
+						textOK &= (cellText == std::string(cellWidth, ' '));
+						highOK &= (cellHigh == std::string(cellWidth, ' '));
+					}
+				}
+			}
+			VERIFY_EQUAL_NONCONT(textOK, true);
+			VERIFY_EQUAL_NONCONT(highOK, true);
+		}
+
+		// Text only
+		if(validPattern)
+		{
+			std::vector<char> text(numRows * numChannels * 13);
+			module.format_pattern_window(pat, 0, numRows, 0, numChannels, 0, text.data(), nullptr);
+			VERIFY_EQUAL_NONCONT(std::string(text.data(), 13), module.format_pattern_row_channel(pat, 0, 0, 13, true));
+		}
+	}
+}
+
+
+// get_pattern_data must match get_pattern_row_channel_command for every cell and only write complete rows.
+static void VerifyPatternData(const openmpt::module_impl &module)
+{
+	const int32 numChannels = module.get_num_channels();
+	// Also query two nonexistent patterns
+	for(int32 pat = -1; pat <= module.get_num_patterns(); pat++)
+	{
+		const int32 numRows = module.get_pattern_num_rows(pat);
+		std::vector<uint8> data(std::max(numRows, int32(1)) * numChannels * 6 + 1, 0xCC);
+		VERIFY_EQUAL_NONCONT(module.get_pattern_data(pat, data.data(), data.size()), numRows);
+		bool dataOK = true;
+		for(int32 row = 0; row < numRows; row++)
+		{
+			for(int32 chn = 0; chn < numChannels; chn++)
+			{
+				for(int cmd = 0; cmd < 6; cmd++)
+				{
+					dataOK &= (data[(row * numChannels + chn) * 6 + cmd] == module.get_pattern_row_channel_command(pat, row, chn, cmd));
+				}
+			}
+		}
+		VERIFY_EQUAL_NONCONT(dataOK, true);
+		// Only complete rows are written
+		VERIFY_EQUAL_NONCONT(data.back(), 0xCC);
+		if(numRows > 2)
+		{
+			std::fill(data.begin(), data.end(), 0xCC);
+			VERIFY_EQUAL_NONCONT(module.get_pattern_data(pat, data.data(), numChannels * 6 * 2 + 5), 2);
+			VERIFY_EQUAL_NONCONT(data[numChannels * 6 * 2], 0xCC);
+		}
+	}
+}
+
+#endif // LIBOPENMPT_BUILD && MPT_TEST_HAS_FILESYSTEM
+
+
+static MPT_NOINLINE void TestPatternWindow()
+{
+#if defined(LIBOPENMPT_BUILD) && MPT_TEST_HAS_FILESYSTEM
+	for(const auto &extension : { P_("mptm"), P_("xm"), P_("s3m") })
+	{
+		std::ostringstream log;
+		TestModuleImpl module(ReadTestFile(extension), log);
+		VerifyPatternWindow(module);
+	}
+
+	// Note names of custom tunings take the generic formatting code path
+	{
+		std::ostringstream log;
+		TestModuleImpl module(ReadTestFile(P_("mptm")), log);
+		CSoundFile &sndFile = module.GetSoundFile();
+		VERIFY_EQUAL_NONCONT(sndFile.GetNumInstruments() >= 1, true);
+		VERIFY_EQUAL_NONCONT(sndFile.Patterns.IsValidPat(0), true);
+		if(sndFile.GetNumInstruments() >= 1 && sndFile.Instruments[1] != nullptr && sndFile.Patterns.IsValidPat(0) && sndFile.Patterns[0].GetNumRows() >= 4)
+		{
+			CTuning *tuning = CTuning::CreateGeometric("Test", 12, 2, 15);
+			tuning->SetNoteName(0, "Sa");
+			tuning->SetNoteName(1, "Komal Re");
+			sndFile.GetTuneSpecificTunings().AddTuning(tuning);
+			sndFile.Instruments[1]->pTuning = tuning;
+
+			ModCommand *m = sndFile.Patterns[0].GetpModCommand(0, 0);
+			m->note = NOTE_MIDDLEC;
+			m->instr = 1;
+			m = sndFile.Patterns[0].GetpModCommand(1, 0);
+			m->note = NOTE_MIDDLEC + 1;
+			m->instr = 1;
+			m->volcmd = VOLCMD_VOLUME;
+			m->vol = 32;
+			m->command = CMD_OFFSET;
+			m->param = 0x10;
+			m = sndFile.Patterns[0].GetpModCommand(2, 0);
+			m->note = NOTE_NOTECUT;
+			m->instr = 1;
+			m = sndFile.Patterns[0].GetpModCommand(3, 0);
+			m->note = NOTE_PC;
+			m->instr = 1;
+			m->SetValueVolCol(0x123);
+			m->SetValueEffectCol(0x456);
+
+			// Make sure that the test actually exercises names that do not fit the fixed-width note column
+			VERIFY_EQUAL_NONCONT(module.format_pattern_row_channel(0, 1, 0, 0, false).substr(0, 9), "Komal Re5");
+			VerifyPatternWindow(module);
+		}
+	}
+#endif // LIBOPENMPT_BUILD && MPT_TEST_HAS_FILESYSTEM
+}
+
+
+static MPT_NOINLINE void TestPatternData()
+{
+#if defined(LIBOPENMPT_BUILD) && MPT_TEST_HAS_FILESYSTEM
+	for(const auto &extension : { P_("mptm"), P_("xm"), P_("s3m") })
+	{
+		std::ostringstream log;
+		TestModuleImpl module(ReadTestFile(extension), log);
+		VerifyPatternData(module);
+	}
+#endif // LIBOPENMPT_BUILD && MPT_TEST_HAS_FILESYSTEM
+}
+
+
+static MPT_NOINLINE void TestStems()
+{
+#ifdef LIBOPENMPT_BUILD
+	// Without plugins, OPL instruments, reverb and background voices, the stems must sum up to the regular output
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	std::ostringstream log;
+	openmpt::module reference(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+	openmpt::module module(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+	const std::size_t numStems = static_cast<std::size_t>(module.get_num_channels());
+	VERIFY_EQUAL_NONCONT(numStems, 4u);
+
+	constexpr std::size_t chunkSize = 1000;
+	std::vector<float> expected(chunkSize * 2);
+	std::vector<std::vector<float>> stems(numStems, std::vector<float>(chunkSize * 2));
+	std::vector<float *> stemPointers(numStems);
+	for(std::size_t stem = 0; stem < numStems; stem++)
+	{
+		stemPointers[stem] = stems[stem].data();
+	}
+
+	std::size_t totalFrames = 0;
+	float maxDiff = 0.0f, maxLevel = 0.0f;
+	bool countsEqual = true;
+	for(;;)
+	{
+		const std::size_t expectedCount = reference.read_interleaved_stereo(44100, chunkSize, expected.data());
+		const std::size_t count = module.read_stems_interleaved_stereo(44100, chunkSize, stemPointers.data());
+		countsEqual &= (count == expectedCount);
+		if(count == 0 || count != expectedCount)
+			break;
+		for(std::size_t i = 0; i < count * 2; i++)
+		{
+			float sum = 0.0f;
+			for(const auto &stem : stems)
+			{
+				sum += stem[i];
+			}
+			maxDiff = std::max(maxDiff, std::abs(sum - expected[i]));
+			maxLevel = std::max(maxLevel, std::abs(expected[i]));
+		}
+		totalFrames += count;
+	}
+	VERIFY_EQUAL_NONCONT(countsEqual, true);
+	VERIFY_EQUAL_NONCONT(totalFrames > 44100, true);
+	VERIFY_EQUAL_NONCONT(maxLevel > 0.01f, true);
+	VERIFY_EQUAL_NONCONT(maxDiff < 1e-5f, true);
+#endif // LIBOPENMPT_BUILD
+}
+
+
+#ifdef LIBOPENMPT_BUILD
+// Renders until the end of the song and returns the number of rendered frames
+static std::size_t RenderToEnd(openmpt::module &module, int32 sampleRate)
+{
+	std::vector<float> buffer(1024 * 2);
+	std::size_t total = 0;
+	while(std::size_t count = module.read_interleaved_stereo(sampleRate, 1024, buffer.data()))
+	{
+		total += count;
+	}
+	return total;
+}
+#endif // LIBOPENMPT_BUILD
+
+
+static MPT_NOINLINE void TestMixSampleRate()
+{
+#ifdef LIBOPENMPT_BUILD
+	// The resampler must neither drop the frames it holds back as filter look-ahead nor play stale frames after seeking
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	std::ostringstream log;
+	openmpt::module reference(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+	const std::size_t expectedFrames = RenderToEnd(reference, 44100);
+	VERIFY_EQUAL_NONCONT(expectedFrames > 44100, true);
+
+	// Only 0 (off) and rates from 8000 to 192000 Hz are accepted
+	for(const char *mixRate : { "-1", "1", "7999", "192001" })
+	{
+		bool rejected = false;
+		try
+		{
+			reference.ctl_set("render.mix_samplerate", mixRate);
+		} catch(const openmpt::exception &)
+		{
+			rejected = true;
+		}
+		VERIFY_EQUAL_NONCONT(rejected, true);
+	}
+	for(const char *mixRate : { "8000", "192000", "0" })
+	{
+		reference.ctl_set("render.mix_samplerate", mixRate);
+		VERIFY_EQUAL_NONCONT(reference.ctl_get("render.mix_samplerate"), std::string(mixRate));
+	}
+
+	for(const char *mixRate : { "22050", "48000" })
+	{
+		std::vector<float> buffer(10000 * 2);
+
+		// Whole song
+		openmpt::module module(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log, { { "render.mix_samplerate", mixRate } });
+		std::size_t frames = RenderToEnd(module, 44100);
+		VERIFY_EQUAL_NONCONT(frames + 2 >= expectedFrames && frames <= expectedFrames + 2, true);
+
+		// Seeking back to the start after rendering some audio
+		module.set_position_seconds(0.0);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 10000, buffer.data()), 10000u);
+		module.set_position_seconds(0.0);
+		frames = RenderToEnd(module, 44100);
+		VERIFY_EQUAL_NONCONT(frames + 2 >= expectedFrames && frames <= expectedFrames + 2, true);
+
+		module.set_position_order_row(0, 0);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 10000, buffer.data()), 10000u);
+		module.set_position_order_row(0, 0);
+		frames = RenderToEnd(module, 44100);
+		VERIFY_EQUAL_NONCONT(frames + 2 >= expectedFrames && frames <= expectedFrames + 2, true);
+
+		// Switching back to mixing at the output rate keeps the frames that have already been mixed
+		module.set_position_seconds(0.0);
+		frames = module.read_interleaved_stereo(44100, 10000, buffer.data());
+		module.ctl_set("render.mix_samplerate", "0");
+		frames += RenderToEnd(module, 44100);
+		VERIFY_EQUAL_NONCONT(frames + 2 >= expectedFrames && frames <= expectedFrames + 2, true);
+	}
+#endif // LIBOPENMPT_BUILD
+}
+
+
+static MPT_NOINLINE void TestRestorePlaybackState()
+{
+#ifdef LIBOPENMPT_BUILD
+	// Rendering after restoring a state must give the same result as rendering after saving it
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	const std::vector<char> data(mpt::byte_cast<const char *>(mod.data()), mpt::byte_cast<const char *>(mod.data() + mod.size()));
+	std::ostringstream log;
+	constexpr std::size_t numFrames = 20000;
+	std::vector<float> first(numFrames * 2), second(numFrames * 2);
+
+	// Saved before anything has been rendered: Reverb and the mix rate resampler must not carry over what was rendered in between
+	for(const char *mixRate : { "0", "22050" })
+	{
+		TestModuleImpl module(data, log, { { "render.mix_samplerate", mixRate } });
+#ifndef NO_REVERB
+		MixerSettings mixerSettings = module.GetSoundFile().m_MixerSettings;
+		mixerSettings.DSPMask |= SNDDSP_REVERB;
+		module.GetSoundFile().SetMixerSettings(mixerSettings);
+#endif // NO_REVERB
+		const int32 state = module.save_playback_state();
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, numFrames, first.data()), numFrames);
+		module.restore_playback_state(state);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, numFrames, second.data()), numFrames);
+		VERIFY_EQUAL_NONCONT(first == second, true);
+		VERIFY_EQUAL_NONCONT(std::count(first.begin(), first.end(), 0.0f) < static_cast<std::ptrdiff_t>(numFrames), true);
+		module.free_playback_state(state);
+	}
+
+	// Saved in the middle of the song, with voices playing
+	{
+		TestModuleImpl module(data, log);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 12345, first.data()), 12345u);
+		const int32 state = module.save_playback_state();
+		const double position = module.get_position_seconds();
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, numFrames, first.data()), numFrames);
+		module.restore_playback_state(state);
+		VERIFY_EQUAL_NONCONT(module.get_position_seconds(), position);
+		VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, numFrames, second.data()), numFrames);
+		VERIFY_EQUAL_NONCONT(first == second, true);
+		module.free_playback_state(state);
+	}
+#endif // LIBOPENMPT_BUILD
+}
+
+
+static MPT_NOINLINE void TestRenderPool()
+{
+#ifdef LIBOPENMPT_BUILD
+	// Rendering through the pool must give exactly the same audio as rendering directly, no matter which worker renders which block
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	std::ostringstream log;
+	const int32 sampleRates[] = { 44100, 48000, 22050, 96000 };
+	const std::size_t numStreams = mpt::size(sampleRates);
+
+	std::vector<std::vector<float>> expected(numStreams);
+	for(std::size_t i = 0; i < numStreams; i++)
+	{
+		openmpt::module module(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log);
+		std::vector<float> buffer(1000 * 2);
+		while(std::size_t count = module.read_interleaved_stereo(sampleRates[i], 1000, buffer.data()))
+		{
+			expected[i].insert(expected[i].end(), buffer.begin(), buffer.begin() + count * 2);
+		}
+		VERIFY_EQUAL_NONCONT(expected[i].size() > static_cast<std::size_t>(sampleRates[i]) * 2, true);
+	}
+
+	for(int32 numThreads : { 1, 3 })
+	{
+		std::vector<std::unique_ptr<openmpt::module>> modules;
+		std::vector<std::vector<float>> actual(numStreams);
+		std::vector<int32> streams;
+		openmpt::render_pool pool(numThreads);
+		for(std::size_t i = 0; i < numStreams; i++)
+		{
+			modules.push_back(std::make_unique<openmpt::module>(mpt::byte_cast<const std::uint8_t *>(mod.data()), mod.size(), log));
+			// Odd buffer and block sizes so that blocks wrap around the end of the ring buffer
+			streams.push_back(pool.add_module(*modules.back(), sampleRates[i], 3000 + i * 700, 512 + i * 100));
+		}
+
+		std::vector<float> buffer(777 * 2);
+		bool ended = false;
+		while(!ended)
+		{
+			ended = true;
+			for(std::size_t i = 0; i < numStreams; i++)
+			{
+				if(pool.get_statistics(streams[i]).ended)
+				{
+					continue;
+				}
+				ended = false;
+				const std::size_t count = pool.read_interleaved_stereo(streams[i], 777, buffer.data());
+				actual[i].insert(actual[i].end(), buffer.begin(), buffer.begin() + count * 2);
+				VERIFY_EQUAL_NONCONT(actual[i].size() <= expected[i].size(), true);
+			}
+		}
+
+		for(std::size_t i = 0; i < numStreams; i++)
+		{
+			const openmpt::render_pool::stream_statistics stats = pool.get_statistics(streams[i]);
+			VERIFY_EQUAL_NONCONT(stats.frames_rendered, expected[i].size() / 2);
+			VERIFY_EQUAL_NONCONT(stats.frames_buffered, 0u);
+			VERIFY_EQUAL_NONCONT(actual[i] == expected[i], true);
+			pool.remove_module(streams[i]);
+		}
+	}
+#endif // LIBOPENMPT_BUILD
+}
+
+
+#ifdef LIBOPENMPT_BUILD
+// Replaces the data of a sample with the given 16-bit mono data and updates everything that depends on it, like a sample editor would
+static void SetSampleData16(CSoundFile &sndFile, SAMPLEINDEX smp, const std::vector<int16> &data)
+{
+	ModSample &sample = sndFile.GetSample(smp);
+	sample.FreeSample();
+	sample.uFlags.reset(CHN_STEREO | CHN_LOOP | CHN_SUSTAINLOOP);
+	sample.uFlags.set(CHN_16BIT);
+	sample.nLength = static_cast<SmpLength>(data.size());
+	sample.AllocateSample();
+	std::copy(data.begin(), data.end(), sample.sample16());
+	sample.PrecomputeLoops(sndFile, false);
+}
+#endif // LIBOPENMPT_BUILD
+
+
+static MPT_NOINLINE void TestSamplePyramids()
+{
+#ifdef LIBOPENMPT_BUILD
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	const std::vector<char> data(mpt::byte_cast<const char *>(mod.data()), mpt::byte_cast<const char *>(mod.data() + mod.size()));
+	std::ostringstream log;
+
+	// Decimated copies are built when they are enabled and freed when they are disabled, never by the mixer
+	{
+		TestModuleImpl module(data, log);
+		CSoundFile &sndFile = module.GetSoundFile();
+		std::vector<float> buffer(1000 * 2);
+		module.read_interleaved_stereo(44100, 1000, buffer.data());
+		VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sndFile.GetSample(1)) == nullptr, true);
+		module.ctl_set("render.resampler.sample_pyramids", "1");
+		for(SAMPLEINDEX smp = 1; smp <= sndFile.GetNumSamples(); smp++)
+		{
+			VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sndFile.GetSample(smp)) != nullptr, sndFile.GetSample(smp).HasSampleData());
+		}
+		module.ctl_set("render.resampler.sample_pyramids", "0");
+		VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sndFile.GetSample(1)) == nullptr, true);
+
+		// Enabled before loading
+		TestModuleImpl enabledModule(data, log, { { "render.resampler.sample_pyramids", "1" } });
+		VERIFY_EQUAL_NONCONT(enabledModule.GetSoundFile().GetSamplePyramid(enabledModule.GetSoundFile().GetSample(1)) != nullptr, true);
+	}
+
+	TestModuleImpl module(data, log, { { "render.resampler.sample_pyramids", "1" } });
+	CSoundFile &sndFile = module.GetSoundFile();
+	const ModSample &sample = sndFile.GetSample(1);
+	const auto level1 = [&]()
+	{
+		const SamplePyramid *pyramid = sndFile.GetSamplePyramid(sample);
+		VERIFY_EQUAL_NONCONT(pyramid != nullptr, true);
+		return static_cast<const int16 *>(pyramid->GetLevel(1));
+	};
+
+	// Full-scale DC passes through all levels unchanged
+	SetSampleData16(sndFile, 1, std::vector<int16>(256, 32767));
+	for(int level = 1; level <= SamplePyramid::numLevels; level++)
+	{
+		const int16 *decimated = static_cast<const int16 *>(sndFile.GetSamplePyramid(sample)->GetLevel(level));
+		for(SmpLength i = 0; i < (256u >> level); i++)
+		{
+			VERIFY_EQUAL_NONCONT(std::abs(decimated[i] - 32767) <= 1, true);
+		}
+	}
+
+	// A signal at half the sampling rate is removed
+	std::vector<int16> nyquist(256);
+	for(std::size_t i = 0; i < nyquist.size(); i++)
+	{
+		nyquist[i] = (i % 2) ? -16384 : 16384;
+	}
+	SetSampleData16(sndFile, 1, nyquist);
+	for(SmpLength i = SamplePyramid::filterHalfLength; i < 128 - SamplePyramid::filterHalfLength; i++)
+	{
+		VERIFY_EQUAL_NONCONT(std::abs(level1()[i]) <= 16, true);
+	}
+
+	// Full-scale input with the signs of the filter coefficients is the worst case for the accumulator and must clip instead of wrapping around
+	std::vector<int16> worstCase(64, 0);
+	double kernel[SamplePyramid::filterHalfLength + 1];
+	for(int i = 0; i <= SamplePyramid::filterHalfLength; i++)
+	{
+		const double x = M_PI * i / (SamplePyramid::filterHalfLength + 1);
+		kernel[i] = (i == 0) ? 0.5 : (0.42 + 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x)) * std::sin(M_PI * i / 2.0) / (M_PI * i);
+	}
+	worstCase[32] = 32767;
+	for(int i = 1; i <= SamplePyramid::filterHalfLength; i += 2)
+	{
+		worstCase[32 - i] = worstCase[32 + i] = (kernel[i] < 0.0) ? -32768 : 32767;
+	}
+	SetSampleData16(sndFile, 1, worstCase);
+	VERIFY_EQUAL_NONCONT(level1()[16], 32767);
+	for(auto &s : worstCase)
+	{
+		s = (s == 32767) ? -32768 : ((s == -32768) ? 32767 : s);
+	}
+	SetSampleData16(sndFile, 1, worstCase);
+	VERIFY_EQUAL_NONCONT(level1()[16], -32768);
+
+	// Modifying the data in place keeps the pointer and length, so only the generation counter tells that the decimated copies are out of date
+	const SamplePyramid *pyramid = sndFile.GetSamplePyramid(sample);
+	VERIFY_EQUAL_NONCONT(pyramid != nullptr, true);
+	const uint32 generation = pyramid->generation;
+	std::fill(sndFile.GetSample(1).sample16(), sndFile.GetSample(1).sample16() + sample.nLength, int16(1000));
+	sndFile.GetSample(1).PrecomputeLoops(sndFile, false);
+	VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sample) != nullptr, true);
+	VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sample)->generation, generation + 1);
+	VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sample)->source, sample.samplev());
+	VERIFY_EQUAL_NONCONT(std::abs(level1()[16] - 1000) <= 1, true);
+	sndFile.GetSample(1).sample16()[0] = 0;
+	sndFile.InvalidateSamplePyramid(sample);
+	VERIFY_EQUAL_NONCONT(sndFile.GetSamplePyramid(sample)->generation, generation + 2);
+	VERIFY_EQUAL_NONCONT(level1()[0] < 1000, true);
+
+	// Rendering high-pitched notes from the decimated copies
+	std::vector<float> buffer(1000 * 2);
+	module.ctl_set("play.pitch_factor", "4");
+	module.set_position_seconds(0.0);
+	VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, 1000, buffer.data()), 1000u);
+#endif // LIBOPENMPT_BUILD
+}
+
+
+// Returns the number of leading silent frames of interleaved stereo data
+static std::size_t CountSilentFrames(const std::vector<int32> &buffer)
+{
+	std::size_t frame = 0;
+	while(frame < buffer.size() / 2 && buffer[frame * 2] == 0 && buffer[frame * 2 + 1] == 0)
+		frame++;
+	return frame;
+}
+
+
+class TestOPL : public OPL
+{
+public:
+	// True if no emulator output is buffered, i.e. the next output frame only depends on what the emulator renders from now on
+	bool IsResamplerReset() const
+	{
+		return m_srcPosition == (static_cast<uint64>(SRC_TAPS / 2 - 1) << 32)
+			&& m_nativeBuffer.size() == (SRC_TAPS - 1) * 2
+			&& std::count(m_nativeBuffer.begin(), m_nativeBuffer.end(), int16(0)) == static_cast<std::ptrdiff_t>(m_nativeBuffer.size());
+	}
+};
+
+
+static MPT_NOINLINE void TestOPLResampler()
+{
+	// Register writes must take effect with the same latency on every tick, and resetting must discard emulator output that has not been played yet
+	const OPLPatch patch{ { 0x21, 0x21, 0x00, 0x00, 0xF0, 0xF0, 0x00, 0x00, 0x00, 0x00, OPL::VOICE_TO_LEFT | OPL::VOICE_TO_RIGHT | OPL::CONNECTION_BIT, 0x00 } };
+	constexpr std::size_t numFrames = 1000;
+	std::vector<int32> buffer(numFrames * 2);
+
+	for(uint32 sampleRate : { 44100u, 48000u, 49716u, 96000u })
+	{
+		// Note triggered before anything has been rendered
+		TestOPL opl;
+		opl.Initialize(sampleRate);
+		VERIFY_EQUAL_NONCONT(opl.IsResamplerReset(), true);
+		opl.Patch(0, patch);
+		opl.Frequency(0, 440000, false, false);
+		std::fill(buffer.begin(), buffer.end(), 0);
+		opl.Mix(buffer.data(), numFrames, 1 << 16);
+		const std::size_t firstLatency = CountSilentFrames(buffer);
+		VERIFY_EQUAL_NONCONT(firstLatency < numFrames, true);
+
+		// Note triggered after rendering silence for a while
+		TestOPL laterOPL;
+		laterOPL.Initialize(sampleRate);
+		laterOPL.Patch(1, patch);
+		laterOPL.Frequency(1, 440000, true, false);
+		std::fill(buffer.begin(), buffer.end(), 0);
+		laterOPL.Mix(buffer.data(), numFrames, 1 << 16);
+		VERIFY_EQUAL_NONCONT(CountSilentFrames(buffer), numFrames);
+		laterOPL.Patch(0, patch);
+		laterOPL.Frequency(0, 440000, false, false);
+		std::fill(buffer.begin(), buffer.end(), 0);
+		laterOPL.Mix(buffer.data(), numFrames, 1 << 16);
+		const std::size_t laterLatency = CountSilentFrames(buffer);
+		VERIFY_EQUAL_NONCONT(laterLatency + 2 >= firstLatency && laterLatency <= firstLatency + 2, true);
+
+		// Resetting and changing the sample rate discard buffered emulator output
+		opl.Reset();
+		VERIFY_EQUAL_NONCONT(opl.IsResamplerReset(), true);
+		laterOPL.Initialize(sampleRate == 48000 ? 44100 : 48000);
+		VERIFY_EQUAL_NONCONT(laterOPL.IsResamplerReset(), true);
+	}
+}
+
+#ifndef NO_PLUGINS
+// Render the generated test MOD through several plugin chains and a master effect, using the given number of plugin worker threads.
+// Halfway through, two of the chains are merged into one.
+static std::vector<float> RenderThroughPluginChains(const std::vector<mpt::byte> &mod, uint32 numThreads, std::vector<std::vector<PLUGINDEX>> &chains)
+{
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(FileReader(mpt::as_span(mod)), CSoundFile::loadCompleteModule), true);
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 44100;
+	mixerSettings.gnChannels = 2;
+	sndFile.SetMixerSettings(mixerSettings);
+	sndFile.SetNumPluginThreads(numThreads);
+	VERIFY_EQUAL_NONCONT(sndFile.GetNumPluginThreads(), numThreads);
+
+	// Channel 1 -> Echo -> Chorus, channel 2 -> I3DL2Reverb, channel 3 -> Distortion -> ParamEq, channel 4 -> master.
+	// The Compressor is a master effect and the WavesReverb does not receive any input.
+	const struct { uint32 id; PLUGINDEX output; bool master; } setup[] =
+	{
+		{ 0xEF3E932C, 2, false },
+		{ 0xEF985E71, PLUGINDEX_INVALID, false },
+		{ 0xEFE6629C, PLUGINDEX_INVALID, false },
+		{ 0xEF114C90, 5, false },
+		{ 0xEF011F79, PLUGINDEX_INVALID, true },
+		{ 0x120CED89, PLUGINDEX_INVALID, false },
+		{ 0x87FC0268, PLUGINDEX_INVALID, false },
+	};
+	for(PLUGINDEX plug = 0; plug < CountOf(setup); plug++)
+	{
+		SNDMIXPLUGIN &plugin = sndFile.m_MixPlugins[plug];
+		plugin.Info.dwPluginId1 = kDmoMagic;
+		plugin.Info.dwPluginId2 = setup[plug].id;
+		plugin.SetOutputPlugin(setup[plug].output);
+		plugin.SetMasterEffect(setup[plug].master);
+		VERIFY_EQUAL_NONCONT(CreateMixPluginProc(plugin, sndFile), true);
+		if(plugin.pMixPlugin == nullptr)
+			return {};
+	}
+	sndFile.ChnSettings[0].nMixPlugin = 1;
+	sndFile.ChnSettings[1].nMixPlugin = 2;
+	sndFile.ChnSettings[2].nMixPlugin = 4;
+
+	PluginGraph graph;
+	graph.Update(sndFile.m_MixPlugins);
+	chains.clear();
+	for(const auto &chain : graph.GetChains())
+		chains.push_back(chain.plugins);
+
+	Dither dither(mpt::global_prng());
+	std::vector<float> output(44100 * 4 * 2);
+	AudioReadTargetBuffer<audio_buffer_interleaved<float>> target(audio_buffer_interleaved<float>(output.data(), 2, output.size() / 2), dither);
+	std::size_t rendered = 0;
+	while(rendered < output.size() / 2)
+	{
+		if(rendered == output.size() / 4)
+			sndFile.m_MixPlugins[1].SetOutputPlugin(2);
+		sndFile.ResetMixStat();
+		const std::size_t count = sndFile.Read(static_cast<CSoundFile::samplecount_t>(std::min(std::size_t(1000), output.size() / 2 - rendered)), target);
+		rendered += count;
+		if(count == 0)
+			break;
+	}
+	output.resize(rendered * 2);
+	return output;
+}
+#endif // NO_PLUGINS
+
+
+static MPT_NOINLINE void TestPluginGraph()
+{
+#ifndef NO_PLUGINS
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	std::vector<std::vector<PLUGINDEX>> chains;
+	const std::vector<float> reference = RenderThroughPluginChains(mod, 0, chains);
+	VERIFY_EQUAL_NONCONT(reference.size(), 44100u * 4u * 2u);
+	// Chains are ordered by their last plugin. The master effect is not part of any chain.
+	VERIFY_EQUAL_NONCONT(chains.size(), 4u);
+	if(chains.size() == 4)
+	{
+		VERIFY_EQUAL_NONCONT(chains[0] == std::vector<PLUGINDEX>({ 1 }), true);
+		VERIFY_EQUAL_NONCONT(chains[1] == std::vector<PLUGINDEX>({ 0, 2 }), true);
+		VERIFY_EQUAL_NONCONT(chains[2] == std::vector<PLUGINDEX>({ 3, 5 }), true);
+		VERIFY_EQUAL_NONCONT(chains[3] == std::vector<PLUGINDEX>({ 6 }), true);
+	}
+
+	float peak = 0.0f;
+	for(float s : reference)
+		peak = std::max(peak, std::abs(s));
+	VERIFY_EQUAL_NONCONT(peak > 0.1f, true);
+
+	// The output must not depend on the number of threads or on the timing of the worker threads
+	for(uint32 numThreads : { 1u, 3u })
+	{
+		for(int run = 0; run < 3; run++)
+		{
+			const std::vector<float> output = RenderThroughPluginChains(mod, numThreads, chains);
+			VERIFY_EQUAL_NONCONT(output == reference, true);
+		}
+	}
+#endif // NO_PLUGINS
+}
+
+#ifndef NO_PLUGINS
+// Render deterministic noise through a plugin at 22050 Hz, long enough for all delay lines to wrap around,
+// and return the output at a few positions.
+static std::vector<float> RenderPluginProbes(int32 pluginId1, int32 pluginId2, const std::vector<std::pair<PlugParamIndex, PlugParamValue>> &parameters)
+{
+	constexpr uint32 numFrames = 90000, numProbes = 8;
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(FileReader(mpt::as_span(mod)), CSoundFile::loadCompleteModule), true);
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 22050;
+	mixerSettings.gnChannels = 2;
+	sndFile.SetMixerSettings(mixerSettings);
+
+	SNDMIXPLUGIN &plugin = sndFile.m_MixPlugins[0];
+	plugin.Info.dwPluginId1 = pluginId1;
+	plugin.Info.dwPluginId2 = pluginId2;
+	VERIFY_EQUAL_NONCONT(CreateMixPluginProc(plugin, sndFile), true);
+	IMixPlugin *mixPlug = plugin.pMixPlugin;
+	if(mixPlug == nullptr)
+		return {};
+	for(const auto &param : parameters)
+		mixPlug->SetParameter(param.first, param.second);
+	mixPlug->Resume();
+
+	std::vector<float> probes;
+	float outL[MIXBUFFERSIZE], outR[MIXBUFFERSIZE];
+	uint32 rng = 1;
+	for(uint32 pos = 0; pos < numFrames; pos += MIXBUFFERSIZE)
+	{
+		const uint32 count = std::min(numFrames - pos, uint32(MIXBUFFERSIZE));
+		float *inL = mixPlug->m_mixBuffer.GetInputBuffer(0), *inR = mixPlug->m_mixBuffer.GetInputBuffer(1);
+		for(uint32 i = 0; i < count; i++)
+		{
+			rng = rng * 1103515245u + 12345u;
+			inL[i] = static_cast<int16>(rng >> 16) / 65536.0f;
+			rng = rng * 1103515245u + 12345u;
+			inR[i] = static_cast<int16>(rng >> 16) / 65536.0f;
+		}
+		std::fill(outL, outL + count, 0.0f);
+		std::fill(outR, outR + count, 0.0f);
+		mixPlug->Process(outL, outR, count);
+		for(uint32 i = 0; i < count; i++)
+		{
+			if((pos + i) % (numFrames / numProbes) == numFrames / numProbes - 1)
+			{
+				probes.push_back(outL[i]);
+				probes.push_back(outR[i]);
+			}
+		}
+	}
+	return probes;
+}
+#endif // NO_PLUGINS
+
+
+static MPT_NOINLINE void TestPluginDelayLines()
+{
+#ifndef NO_PLUGINS
+	// Output of the plugins before their delay lines were changed to power-of-two sizes.
+	// The parameters include delays of zero and of the full delay line length, where the read position wraps around.
+	const struct
+	{
+		int32 pluginId1, pluginId2;
+		std::vector<std::pair<PlugParamIndex, PlugParamValue>> parameters;
+		std::vector<float> expected;
+	} tests[] =
+	{
+		// Echo
+		{ kDmoMagic, int32(0xEF3E932C), { { 1, 0.5f }, { 2, 0.0f }, { 3, 0.3f }, { 4, 0.0f } }, { 0.0237503f, -0.147324f, -0.107635f, -0.120241f, -0.149345f, 0.137555f, -0.000317294f, 0.247285f, -0.126473f, -0.224772f, -0.261203f, -0.06047f, -0.0543982f, 0.0857594f, 0.110396f, -0.0737817f } },
+		{ kDmoMagic, int32(0xEF3E932C), { { 1, 0.7f }, { 2, 0.4f }, { 3, 1.0f }, { 4, 1.0f } }, { 0.0237503f, -0.147324f, -0.107635f, -0.237301f, -0.149345f, 0.148097f, 0.0283328f, 0.0712236f, -0.291771f, 0.0170029f, -0.144759f, -0.283958f, 0.177296f, 0.0968993f, -0.111239f, -0.120728f } },
+		// DigiBooster Pro Echo
+		{ int32(0x304D4244), int32(0x6F686345), { { 0, 0.0f }, { 1, 0.5f }, { 2, 0.5f }, { 3, 0.5f } }, { 0.0237503f, -0.147324f, -0.199181f, -0.319801f, -0.127056f, 0.176815f, -0.0166473f, 0.0398865f, -0.143066f, -0.0803299f, -0.207302f, -0.216572f, -0.0199661f, 0.177094f, 0.12229f, -0.000642776f } },
+		{ int32(0x304D4244), int32(0x6F686345), { { 0, 0.6f }, { 1, 0.8f }, { 2, 0.7f }, { 3, 0.2f } }, { 0.0344731f, -0.0499169f, -0.0610377f, -0.137251f, -0.108129f, 0.0886622f, -0.040956f, 0.0676267f, -0.153983f, -0.0659848f, -0.184874f, -0.0203229f, -0.0336218f, 0.164018f, -0.00243754f, -0.0100697f } },
+		// Chorus
+		{ kDmoMagic, int32(0xEFE6629C), { }, { 0.0875157f, -0.120841f, -0.189463f, -0.303578f, -0.0555287f, 0.12143f, 0.00583599f, 0.233576f, -0.239897f, -0.139784f, -0.209468f, -0.107824f, 0.107292f, 0.126325f, 0.00314873f, 0.00714011f } },
+		{ kDmoMagic, int32(0xEFE6629C), { { 1, 1.0f }, { 3, 0.0f }, { 5, 0.95f }, { 6, 1.0f } }, { 0.267319f, -0.236195f, 0.179641f, -0.267357f, -0.0644951f, -0.0464959f, -0.152176f, 0.386731f, -0.43988f, -0.516067f, -0.20907f, -0.186566f, -0.0859087f, 0.342154f, 0.0282232f, -0.359613f } },
+		// Flanger
+		{ kDmoMagic, int32(0xEFCA3D92), { }, { 0.122512f, -0.0485622f, -0.056784f, -0.177405f, -0.256995f, 0.0468765f, 0.0352998f, 0.0918336f, -0.232633f, -0.169897f, -0.0822421f, -0.0915118f, 0.086891f, 0.283951f, 0.0923807f, -0.0305517f } },
+		// I3DL2Reverb
+		{ kDmoMagic, int32(0xEF985E71), { }, { -0.212102f, 0.19139f, -0.171765f, 0.0142881f, -0.0174383f, 0.0855633f, 0.0660093f, -0.0278678f, 0.115027f, -0.0283163f, 0.161115f, -0.0658646f, -0.206799f, 0.0292219f, 0.0340379f, -0.250417f } },
+		{ kDmoMagic, int32(0xEF985E71), { { 6, 0.0f }, { 8, 0.0f }, { 12, 1.0f } }, { 0.0028414f, 0.00945507f, -0.031345f, -0.0988279f, -0.125221f, -0.164319f, -0.0825832f, 0.0496504f, -0.061662f, 0.0618831f, -0.0359274f, 0.101202f, 0.177939f, -0.0777797f, 0.115827f, -0.156433f } },
+	};
+
+	for(const auto &test : tests)
+	{
+		const std::vector<float> output = RenderPluginProbes(test.pluginId1, test.pluginId2, test.parameters);
+		VERIFY_EQUAL_NONCONT(output.size(), test.expected.size());
+		if(output.size() != test.expected.size())
+			continue;
+		float maxDifference = 0.0f;
+		for(std::size_t i = 0; i < output.size(); i++)
+			maxDifference = std::max(maxDifference, std::abs(output[i] - test.expected[i]));
+		VERIFY_EQUAL_NONCONT(maxDifference < 1e-4f, true);
+	}
+#endif // NO_PLUGINS
+}
+
+
+#ifndef NO_EQ
+
+// The equalizer filter as it was before all bands were run in a single pass
+static void ReferenceEQFilter(EQBANDSTRUCT &band, float *buffer, uint32 count)
+{
+	if(!band.bEnable || band.Gain == 1.0f)
+		return;
+	for(uint32 i = 0; i < count; i++)
+	{
+		float32 x = buffer[i];
+		float32 y = band.a1 * band.x1 + band.a2 * band.x2 + band.a0 * x + band.b1 * band.y1 + band.b2 * band.y2;
+		band.x2 = band.x1;
+		band.y2 = band.y1;
+		band.x1 = x;
+		buffer[i] = y;
+		band.y1 = y;
+	}
+}
+
+#endif // NO_EQ
+
+
+static MPT_NOINLINE void TestEQCascade()
+{
+#ifndef NO_EQ
+	// Gains below, at and above unity (which skips a band), and a band that is disabled by its frequency
+	const UINT gains[MAX_EQ_BANDS] = { 4, 16, 28, 10, 32, 20 };
+	const UINT freqs[MAX_EQ_BANDS] = { 120, 600, 1200, 3000, 10, 10000 };
+	// Odd chunk sizes, so that the filter state has to be carried from one chunk to the next
+	const uint32 chunks[] = { 37, 1, MIXBUFFERSIZE, 200 };
+
+	uint32 seed = 1;
+	for(uint32 channels : { 1u, 2u, 4u })
+	{
+		CQuadEQ eq;
+		eq.SetEQGains(gains, MAX_EQ_BANDS, freqs, true, 44100);
+		EQBANDSTRUCT reference[2][MAX_EQ_BANDS * 2];
+		for(UINT b = 0; b < MAX_EQ_BANDS * 2; b++)
+		{
+			reference[0][b] = eq.GetFront().GetBand(b);
+			reference[1][b] = eq.GetRear().GetBand(b);
+		}
+
+		for(uint32 count : chunks)
+		{
+			const uint32 frontChannels = std::min(channels, 2u);
+			std::vector<int32> front(MIXBUFFERSIZE * 2), rear(MIXBUFFERSIZE * 2);
+			for(uint32 i = 0; i < count * frontChannels; i++)
+			{
+				seed = seed * 1103515245u + 12345u;
+				front[i] = static_cast<int32>(seed >> 7) - (1 << 24);
+				seed = seed * 1103515245u + 12345u;
+				rear[i] = static_cast<int32>(seed >> 7) - (1 << 24);
+			}
+			std::vector<int32> expectedFront = front, expectedRear = rear;
+			std::vector<float> left(MIXBUFFERSIZE), right(MIXBUFFERSIZE);
+			if(channels == 1)
+			{
+				MonoMixToFloat(expectedFront.data(), left.data(), count, 1.0f / MIXING_SCALEF);
+				for(UINT b = 0; b < MAX_EQ_BANDS; b++)
+					ReferenceEQFilter(reference[0][b], left.data(), count);
+				FloatToMonoMix(left.data(), expectedFront.data(), count, MIXING_SCALEF);
+			} else
+			{
+				for(uint32 pair = 0; pair < channels / 2; pair++)
+				{
+					int32 *buffer = pair ? expectedRear.data() : expectedFront.data();
+					StereoMixToFloat(buffer, left.data(), right.data(), count, 1.0f / MIXING_SCALEF);
+					for(UINT b = 0; b < MAX_EQ_BANDS; b++)
+						ReferenceEQFilter(reference[pair][b], left.data(), count);
+					for(UINT b = MAX_EQ_BANDS; b < MAX_EQ_BANDS * 2; b++)
+						ReferenceEQFilter(reference[pair][b], right.data(), count);
+					FloatToStereoMix(left.data(), right.data(), buffer, count, MIXING_SCALEF);
+				}
+			}
+
+			eq.Process(front.data(), rear.data(), count, channels);
+			// Both filters do the same operations, but with -ffast-math or /fp:fast the compiler may reorder them differently,
+			// and the low-frequency bands amplify the rounding differences.
+			for(uint32 i = 0; i < MIXBUFFERSIZE * 2; i++)
+			{
+				VERIFY_EQUAL_NONCONT(std::abs(front[i] - expectedFront[i]) <= (1 << 12), true);
+				VERIFY_EQUAL_NONCONT(std::abs(rear[i] - expectedRear[i]) <= (1 << 12), true);
+			}
+		}
+	}
+#endif // NO_EQ
+}
+
+
+#if defined(LIBOPENMPT_BUILD)
+
+// Output buffers of both layouts, with room for a few extra frames to detect writes past the end
+template<typename Tsample>
+struct OutputGainBuffers
+{
+	static constexpr std::size_t maxChannels = 4;
+	std::vector<Tsample> interleaved;
+	std::vector<Tsample> planar[maxChannels];
+	Tsample *planarPointers[maxChannels];
+
+	OutputGainBuffers(std::size_t channels, std::size_t frames)
+		: interleaved((frames + 4) * channels)
+	{
+		for(std::size_t c = 0; c < maxChannels; c++)
+		{
+			planar[c].resize(frames + 4);
+			planarPointers[c] = planar[c].data();
+		}
+	}
+	audio_buffer_interleaved<Tsample> Interleaved(std::size_t channels, std::size_t frames) { return audio_buffer_interleaved<Tsample>(interleaved.data(), channels, frames); }
+	audio_buffer_planar<Tsample> Planar(std::size_t channels, std::size_t frames) { return audio_buffer_planar<Tsample>(planarPointers, channels, frames); }
+	bool operator==(const OutputGainBuffers &other) const
+	{
+		if(std::memcmp(interleaved.data(), other.interleaved.data(), interleaved.size() * sizeof(Tsample)))
+			return false;
+		for(std::size_t c = 0; c < maxChannels; c++)
+		{
+			if(std::memcmp(planar[c].data(), other.planar[c].data(), planar[c].size() * sizeof(Tsample)))
+				return false;
+		}
+		return true;
+	}
+};
+
+
+// Render two chunks with AudioReadTargetGainBuffer, and the same chunks by applying the gain in a separate pass
+// like before the gain was applied during the output conversion.
+template<typename Tsample, typename TMixSample, typename Tbuffer>
+static void TestOutputGainChunks(Tbuffer actualBuffer, Tbuffer expectedBuffer, const std::vector<TMixSample> &mix, std::size_t channels, std::size_t frames, DitherMode ditherMode, float gain)
+{
+	Dither dither(mpt::global_prng());
+	dither.SetMode(ditherMode);
+	Dither expectedDither = static_cast<const Dither &>(dither);  // Same dither noise
+
+	AudioReadTargetGainBuffer<Tbuffer> target(actualBuffer, dither, gain);
+	std::vector<TMixSample> mixCopy;
+	for(std::size_t offset : { std::size_t(0), frames / 3 })
+	{
+		const std::size_t count = offset ? (frames - offset) : (frames / 3);
+		mixCopy.assign(mix.begin() + offset * channels, mix.begin() + (offset + count) * channels);
+		target.DataCallback(mixCopy.data(), channels, count);
+
+		mixCopy.assign(mix.begin() + offset * channels, mix.begin() + (offset + count) * channels);
+		Tbuffer outBuf = advance_audio_buffer(expectedBuffer, offset);
+		expectedDither.WithDither(
+			[&](auto &ditherInstance)
+			{
+				MPT_CONSTANT_IF(std::is_floating_point<TMixSample>::value)
+				{
+					for(auto &s : mixCopy)
+						s = static_cast<TMixSample>(s * gain);
+					ConvertBufferMixFloatToBuffer<false>(outBuf, audio_buffer_interleaved<TMixSample>(mixCopy.data(), channels, count), ditherInstance, channels, count);
+				} else
+				{
+					MPT_CONSTANT_IF(!std::is_floating_point<Tsample>::value)
+					{
+						const int32 gain16_16 = mpt::saturate_round<int32>(gain * (1 << 16));
+						for(auto &s : mixCopy)
+							s = static_cast<TMixSample>(Util::muldiv(static_cast<int32>(s), gain16_16, 1 << 16));
+					}
+					ConvertBufferMixFixedToBuffer<MixSampleIntTraits::mix_fractional_bits(), false>(outBuf, audio_buffer_interleaved<TMixSample>(mixCopy.data(), channels, count), ditherInstance, channels, count);
+					MPT_CONSTANT_IF(std::is_floating_point<Tsample>::value)
+					{
+						for(std::size_t i = 0; i < count; i++)
+							for(std::size_t c = 0; c < channels; c++)
+								outBuf(c, i) = static_cast<Tsample>(outBuf(c, i) * gain);
+					}
+				}
+			}
+		);
+	}
+}
+
+
+template<typename Tsample>
+static void TestOutputGainFormat()
+{
+	const std::size_t frames = 61;
+	for(std::size_t channels : { 1, 2, 4 })
+	{
+		// Float mix buffer with values on the rounding boundaries of 16-bit output and values that get clipped
+		std::vector<MixSampleFloat> mixFloat(frames * channels);
+		std::vector<MixSampleInt> mixInt(frames * channels);
+		for(std::size_t i = 0; i < mixFloat.size(); i++)
+		{
+			mixFloat[i] = static_cast<MixSampleFloat>((static_cast<int>(i * 2971u % 4099u) - 2049) / 65536.0);
+			if(i % 7 == 3)
+				mixFloat[i] *= 40.0f;
+			mixInt[i] = static_cast<MixSampleInt>(mixFloat[i] * MIXING_SCALEF * 0.5f);
+		}
+
+		for(DitherMode ditherMode : { DitherNone, DitherModPlug, DitherSimple })
+		{
+			for(float gain : { 1.0f, 0.5f, 1.37f })
+			{
+				OutputGainBuffers<Tsample> actual(channels, frames), expected(channels, frames);
+				TestOutputGainChunks<Tsample>(actual.Interleaved(channels, frames), expected.Interleaved(channels, frames), mixFloat, channels, frames, ditherMode, gain);
+				TestOutputGainChunks<Tsample>(actual.Planar(channels, frames), expected.Planar(channels, frames), mixFloat, channels, frames, ditherMode, gain);
+				VERIFY_EQUAL_NONCONT(actual == expected, true);
+
+				OutputGainBuffers<Tsample> actualInt(channels, frames), expectedInt(channels, frames);
+				TestOutputGainChunks<Tsample>(actualInt.Interleaved(channels, frames), expectedInt.Interleaved(channels, frames), mixInt, channels, frames, ditherMode, gain);
+				TestOutputGainChunks<Tsample>(actualInt.Planar(channels, frames), expectedInt.Planar(channels, frames), mixInt, channels, frames, ditherMode, gain);
+				VERIFY_EQUAL_NONCONT(actualInt == expectedInt, true);
+			}
+		}
+	}
+}
+
+#endif // LIBOPENMPT_BUILD
+
+
+static MPT_NOINLINE void TestOutputGain()
+{
+#if defined(LIBOPENMPT_BUILD)
+	TestOutputGainFormat<int16>();
+	TestOutputGainFormat<int24>();
+	TestOutputGainFormat<int32>();
+	TestOutputGainFormat<float>();
+#endif // LIBOPENMPT_BUILD
+}
+
+
+// Render the generated test MOD while changing the global volume every few hundred frames, so that some volume ramps end in the middle of a chunk
+static std::vector<float> RenderMasterBus(const std::vector<mpt::byte> &mod, uint32 channels, int32 separation, bool fused)
+{
+	CSoundFile sndFile;
+	VERIFY_EQUAL_NONCONT(sndFile.Create(FileReader(mpt::as_span(mod)), CSoundFile::loadCompleteModule), true);
+	VERIFY_EQUAL_NONCONT(sndFile.GetPlayConfig().getGlobalVolumeAppliesToMaster(), true);
+	MixerSettings mixerSettings = sndFile.m_MixerSettings;
+	mixerSettings.gdwMixingFreq = 44100;
+	mixerSettings.gnChannels = channels;
+	mixerSettings.m_nStereoSeparation = separation;
+	mixerSettings.DSPMask = 0;
+	sndFile.SetMixerSettings(mixerSettings);
+	sndFile.m_MixerPaths.fusedMasterBus = fused;
+
+	const int32 globalVolumes[] = { 64, 256, 255, 0, 200, 256 };
+	constexpr std::size_t numFrames = 20000, blockSize = 700;
+	Dither dither(mpt::global_prng());
+	std::vector<float> output(numFrames * channels);
+	AudioReadTargetBuffer<audio_buffer_interleaved<float>> target(audio_buffer_interleaved<float>(output.data(), channels, numFrames), dither);
+	for(std::size_t block = 0; block * blockSize < numFrames; block++)
+	{
+		const std::size_t count = std::min(blockSize, numFrames - block * blockSize);
+		VERIFY_EQUAL_NONCONT(sndFile.Read(static_cast<CSoundFile::samplecount_t>(count), target), count);
+		sndFile.m_PlayState.m_nGlobalVolume = globalVolumes[block % CountOf(globalVolumes)];
+	}
+	return output;
+}
+
+
+static MPT_NOINLINE void TestMasterBus()
+{
+	// The single pass master bus processing must give exactly the same output as applying each step separately
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	for(uint32 channels : { 1u, 2u, 4u })
+	{
+		for(int32 separation : { int32(MixerSettings::StereoSeparationScale), int32(70), int32(200) })
+		{
+			const std::vector<float> fused = RenderMasterBus(mod, channels, separation, true);
+			const std::vector<float> unfused = RenderMasterBus(mod, channels, separation, false);
+			VERIFY_EQUAL_NONCONT(fused == unfused, true);
+			// Nothing is mixed into the rear channels of quad output
+			VERIFY_EQUAL_NONCONT(std::count(fused.begin(), fused.end(), 0.0f) < static_cast<std::ptrdiff_t>(fused.size() * 3 / 4), true);
+		}
+	}
+}
+
+#ifdef LIBOPENMPT_BUILD
+static uint64 GetMixerStatistic(const TestModuleImpl &module, const std::string &name)
+{
+	return ConvertStrTo<uint64>(module.ctl_get("render.statistics." + name));
+}
+#endif // LIBOPENMPT_BUILD
+
+
+static MPT_NOINLINE void TestMixerStatistics()
+{
+#ifdef LIBOPENMPT_BUILD
+	const std::vector<mpt::byte> mod = CreateProgressiveTestMOD();
+	const std::vector<char> data(mpt::byte_cast<const char *>(mod.data()), mpt::byte_cast<const char *>(mod.data() + mod.size()));
+	std::ostringstream log;
+	constexpr std::size_t numFrames = 20000, blockSize = 700;
+	const uint8 channelVolumes[] = { 64, 20, 48, 1, 64, 33 };
+
+	// Deferring the rest of the chunk after a volume ramp to the multi-voice mix functions must not change the output.
+	// Changing the channel volumes every few hundred frames causes volume ramps that end in the middle of a chunk.
+	std::vector<float> output[2];
+	uint64 multiVoiceFrames[2] = { 0, 0 };
+	for(int defer = 0; defer < 2; defer++)
+	{
+		TestModuleImpl module(data, log);
+		module.GetSoundFile().m_MixerPaths.deferPostRampTails = (defer != 0);
+		output[defer].resize(numFrames * 2);
+		for(std::size_t block = 0; block * blockSize < numFrames; block++)
+		{
+			const std::size_t count = std::min(blockSize, numFrames - block * blockSize);
+			VERIFY_EQUAL_NONCONT(module.read_interleaved_stereo(44100, count, output[defer].data() + block * blockSize * 2), count);
+			for(CHANNELINDEX chn = 0; chn < 4; chn++)
+			{
+				module.GetSoundFile().m_PlayState.Chn[chn].nGlobalVol = channelVolumes[(block + chn) % CountOf(channelVolumes)];
+			}
+		}
+
+		// All four samples play during the whole time, so every frame of every voice is rendered by exactly one of the code paths
+		const uint64 rampFrames = GetMixerStatistic(module, "ramp_frames");
+		const uint64 noRampFrames = GetMixerStatistic(module, "noramp_frames");
+		multiVoiceFrames[defer] = GetMixerStatistic(module, "multivoice_frames");
+		VERIFY_EQUAL_NONCONT(rampFrames + noRampFrames + multiVoiceFrames[defer], uint64(4 * numFrames));
+		VERIFY_EQUAL_NONCONT(rampFrames > 0, true);
+
+		// The counters can only be reset
+		for(const char *name : { "ramp_frames", "noramp_frames", "multivoice_frames" })
+		{
+			for(const char *value : { "1", "-1", "x" })
+			{
+				bool rejected = false;
+				try
+				{
+					module.ctl_set(std::string("render.statistics.") + name, value);
+				} catch(const openmpt::exception &)
+				{
+					rejected = true;
+				}
+				VERIFY_EQUAL_NONCONT(rejected, true);
+			}
+			module.ctl_set(std::string("render.statistics.") + name, "0");
+			VERIFY_EQUAL_NONCONT(GetMixerStatistic(module, name), 0u);
+		}
+	}
+	VERIFY_EQUAL_NONCONT(output[0] == output[1], true);
+	VERIFY_EQUAL_NONCONT(std::count(output[0].begin(), output[0].end(), 0.0f) < static_cast<std::ptrdiff_t>(numFrames), true);
+#ifdef MPT_INTMIXER
+	VERIFY_EQUAL_NONCONT(multiVoiceFrames[1] > multiVoiceFrames[0], true);
+#endif // MPT_INTMIXER
+#endif // LIBOPENMPT_BUILD
+}
+
 } // namespace Test
 
 OPENMPT_NAMESPACE_END
@@ -4918,6 +6977,11 @@ void DoTests()
 	return;
 }
 
+bool GenerateResamplerTables(std::ostream &)
+{
+	return false;
+}
+
 } // namespace Test
 
 OPENMPT_NAMESPACE_END
@@ -13,12 +13,23 @@
 
 #include "BuildSettings.h"
 
+#include "../common/mptPathString.h"
+
+#include <iosfwd>
+#include <vector>
+
 OPENMPT_NAMESPACE_BEGIN
 
 namespace Test {
 
 void DoTests();
 
+// Prints timings of performance-sensitive code paths (see benchmark.cpp), including the load time of the given module files
+void DoBenchmarks(const std::vector<mpt::PathString> &files);
+
+// Writes the contents of soundlib/ResamplerTables.h. Returns false if the build does not use pre-computed tables.
+bool GenerateResamplerTables(std::ostream &output);
+
 } // namespace Test
 
 OPENMPT_NAMESPACE_END